@@ -12,6 +12,7 @@
 #define XCB_VERSION_STRING "${XCB_VERSION}"
 #define COMO_KILLER_BIN "${CMAKE_INSTALL_FULL_LIBEXECDIR}/como_killer_helper"
 #cmakedefine01 HAVE_PERF
+#cmakedefine01 HAVE_SCRIPT_HEAP_SIZE
 #cmakedefine01 HAVE_BREEZE_DECO
 #cmakedefine01 HAVE_SCHED_RESET_ON_FORK
 #cmakedefine01 HAVE_ACCESSIBILITY
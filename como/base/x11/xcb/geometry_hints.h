@@ -81,6 +81,20 @@ public:
         m_window = window;
         fetch();
     }
+    /**
+     * Initializes from @p hints already requested for @p window instead of fetching them.
+     */
+    void init(xcb_window_t window, normal_hints const& hints)
+    {
+        Q_ASSERT(window);
+        if (m_window) {
+            // already initialized
+            return;
+        }
+        m_window = window;
+        m_sizeHints = nullptr;
+        m_hints = hints;
+    }
     void fetch()
     {
         if (!m_window) {
@@ -30,6 +30,20 @@ public:
         m_window = window;
         fetch();
     }
+    /**
+     * Initializes from the @p prop already requested for @p window instead of fetching it.
+     */
+    void init(xcb_window_t window, property const& prop)
+    {
+        Q_ASSERT(window);
+        if (m_window) {
+            // already initialized
+            return;
+        }
+        m_window = window;
+        m_hints = nullptr;
+        m_prop = prop;
+    }
     void fetch()
     {
         if (!m_window) {
@@ -11,6 +11,12 @@
 namespace como::base::x11::xcb
 {
 
+/**
+ * Called with the sequence number of every reply a wrapper waits for. Tests set it to count the
+ * round trips of an operation.
+ */
+inline void (*reply_wait_hook)(xcb_connection_t* con, unsigned int sequence){nullptr};
+
 /**
  * @brief Variadic template to wrap an xcb request.
  *
@@ -307,6 +313,9 @@ protected:
         if (m_retrieved || !m_cookie.sequence) {
             return;
         }
+        if (reply_wait_hook) {
+            reply_wait_hook(con, m_cookie.sequence);
+        }
         m_reply = Data::replyFunc(con, m_cookie, nullptr);
         m_retrieved = true;
     }
@@ -12,8 +12,10 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <como/render/gl/interface/platform.h>
 #include <como/render/gl/interface/utils.h>
+#include <como/render/gl/shadow_texture_cache.h>
 
 #include <QAbstractItemModel>
+#include <QLocale>
 #include <QStyledItemDelegate>
 #include <QWindow>
 #include <memory>
@@ -156,6 +158,15 @@ protected:
         m_ui->platformExtensionsLabel->setText(
             extensionsString(scene.openGLPlatformInterfaceExtensions()));
         m_ui->openGLExtensionsLabel->setText(extensionsString(openGLExtensions()));
+
+        auto const shadows = render::gl::shadow_texture_cache::instance().get_report();
+        QLocale const locale;
+        m_ui->shadowTexturesCountLabel->setText(QString::number(shadows.textures));
+        m_ui->shadowTexturesUsersLabel->setText(QString::number(shadows.users));
+        m_ui->shadowTexturesMemoryLabel->setText(
+            locale.formattedDataSize(static_cast<qint64>(shadows.bytes)));
+        m_ui->shadowTexturesSavedLabel->setText(
+            locale.formattedDataSize(static_cast<qint64>(shadows.saved_bytes)));
     }
 
     QScopedPointer<Ui::debug_console> m_ui;
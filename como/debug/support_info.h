@@ -76,6 +76,8 @@ QString get_support_info(Space const& space)
     support.append(COMO_BUILD_TABBOX ? yes : no);
     support.append(QStringLiteral("HAVE_PERF: "));
     support.append(HAVE_PERF ? yes : no);
+    support.append(QStringLiteral("HAVE_SCRIPT_HEAP_SIZE: "));
+    support.append(HAVE_SCRIPT_HEAP_SIZE ? yes : no);
     support.append(QStringLiteral("HAVE_EPOXY_GLX: "));
     support.append(HAVE_EPOXY_GLX ? yes : no);
     support.append(QStringLiteral("\n"));
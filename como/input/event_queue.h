@@ -0,0 +1,76 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace como::input
+{
+
+/**
+ * Bounded single-producer single-consumer queue for input events. Pushing and popping is
+ * wait-free, so events can be produced on a different thread than the one consuming them.
+ */
+template<typename Event, size_t Capacity>
+class event_queue
+{
+public:
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+    /// Returns false when the queue is full. The event is not added in this case.
+    bool push(Event const& event)
+    {
+        auto const tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        events[tail & (Capacity - 1)] = event;
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<Event> pop()
+    {
+        auto const head = this->head.load(std::memory_order_relaxed);
+        if (head == tail.load(std::memory_order_acquire)) {
+            return {};
+        }
+
+        auto event = events[head & (Capacity - 1)];
+        this->head.store(head + 1, std::memory_order_release);
+        return event;
+    }
+
+    /// The next event to pop or null when the queue is empty. Must be called by the consumer.
+    Event const* front() const
+    {
+        auto const head = this->head.load(std::memory_order_relaxed);
+        if (head == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        return &events[head & (Capacity - 1)];
+    }
+
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<Event, Capacity> events;
+
+    // Producer and consumer indices on separate cache lines to not contend with each other.
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
+
+}
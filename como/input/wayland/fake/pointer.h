@@ -25,6 +25,9 @@ public:
             &Wrapland::Server::FakeInputDevice::pointerMotionRequested,
             this,
             [this](auto const& delta) {
+                // The relative motion is based on the position after all queued motions.
+                this->redirect.pointer->flush_motions();
+
                 // TODO: Fix time
                 this->redirect.pointer->process_motion_absolute(
                     {this->redirect.globalPointer() + QPointF(delta.width(), delta.height()),
@@ -34,6 +37,8 @@ public:
                          &Wrapland::Server::FakeInputDevice::pointerMotionAbsoluteRequested,
                          this,
                          [this](auto const& pos) {
+                             this->redirect.pointer->flush_motions();
+
                              // TODO: Fix time
                              this->redirect.pointer->process_motion_absolute({pos, {this, 0}});
                          });
@@ -0,0 +1,185 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/input/event.h>
+#include <como/input/event_queue.h>
+
+#include <QPointF>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace como::input::wayland
+{
+
+/**
+ * Collects pointer motion events from the devices until they are processed in a batch.
+ * Consecutive motions of the same device are coalesced into a single one. Relative deltas are
+ * summed up, of absolute motions only the last position is kept.
+ *
+ * Every device has its own single-producer single-consumer queue, so the motions of a device can
+ * be pushed from another thread than the one flushing them. Devices must be added and removed on
+ * the flushing thread while no motions are pushed for them. Motions are processed in the order
+ * they were pushed, also across devices.
+ */
+template<typename Device>
+class motion_queue
+{
+public:
+    motion_queue(Device& device)
+        : device{device}
+    {
+    }
+
+    void add_device(pointer* dev)
+    {
+        devices.push_back({dev, std::make_unique<event_queue<motion, 256>>()});
+    }
+
+    /// Pending motions of @p dev are dropped, the device may already be partially destroyed.
+    void remove_device(pointer* dev)
+    {
+        std::erase_if(devices, [dev](auto const& entry) { return entry.dev == dev; });
+    }
+
+    void push(motion_event const& event)
+    {
+        push({{},
+              event.delta,
+              event.unaccel_delta,
+              event.base.dev,
+              event.base.time_msec,
+              false,
+              next_sequence.fetch_add(1, std::memory_order_relaxed)});
+    }
+
+    void push(motion_absolute_event const& event)
+    {
+        push({event.pos,
+              {},
+              {},
+              event.base.dev,
+              event.base.time_msec,
+              true,
+              next_sequence.fetch_add(1, std::memory_order_relaxed)});
+    }
+
+    bool empty() const
+    {
+        return std::all_of(devices.cbegin(), devices.cend(), [](auto const& entry) {
+            return entry.queue->empty();
+        });
+    }
+
+    void flush()
+    {
+        if (flushing) {
+            // Motions processed now are queued after the ones being flushed. Keep the order.
+            return;
+        }
+
+        flushing = true;
+        std::optional<motion> pending;
+
+        while (auto next = pop_oldest()) {
+            if (pending && pending->dev == next->dev && pending->abs == next->abs) {
+                pending->pos = next->pos;
+                pending->delta += next->delta;
+                pending->unaccel_delta += next->unaccel_delta;
+                pending->time = next->time;
+                continue;
+            }
+            if (pending) {
+                process(*pending);
+            }
+            pending = next;
+        }
+
+        if (pending) {
+            process(*pending);
+        }
+
+        flushing = false;
+    }
+
+private:
+    struct motion {
+        QPointF pos;
+        QPointF delta;
+        QPointF unaccel_delta;
+        pointer* dev{nullptr};
+        uint32_t time{0};
+        bool abs{false};
+
+        // Orders the motions of different devices.
+        uint64_t sequence{0};
+    };
+
+    struct device_queue {
+        pointer* dev;
+        std::unique_ptr<event_queue<motion, 256>> queue;
+    };
+
+    void push(motion const& event)
+    {
+        auto it = std::find_if(devices.begin(), devices.end(), [&event](auto const& entry) {
+            return entry.dev == event.dev;
+        });
+
+        if (it == devices.end()) {
+            // Motions of unknown devices are not queued.
+            flush();
+            process(event);
+            return;
+        }
+
+        if (!it->queue->push(event)) {
+            // Motions are pushed on the flushing thread for now. So instead of dropping motion the
+            // queue can be drained right away.
+            flush();
+            it->queue->push(event);
+        }
+    }
+
+    std::optional<motion> pop_oldest()
+    {
+        event_queue<motion, 256>* oldest{nullptr};
+        uint64_t oldest_sequence{0};
+
+        for (auto const& entry : devices) {
+            if (auto front = entry.queue->front();
+                front && (!oldest || front->sequence < oldest_sequence)) {
+                oldest = entry.queue.get();
+                oldest_sequence = front->sequence;
+            }
+        }
+
+        if (!oldest) {
+            return {};
+        }
+        return oldest->pop();
+    }
+
+    void process(motion const& event)
+    {
+        if (event.abs) {
+            device.process_motion_absolute({event.pos, {event.dev, event.time}});
+        } else {
+            device.process_motion({event.delta, event.unaccel_delta, {event.dev, event.time}});
+        }
+    }
+
+    std::vector<device_queue> devices;
+    std::atomic<uint64_t> next_sequence{0};
+    bool flushing{false};
+    Device& device;
+};
+
+}
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "device_redirect.h"
+#include "motion_queue.h"
 #include "motion_scheduler.h"
 
 #include <como/base/platform_qobject.h>
@@ -63,6 +64,7 @@ public:
         : qobject{std::make_unique<QObject>()}
         , redirect{redirect}
         , motions{*this}
+        , queued_motions{*this}
     {
     }
 
@@ -375,6 +377,44 @@ public:
         return false;
     }
 
+    /// Motions of @p device are queued in their own queue from now on.
+    void add_motion_device(pointer* device)
+    {
+        queued_motions.add_device(device);
+    }
+
+    void remove_motion_device(pointer* device)
+    {
+        queued_motions.remove_device(device);
+    }
+
+    /**
+     * Queues a motion from a device. Motions arriving until control returns to the event loop are
+     * coalesced and processed together.
+     */
+    void queue_motion(motion_event const& event)
+    {
+        queued_motions.push(event);
+        schedule_motions_flush();
+    }
+
+    void queue_motion(motion_absolute_event const& event)
+    {
+        queued_motions.push(event);
+        schedule_motions_flush();
+    }
+
+    /// Processes queued motions. Must be called before other events to retain the event order.
+    void flush_motions()
+    {
+        queued_motions.flush();
+    }
+
+    bool has_queued_motions() const
+    {
+        return !queued_motions.empty();
+    }
+
     void process_motion(motion_event const& event)
     {
         if (motions.is_locked()) {
@@ -429,11 +469,14 @@ public:
         auto const rel_pos = QPointF(pos.x() / space_size.width(), pos.y() / space_size.height());
 
         auto event = motion_absolute_event{rel_pos, {device, time}};
+        flush_motions();
         process_motion_absolute(event);
     }
 
     void process_button(button_event const& event)
     {
+        flush_motions();
+
         if (event.state == button_state::pressed) {
             // Check focus before processing spies/filters.
             device_redirect_update(this);
@@ -454,6 +497,8 @@ public:
 
     void process_axis(axis_event const& event)
     {
+        flush_motions();
+
         device_redirect_update(this);
 
         process_spies(redirect->m_spies,
@@ -466,6 +511,8 @@ public:
 
     void process_swipe_begin(swipe_begin_event const& event)
     {
+        flush_motions();
+
         process_spies(redirect->m_spies,
                       std::bind(&event_spy<Redirect>::swipe_begin, std::placeholders::_1, event));
         process_filters(
@@ -475,6 +522,8 @@ public:
 
     void process_swipe_update(swipe_update_event const& event)
     {
+        flush_motions();
+
         device_redirect_update(this);
 
         process_spies(redirect->m_spies,
@@ -486,6 +535,8 @@ public:
 
     void process_swipe_end(swipe_end_event const& event)
     {
+        flush_motions();
+
         device_redirect_update(this);
 
         process_spies(redirect->m_spies,
@@ -497,6 +548,8 @@ public:
 
     void process_pinch_begin(pinch_begin_event const& event)
     {
+        flush_motions();
+
         device_redirect_update(this);
 
         process_spies(redirect->m_spies,
@@ -508,6 +561,8 @@ public:
 
     void process_pinch_update(pinch_update_event const& event)
     {
+        flush_motions();
+
         device_redirect_update(this);
 
         process_spies(redirect->m_spies,
@@ -519,6 +574,8 @@ public:
 
     void process_pinch_end(pinch_end_event const& event)
     {
+        flush_motions();
+
         device_redirect_update(this);
 
         process_spies(redirect->m_spies,
@@ -530,6 +587,8 @@ public:
 
     void process_hold_begin(hold_begin_event const& event)
     {
+        flush_motions();
+
         device_redirect_update(this);
 
         process_spies(redirect->m_spies,
@@ -541,6 +600,8 @@ public:
 
     void process_hold_end(hold_end_event const& event)
     {
+        flush_motions();
+
         device_redirect_update(this);
 
         process_spies(redirect->m_spies,
@@ -992,7 +1053,25 @@ private:
         bool enabled{true};
     } constraints;
 
+    void schedule_motions_flush()
+    {
+        if (motions_flush_scheduled) {
+            return;
+        }
+
+        motions_flush_scheduled = true;
+        QMetaObject::invokeMethod(
+            qobject.get(),
+            [this] {
+                motions_flush_scheduled = false;
+                flush_motions();
+            },
+            Qt::QueuedConnection);
+    }
+
     motion_scheduler<pointer_redirect> motions;
+    motion_queue<pointer_redirect> queued_motions;
+    bool motions_flush_scheduled{false};
 };
 
 }
@@ -36,6 +36,7 @@
 #include <como/input/redirect_qobject.h>
 #include <como/input/spies/activity.h>
 #include <como/input/spies/touch_hide_cursor.h>
+#include <como/input/window_index.h>
 
 #include <KConfigWatcher>
 #include <Wrapland/Server/display.h>
@@ -69,6 +70,7 @@ public:
         , input_method{std::make_unique<wayland::input_method<type>>(*this)}
         , tablet_mode_manager{std::make_unique<dbus::tablet_mode_manager<type>>(*this)}
     {
+        win_index = std::make_unique<input::window_index<Space>>(space);
         setup_workspace();
 
         using base_t = std::decay_t<decltype(platform.base)>;
@@ -235,6 +237,9 @@ public:
     platform_t& platform;
     Space& space;
 
+    /// For finding the window at a position.
+    std::unique_ptr<input::window_index<Space>> win_index;
+
 private:
     template<typename Dev>
     static void unset_focus(Dev&& dev)
@@ -296,14 +301,18 @@ private:
                          &platform_qobject::pointer_added,
                          qobject.get(),
                          [this](auto pointer) { handle_pointer_added(pointer); });
-        QObject::connect(
-            platform.qobject.get(), &platform_qobject::pointer_removed, qobject.get(), [this]() {
-                if (platform.pointers.empty()) {
-                    auto seat = platform.base.server->seat();
-                    unset_focus(pointer.get());
-                    seat->setHasPointer(false);
-                }
-            });
+        QObject::connect(platform.qobject.get(),
+                         &platform_qobject::pointer_removed,
+                         qobject.get(),
+                         [this](auto dev) {
+                             pointer->remove_motion_device(dev);
+
+                             if (platform.pointers.empty()) {
+                                 auto seat = platform.base.server->seat();
+                                 unset_focus(pointer.get());
+                                 seat->setHasPointer(false);
+                             }
+                         });
 
         for (auto keyboard : platform.keyboards) {
             handle_keyboard_added(keyboard);
@@ -406,6 +415,7 @@ private:
     void handle_pointer_added(input::pointer* pointer)
     {
         auto pointer_red = this->pointer.get();
+        pointer_red->add_motion_device(pointer);
 
         QObject::connect(pointer,
                          &pointer::button_changed,
@@ -415,12 +425,11 @@ private:
         QObject::connect(pointer,
                          &pointer::motion,
                          pointer_red->qobject.get(),
-                         [pointer_red](auto const& event) { pointer_red->process_motion(event); });
-        QObject::connect(
-            pointer,
-            &pointer::motion_absolute,
-            pointer_red->qobject.get(),
-            [pointer_red](auto const& event) { pointer_red->process_motion_absolute(event); });
+                         [pointer_red](auto const& event) { pointer_red->queue_motion(event); });
+        QObject::connect(pointer,
+                         &pointer::motion_absolute,
+                         pointer_red->qobject.get(),
+                         [pointer_red](auto const& event) { pointer_red->queue_motion(event); });
 
         QObject::connect(pointer,
                          &pointer::axis_changed,
@@ -471,6 +480,10 @@ private:
             [pointer_red](auto const& event) { pointer_red->process_hold_end(event); });
 
         QObject::connect(pointer, &pointer::frame, pointer_red->qobject.get(), [pointer_red] {
+            if (pointer_red->has_queued_motions()) {
+                // The frame is sent once the queued motions are processed.
+                return;
+            }
             pointer_red->process_frame();
         });
 
@@ -484,12 +497,16 @@ private:
     void handle_keyboard_added(input::keyboard* keyboard)
     {
         auto keyboard_red = this->keyboard.get();
+        auto pointer_red = this->pointer.get();
         auto seat = platform.base.server->seat();
 
         QObject::connect(keyboard,
                          &keyboard::key_changed,
                          keyboard_red->qobject.get(),
-                         [keyboard_red](auto const& event) { keyboard_red->process_key(event); });
+                         [keyboard_red, pointer_red](auto const& event) {
+                             pointer_red->flush_motions();
+                             keyboard_red->process_key(event);
+                         });
         QObject::connect(
             keyboard,
             &keyboard::modifiers_changed,
@@ -527,11 +544,15 @@ private:
     void handle_touch_added(input::touch* touch)
     {
         auto touch_red = this->touch.get();
+        auto pointer_red = this->pointer.get();
 
         QObject::connect(touch->qobject.get(),
                          &touch_qobject::down,
                          touch_red->qobject.get(),
-                         [touch_red](auto const& event) { touch_red->process_down(event); });
+                         [touch_red, pointer_red](auto const& event) {
+                             pointer_red->flush_motions();
+                             touch_red->process_down(event);
+                         });
         QObject::connect(touch->qobject.get(),
                          &touch_qobject::up,
                          touch_red->qobject.get(),
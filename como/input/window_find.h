@@ -12,60 +12,62 @@
 namespace como::input
 {
 
-template<typename Redirect>
-auto find_controlled_window(Redirect const& redirect,
-                            QPoint const& pos) -> std::optional<typename Redirect::window_t>
+template<typename Win>
+bool is_controlled_input_target(Win* win, QPoint const& pos, bool screen_locked)
 {
-    auto const isScreenLocked = win::wayland::screen_lock_is_locked(redirect.space);
-    auto const& stacking = redirect.space.stacking.order.stack;
-    if (stacking.empty()) {
-        return {};
+    if (win->remnant) {
+        // a deleted window doesn't get mouse events
+        return false;
+    }
+    if (win->control) {
+        if (!win::on_current_subspace(*win) || win->control->minimized) {
+            return false;
+        }
     }
+    if (win->isHiddenInternal()) {
+        return false;
+    }
+    if (!win->render_data.ready_for_painting) {
+        return false;
+    }
+    if (screen_locked) {
+        auto show{false};
+        using win_t = decltype(win);
 
-    auto it = stacking.end();
+        if constexpr (requires(win_t win) { win->isLockScreen(); }) {
+            show |= win->isLockScreen();
+        }
+        if constexpr (requires(win_t win) { win->isInputMethod(); }) {
+            show |= win->isInputMethod();
+        }
+        if (!show) {
+            return false;
+        }
+    }
+    return win::input_geometry(win).contains(pos) && win::wayland::accepts_input(win, pos);
+}
 
-    do {
-        --it;
+template<typename Win>
+bool is_uncontrolled_input_target(Win* win, QPoint const& pos)
+{
+    return !win->control && !win->remnant && win::input_geometry(win).contains(pos)
+        && win::wayland::accepts_input(win, pos);
+}
 
-        if (std::visit(overload{[&](auto&& win) {
-                           if (win->remnant) {
-                               // a deleted window doesn't get mouse events
-                               return false;
-                           }
-                           if (win->control) {
-                               if (!win::on_current_subspace(*win) || win->control->minimized) {
-                                   return false;
-                               }
-                           }
-                           if (win->isHiddenInternal()) {
-                               return false;
-                           }
-                           if (!win->render_data.ready_for_painting) {
-                               return false;
-                           }
-                           if (isScreenLocked) {
-                               auto show{false};
-                               using win_t = decltype(win);
+template<typename Redirect>
+auto find_controlled_window(Redirect const& redirect,
+                            QPoint const& pos) -> std::optional<typename Redirect::window_t>
+{
+    auto const screen_locked = win::wayland::screen_lock_is_locked(redirect.space);
 
-                               if constexpr (requires(win_t win) { win->isLockScreen(); }) {
-                                   show |= win->isLockScreen();
-                               }
-                               if constexpr (requires(win_t win) { win->isInputMethod(); }) {
-                                   show |= win->isInputMethod();
-                               }
-                               if (!show) {
-                                   return false;
-                               }
-                           }
-                           return win::input_geometry(win).contains(pos)
-                               && win::wayland::accepts_input(win, pos);
-                       }},
-                       *it)) {
-            return *it;
+    return redirect.win_index->find(pos, [&](auto const& win, bool uncontrolled) {
+        if (uncontrolled) {
+            return false;
         }
-    } while (it != stacking.begin());
-
-    return {};
+        return std::visit(
+            overload{[&](auto&& win) { return is_controlled_input_target(win, pos, screen_locked); }},
+            win);
+    });
 }
 
 template<typename Redirect>
@@ -82,19 +84,14 @@ auto find_window(Redirect const& redirect,
         return {};
     }
 
-    // Check windows without control (important for Xwayland unmanageds).
-    for (auto const& win : redirect.space.windows) {
-        if (std::visit(overload{[&](auto&& win) {
-                           return !win->control && !win->remnant
-                               && win::input_geometry(win).contains(pos)
-                               && win::wayland::accepts_input(win, pos);
-                       }},
-                       win)) {
-            return win;
-        }
-    }
-
-    return find_controlled_window(redirect, pos);
+    // Windows without control are checked first (important for Xwayland unmanageds).
+    return redirect.win_index->find(pos, [&](auto const& win, bool uncontrolled) {
+        return std::visit(overload{[&](auto&& win) {
+                              return uncontrolled ? is_uncontrolled_input_target(win, pos)
+                                                  : is_controlled_input_target(win, pos, false);
+                          }},
+                          win);
+    });
 }
 
 }
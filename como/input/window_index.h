@@ -0,0 +1,350 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/utils/algorithm.h>
+#include <como/win/deco.h>
+#include <como/win/geo.h>
+#include <como/win/stacking_order.h>
+#include <como/win/window_qobject.h>
+
+#include <QObject>
+#include <QPoint>
+#include <QRect>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace como::input
+{
+
+/**
+ * Spatial index over the input geometries of windows for finding the window at a position.
+ *
+ * Windows are sorted into a grid of square cells by their input geometry. A lookup only checks
+ * the windows in the cell of the position. The order is the one input::find_window requires:
+ * first windows without control in the order of the space, then all windows in the stacking
+ * order from top to bottom.
+ *
+ * The index is rebuilt lazily on the next lookup after windows were added, removed or restacked.
+ * Single windows are sorted again into the grid when their frame geometry or the borders of their
+ * decoration changed.
+ */
+template<typename Space>
+class window_index
+{
+public:
+    using window_t = typename Space::window_t;
+
+    static constexpr int cell_size{256};
+
+    // Cells are clamped to this range. Positions and geometries outside of it share the cells at
+    // its border.
+    static constexpr int cell_limit{128};
+
+    explicit window_index(Space& space)
+        : qobject{std::make_unique<QObject>()}
+        , space{space}
+    {
+        auto invalidate = [this] { rebuild_required = true; };
+
+        QObject::connect(space.stacking.order.qobject.get(),
+                         &win::stacking_order_qobject::changed,
+                         qobject.get(),
+                         invalidate);
+
+        auto space_qobject = space.qobject.get();
+        using space_qobject_t = std::remove_pointer_t<decltype(space_qobject)>;
+
+        QObject::connect(space_qobject, &space_qobject_t::clientAdded, qobject.get(), invalidate);
+        QObject::connect(space_qobject, &space_qobject_t::clientRemoved, qobject.get(), invalidate);
+        QObject::connect(
+            space_qobject, &space_qobject_t::wayland_window_added, qobject.get(), invalidate);
+        QObject::connect(
+            space_qobject, &space_qobject_t::wayland_window_removed, qobject.get(), invalidate);
+        QObject::connect(
+            space_qobject, &space_qobject_t::unmanagedAdded, qobject.get(), invalidate);
+        QObject::connect(
+            space_qobject, &space_qobject_t::unmanagedRemoved, qobject.get(), invalidate);
+        QObject::connect(
+            space_qobject, &space_qobject_t::internalClientAdded, qobject.get(), invalidate);
+        QObject::connect(
+            space_qobject, &space_qobject_t::internalClientRemoved, qobject.get(), invalidate);
+        QObject::connect(
+            space_qobject, &space_qobject_t::remnant_created, qobject.get(), invalidate);
+        QObject::connect(
+            space_qobject, &space_qobject_t::window_deleted, qobject.get(), invalidate);
+    }
+
+    ~window_index()
+    {
+        for (auto& [id, conns] : connections) {
+            disconnect(conns);
+        }
+    }
+
+    window_index(window_index const&) = delete;
+    window_index& operator=(window_index const&) = delete;
+
+    /**
+     * Returns the first window that might have its input geometry at @p pos and is accepted by
+     * @p accept. The callback gets the window and whether it is checked as window without
+     * control.
+     */
+    template<typename Accept>
+    std::optional<window_t> find(QPoint const& pos, Accept&& accept)
+    {
+        update();
+
+        auto it = cells.find(get_cell_key(get_cell(pos.x()), get_cell(pos.y())));
+        if (it == cells.end()) {
+            return {};
+        }
+
+        for (auto index : it->second) {
+            auto const& entry = entries.at(index);
+            if (accept(entry.window, entry.uncontrolled)) {
+                return entry.window;
+            }
+        }
+
+        return {};
+    }
+
+    void invalidate()
+    {
+        rebuild_required = true;
+    }
+
+private:
+    struct entry {
+        window_t window;
+        uint32_t signal_id;
+        QRect rect;
+        bool uncontrolled;
+    };
+
+    struct window_connections {
+        QMetaObject::Connection geometry;
+        KDecoration2::Decoration* decoration{nullptr};
+        std::vector<QMetaObject::Connection> deco;
+    };
+
+    static void disconnect(window_connections& conns)
+    {
+        QObject::disconnect(conns.geometry);
+        for (auto& connection : conns.deco) {
+            QObject::disconnect(connection);
+        }
+    }
+
+    static int get_cell(int coord)
+    {
+        auto cell = coord >= 0 ? coord / cell_size : (coord + 1) / cell_size - 1;
+        return std::clamp(cell, -cell_limit, cell_limit);
+    }
+
+    static uint64_t get_cell_key(int cell_x, int cell_y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cell_x)) << 32)
+            | static_cast<uint32_t>(cell_y);
+    }
+
+    template<typename Op>
+    static void for_each_cell(QRect const& rect, Op&& op)
+    {
+        if (!rect.isValid()) {
+            return;
+        }
+
+        auto const right = get_cell(rect.right());
+        auto const bottom = get_cell(rect.bottom());
+
+        for (auto x = get_cell(rect.left()); x <= right; x++) {
+            for (auto y = get_cell(rect.top()); y <= bottom; y++) {
+                op(get_cell_key(x, y));
+            }
+        }
+    }
+
+    void update()
+    {
+        // Count checks in addition to the signals as a safeguard against windows that got removed
+        // without notice.
+        if (rebuild_required || windows_count != space.windows.size()
+            || stack_count != space.stacking.order.stack.size()) {
+            rebuild();
+            return;
+        }
+
+        for (auto id : dirty) {
+            auto it = window_entries.find(id);
+            if (it == window_entries.end()) {
+                continue;
+            }
+            for (auto index : it->second) {
+                update_entry(index);
+            }
+        }
+        dirty.clear();
+    }
+
+    void rebuild()
+    {
+        rebuild_required = false;
+        dirty.clear();
+        entries.clear();
+        cells.clear();
+        window_entries.clear();
+
+        windows_count = space.windows.size();
+        stack_count = space.stacking.order.stack.size();
+
+        for (auto const& win : space.windows) {
+            std::visit(overload{[this](auto&& win) {
+                           if (!win->control && !win->remnant) {
+                               add_entry(win, true);
+                           }
+                       }},
+                       win);
+        }
+
+        auto const& stack = space.stacking.order.stack;
+        for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+            std::visit(overload{[this](auto&& win) {
+                           if (!win->remnant) {
+                               // A deleted window doesn't get input events.
+                               add_entry(win, false);
+                           }
+                       }},
+                       *it);
+        }
+
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (window_entries.contains(it->first)) {
+                ++it;
+                continue;
+            }
+            disconnect(it->second);
+            it = connections.erase(it);
+        }
+    }
+
+    template<typename Win>
+    void add_entry(Win* win, bool uncontrolled)
+    {
+        auto const id = win->meta.signal_id;
+        auto const index = entries.size();
+
+        entries.push_back({win, id, win::input_geometry(win), uncontrolled});
+        window_entries[id].push_back(index);
+
+        // Entries are added in lookup order. So we can just append to the cells.
+        for_each_cell(entries.back().rect, [&](auto key) { cells[key].push_back(index); });
+
+        auto& conns = connections[id];
+        if (!conns.geometry) {
+            conns.geometry = QObject::connect(win->qobject.get(),
+                                              &win::window_qobject::frame_geometry_changed,
+                                              qobject.get(),
+                                              [this, id] { dirty.push_back(id); });
+        }
+        connect_decoration(win, conns);
+    }
+
+    /**
+     * The input geometry of decorated windows includes the resize only borders. These and the
+     * borders can change without the frame geometry changing.
+     */
+    template<typename Win>
+    void connect_decoration(Win* win, window_connections& conns)
+    {
+        auto deco = win::decoration(win);
+        if (deco == conns.decoration) {
+            return;
+        }
+
+        for (auto& connection : conns.deco) {
+            QObject::disconnect(connection);
+        }
+        conns.deco.clear();
+        conns.decoration = deco;
+
+        if (!deco) {
+            return;
+        }
+
+        auto const id = win->meta.signal_id;
+        auto mark_dirty = [this, id] { dirty.push_back(id); };
+
+        conns.deco.push_back(QObject::connect(deco,
+                                              &KDecoration2::Decoration::resizeOnlyBordersChanged,
+                                              qobject.get(),
+                                              mark_dirty));
+        conns.deco.push_back(QObject::connect(
+            deco, &KDecoration2::Decoration::bordersChanged, qobject.get(), mark_dirty));
+        conns.deco.push_back(
+            QObject::connect(deco, &QObject::destroyed, qobject.get(), [this, id] {
+                if (auto it = connections.find(id); it != connections.end()) {
+                    it->second.decoration = nullptr;
+                    it->second.deco.clear();
+                }
+                dirty.push_back(id);
+            }));
+    }
+
+    void update_entry(size_t index)
+    {
+        auto& entry = entries.at(index);
+        auto const rect = std::visit(overload{[this, &entry](auto&& win) {
+                                         // A decoration might have been created for the window.
+                                         connect_decoration(win, connections[entry.signal_id]);
+                                         return win::input_geometry(win);
+                                     }},
+                                     entry.window);
+
+        if (rect == entry.rect) {
+            return;
+        }
+
+        for_each_cell(entry.rect, [&](auto key) {
+            auto it = cells.find(key);
+            if (it == cells.end()) {
+                return;
+            }
+            auto& cell = it->second;
+            cell.erase(std::remove(cell.begin(), cell.end(), index), cell.end());
+            if (cell.empty()) {
+                cells.erase(it);
+            }
+        });
+
+        entry.rect = rect;
+
+        for_each_cell(entry.rect, [&](auto key) {
+            auto& cell = cells[key];
+            cell.insert(std::lower_bound(cell.begin(), cell.end(), index), index);
+        });
+    }
+
+    std::unique_ptr<QObject> qobject;
+    Space& space;
+
+    std::vector<entry> entries;
+    std::unordered_map<uint64_t, std::vector<size_t>> cells;
+    std::unordered_map<uint32_t, std::vector<size_t>> window_entries;
+    std::unordered_map<uint32_t, window_connections> connections;
+    std::vector<uint32_t> dirty;
+
+    size_t windows_count{0};
+    size_t stack_count{0};
+    bool rebuild_required{true};
+};
+
+}
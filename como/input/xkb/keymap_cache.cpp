@@ -0,0 +1,239 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "keymap_cache.h"
+
+#include <como/base/logging.h>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <xkbcommon/xkbcommon.h>
+
+namespace como::input::xkb
+{
+
+namespace
+{
+
+constexpr quint32 file_magic = 0x43584b4d;
+constexpr quint32 file_version = 1;
+
+// Usually only the configured keymap and the default one are in use.
+constexpr size_t max_keymaps_in_memory{8};
+
+}
+
+keymap_cache::keymap_cache()
+    : m_directory(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                  + QStringLiteral("/como/xkb"))
+{
+}
+
+keymap_cache::~keymap_cache()
+{
+    for (auto& write : pending_writes) {
+        write.waitForFinished();
+    }
+}
+
+std::shared_ptr<keymap> keymap_cache::get(xkb_context* context, xkb_rule_names const& names)
+{
+    auto const key = keymap_cache::key(context, names);
+
+    if (auto it = keymaps.find(key); it != keymaps.end()) {
+        it->second.last_use = ++uses;
+        return it->second.map;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto raw = read(context, key);
+    auto const cached = raw != nullptr;
+
+    if (!raw) {
+        raw = xkb_keymap_new_from_names(context, &names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        if (!raw) {
+            return nullptr;
+        }
+    }
+
+    auto map = std::make_shared<keymap>(raw);
+    xkb_keymap_unref(raw);
+
+    qCDebug(KWIN_CORE) << (cached ? "Loaded cached keymap in" : "Compiled keymap in")
+                       << timer.elapsed() << "ms";
+
+    if (keymaps.size() >= max_keymaps_in_memory) {
+        keymaps.erase(std::min_element(keymaps.begin(), keymaps.end(), [](auto& a, auto& b) {
+            return a.second.last_use < b.second.last_use;
+        }));
+    }
+    keymaps.insert({key, {map, ++uses}});
+
+    if (!cached) {
+        write(key, QByteArray(map->cache));
+    }
+
+    return map;
+}
+
+QString keymap_cache::directory() const
+{
+    return m_directory;
+}
+
+void keymap_cache::set_directory(QString const& directory)
+{
+    m_directory = directory;
+}
+
+void keymap_cache::clear()
+{
+    keymaps.clear();
+}
+
+QByteArray keymap_cache::key(xkb_context* context, xkb_rule_names const& names)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+
+    auto add = [&](QByteArray const& part) {
+        // The size separates the parts, so different splits of the same bytes differ.
+        hash.addData(QByteArray::number(part.size()) + ':');
+        hash.addData(part);
+    };
+
+    for (auto name : {names.rules, names.model, names.layout, names.variant, names.options}) {
+        add(QByteArray(name));
+    }
+
+    // There is no runtime API for the xkeyboard-config version. Instead the modification times
+    // of the include paths' rules file and data directories are part of the key. Updates and
+    // editors replace files, which changes the modification time of their directory.
+    auto const rules = QString::fromLatin1(names.rules && names.rules[0] ? names.rules : "evdev");
+    auto const num_paths = xkb_context_num_include_paths(context);
+
+    for (unsigned int index = 0; index < num_paths; index++) {
+        QDir const path(QString::fromLocal8Bit(xkb_context_include_path_get(context, index)));
+        add(path.path().toLocal8Bit());
+
+        for (auto const& entry : {QStringLiteral("rules/") + rules,
+                                  QStringLiteral("rules"),
+                                  QStringLiteral("keycodes"),
+                                  QStringLiteral("types"),
+                                  QStringLiteral("compat"),
+                                  QStringLiteral("symbols")}) {
+            QFileInfo const info(path.filePath(entry));
+            add(QByteArray::number(info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0));
+        }
+    }
+
+    return hash.result().toHex();
+}
+
+xkb_keymap* keymap_cache::read(xkb_context* context, QByteArray const& key) const
+{
+    if (m_directory.isEmpty()) {
+        return nullptr;
+    }
+
+    QFile file(file_path(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic;
+    quint32 version;
+    QByteArray content;
+    stream >> magic >> version >> content;
+
+    if (stream.status() != QDataStream::Ok || magic != file_magic || version != file_version
+        || content.isEmpty()) {
+        file.remove();
+        return nullptr;
+    }
+
+    auto keymap = xkb_keymap_new_from_buffer(context,
+                                             content.constData(),
+                                             content.size(),
+                                             XKB_KEYMAP_FORMAT_TEXT_V1,
+                                             XKB_KEYMAP_COMPILE_NO_FLAGS);
+    if (!keymap) {
+        qCWarning(KWIN_CORE) << "Failed to load cached keymap" << file.fileName();
+        file.remove();
+    }
+
+    return keymap;
+}
+
+void keymap_cache::write(QByteArray const& key, QByteArray const& content)
+{
+    if (m_directory.isEmpty()) {
+        return;
+    }
+
+    pending_writes.erase(std::remove_if(pending_writes.begin(),
+                                        pending_writes.end(),
+                                        [](auto const& write) { return write.isFinished(); }),
+                         pending_writes.end());
+
+    // Files of keymaps in memory are kept, all others are from earlier configurations or an
+    // outdated xkeyboard-config.
+    QStringList used_files;
+    for (auto const& [used_key, cached] : keymaps) {
+        used_files.push_back(QString::fromLatin1(used_key));
+    }
+
+    // Written on the thread pool so that a new keymap is applied without waiting on the disk.
+    pending_writes.push_back(QtConcurrent::run([directory = m_directory,
+                                                path = file_path(key),
+                                                content,
+                                                used_files] {
+        if (!QDir().mkpath(directory)) {
+            qCWarning(KWIN_CORE) << "Failed to create keymap cache directory" << directory;
+            return;
+        }
+
+        // Written atomically so that concurrent sessions never read a partial keymap.
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qCWarning(KWIN_CORE) << "Failed to write keymap cache file" << path;
+            return;
+        }
+
+        QDataStream stream(&file);
+        stream << file_magic << file_version << content;
+
+        if (!file.commit()) {
+            qCWarning(KWIN_CORE) << "Failed to write keymap cache file" << path;
+            return;
+        }
+
+        // Names with a dot are temporary files of writes in progress by other sessions.
+        QDir const dir(directory);
+        for (auto const& name : dir.entryList(QDir::Files)) {
+            if (!name.contains(QLatin1Char('.')) && !used_files.contains(name)) {
+                QFile::remove(dir.filePath(name));
+            }
+        }
+    }));
+}
+
+QString keymap_cache::file_path(QByteArray const& key) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(key);
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "keymap.h"
+
+#include "como_export.h"
+
+#include <QByteArray>
+#include <QFuture>
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct xkb_context;
+struct xkb_rule_names;
+
+namespace como::input::xkb
+{
+
+/**
+ * Caches compiled keymaps in memory and on disk.
+ *
+ * Compiling a keymap from its rule names resolves the rules and reads dozens of files from the
+ * xkeyboard-config database. Loading the serialized result of an earlier compilation skips this.
+ * Keymaps are identified by their rule names and the state of the xkb include paths, so an
+ * update of xkeyboard-config or changed user files invalidate cached keymaps implicitly.
+ */
+class COMO_EXPORT keymap_cache
+{
+public:
+    keymap_cache();
+    ~keymap_cache();
+
+    /// Returns nullptr if the keymap can not be compiled.
+    std::shared_ptr<keymap> get(xkb_context* context, xkb_rule_names const& names);
+
+    /// An empty directory disables the on-disk cache.
+    QString directory() const;
+    void set_directory(QString const& directory);
+
+    /// Drops all keymaps held in memory.
+    void clear();
+
+private:
+    struct cached_keymap {
+        std::shared_ptr<keymap> map;
+        uint64_t last_use;
+    };
+
+    static QByteArray key(xkb_context* context, xkb_rule_names const& names);
+
+    xkb_keymap* read(xkb_context* context, QByteArray const& key) const;
+    void write(QByteArray const& key, QByteArray const& content);
+    QString file_path(QByteArray const& key) const;
+
+    std::unordered_map<QByteArray, cached_keymap> keymaps;
+    uint64_t uses{0};
+    std::vector<QFuture<void>> pending_writes;
+    QString m_directory;
+};
+
+}
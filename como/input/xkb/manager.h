@@ -9,6 +9,7 @@
 #pragma once
 
 #include "keyboard.h"
+#include "keymap_cache.h"
 #include "numlock.h"
 
 #include <como/base/logging.h>
@@ -109,7 +110,7 @@ public:
 
     void reconfigure()
     {
-        xkb_keymap* keymap{nullptr};
+        std::shared_ptr<xkb::keymap> keymap;
         std::vector<std::string> layouts;
 
         if (!qEnvironmentVariableIsSet("KWIN_XKB_DEFAULT_KEYMAP")) {
@@ -124,8 +125,7 @@ public:
             return;
         }
 
-        default_keyboard->update(std::make_unique<xkb::keymap>(keymap), layouts);
-        xkb_keymap_unref(keymap);
+        default_keyboard->update(keymap, layouts);
 
         numlock_evaluate_startup(*this, *default_keyboard);
         default_keyboard->update_modifiers();
@@ -142,6 +142,8 @@ public:
     std::unique_ptr<keyboard> default_keyboard;
     Platform* platform;
 
+    keymap_cache keymaps;
+
     KSharedConfigPtr numlock_config;
     KConfigGroup m_configGroup;
 
@@ -184,7 +186,7 @@ private:
         }
     }
 
-    xkb_keymap* loadKeymapFromConfig(std::vector<std::string>& layouts)
+    std::shared_ptr<xkb::keymap> loadKeymapFromConfig(std::vector<std::string>& layouts)
     {
         // load config
         if (!m_configGroup.isValid()) {
@@ -204,16 +206,16 @@ private:
 
         apply_environment_rules(ruleNames, layouts);
 
-        return xkb_keymap_new_from_names(context, &ruleNames, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        return keymaps.get(context, ruleNames);
     }
 
-    xkb_keymap* loadDefaultKeymap(std::vector<std::string>& layouts)
+    std::shared_ptr<xkb::keymap> loadDefaultKeymap(std::vector<std::string>& layouts)
     {
         xkb_rule_names ruleNames = {};
 
         apply_environment_rules(ruleNames, layouts);
 
-        return xkb_keymap_new_from_names(context, &ruleNames, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        return keymaps.get(context, ruleNames);
     }
 };
 
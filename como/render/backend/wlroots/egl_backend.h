@@ -274,6 +274,7 @@ public:
 
     std::unique_ptr<Wrapland::Server::linux_dmabuf_v1> dmabuf;
     wayland::egl_data data;
+    shm_texture_pool shm_textures;
 
     std::stack<framebuffer*> render_targets;
     GLFramebuffer native_fbo;
@@ -282,6 +283,7 @@ public:
 private:
     void cleanup()
     {
+        shm_textures.clear();
         cleanupGL();
         doneCurrent();
         cleanupSurfaces();
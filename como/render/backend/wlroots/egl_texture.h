@@ -34,7 +34,7 @@ public:
         if (m_image != EGL_NO_IMAGE_KHR) {
             eglDestroyImageKHR(m_backend->data.base.display, m_image);
         }
-        wlr_texture_destroy(native);
+        release_native_texture(*this);
     }
 
     bool updateTexture(buffer_t* buffer) override
@@ -49,6 +49,11 @@ public:
 
     gl::texture<typename Backend::abstract_type>* q;
     wlr_texture* native{nullptr};
+    /// DRM format of the native texture when it was created from shm data.
+    uint32_t native_format{0};
+    shm_staging_buffer staging;
+    /// Internal window image converted to a format we can upload.
+    QImage converted_image;
     EGLImageKHR m_image{EGL_NO_IMAGE_KHR};
     bool m_hasSubImageUnpack{false};
 
@@ -8,6 +8,7 @@
 #include "egl_output.h"
 #include "output_event.h"
 #include "qpainter_output.h"
+#include "scanout.h"
 #include "wlr_includes.h"
 
 #include <como/base/utils.h>
@@ -53,6 +54,18 @@ public:
         wl_signal_add(&base.native->events.frame, &frame_rec.event);
     }
 
+    bool direct_scanout(typename abstract_type::space_t::window_t window) override
+    {
+        return std::visit(overload{[this](auto&& win) {
+                              if constexpr (requires(decltype(win) win) { win->surface; }) {
+                                  return scanout_window(*this, win);
+                              } else {
+                                  return false;
+                              }
+                          }},
+                          window);
+    }
+
     std::unique_ptr<egl_output_t> egl;
     std::unique_ptr<qpainter_output_t> qpainter;
 
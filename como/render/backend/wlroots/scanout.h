@@ -0,0 +1,125 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "wlr_includes.h"
+
+#include <como/base/logging.h>
+
+#include <Wrapland/Server/buffer.h>
+#include <Wrapland/Server/linux_dmabuf_v1.h>
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace como::render::backend::wlroots
+{
+
+/**
+ * Hands a client dmabuf to wlroots for being shown on an output. The client buffer is held until
+ * wlroots releases the wrapper, so the client does not reuse it while it is scanned out.
+ */
+struct wlr_client_dmabuf_buffer {
+    wlr_buffer base;
+    wlr_dmabuf_attributes attribs;
+    std::shared_ptr<Wrapland::Server::Buffer> client_buffer;
+};
+
+static void wlr_client_dmabuf_buffer_destroy(wlr_buffer* wlr_buf)
+{
+    wlr_client_dmabuf_buffer* buffer = wl_container_of(wlr_buf, buffer, base);
+    delete buffer;
+}
+
+static bool wlr_client_dmabuf_buffer_get_dmabuf(wlr_buffer* wlr_buf,
+                                                wlr_dmabuf_attributes* attribs)
+{
+    wlr_client_dmabuf_buffer* buffer = wl_container_of(wlr_buf, buffer, base);
+    *attribs = buffer->attribs;
+    return true;
+}
+
+static wlr_buffer_impl const wlr_client_dmabuf_buffer_impl = {
+    .destroy = wlr_client_dmabuf_buffer_destroy,
+    .get_dmabuf = wlr_client_dmabuf_buffer_get_dmabuf,
+};
+
+static inline wlr_client_dmabuf_buffer*
+wlr_client_dmabuf_buffer_create(std::shared_ptr<Wrapland::Server::Buffer> client_buffer)
+{
+    auto dmabuf = client_buffer->linuxDmabufBuffer();
+    assert(dmabuf);
+
+    auto buffer = new wlr_client_dmabuf_buffer;
+    wlr_buffer_init(
+        &buffer->base, &wlr_client_dmabuf_buffer_impl, dmabuf->size.width(), dmabuf->size.height());
+
+    auto& attribs = buffer->attribs;
+    attribs = {};
+    attribs.width = dmabuf->size.width();
+    attribs.height = dmabuf->size.height();
+    attribs.format = dmabuf->format;
+    attribs.modifier = dmabuf->modifier;
+
+    auto const& planes = dmabuf->planes;
+    attribs.n_planes = std::min(planes.size(), static_cast<size_t>(WLR_DMABUF_MAX_PLANES));
+
+    for (int i = 0; i < attribs.n_planes; i++) {
+        auto const& plane = planes.at(i);
+        attribs.offset[i] = plane.offset;
+        attribs.stride[i] = plane.stride;
+        attribs.fd[i] = plane.fd;
+    }
+
+    buffer->client_buffer = std::move(client_buffer);
+    return buffer;
+}
+
+/**
+ * Commits the surface buffer of @p win directly to @p out without compositing. Returns false when
+ * the output does not accept the buffer. The scene must be composited then as usual.
+ */
+template<typename Output, typename Win>
+bool scanout_window(Output& out, Win* win)
+{
+    if (!out.egl) {
+        return false;
+    }
+
+    auto& base = out.base;
+    auto buffer = wlr_client_dmabuf_buffer_create(win->surface->state().buffer);
+
+    base.ensure_next_state();
+    auto state = base.next_state->get_native();
+    wlr_output_state_set_buffer(state, &buffer->base);
+
+    // The state holds its own lock on the buffer now.
+    wlr_buffer_drop(&buffer->base);
+
+    if (!wlr_output_test_state(base.native, state)) {
+        // Not possible with this buffer. Most likely its format or modifier are not supported for
+        // scanout. We try again on the next frame.
+        base.next_state.reset();
+        return false;
+    }
+
+    out.swap_pending = true;
+
+    if (!wlr_output_commit_state(base.native, state)) {
+        qCWarning(KWIN_CORE) << "Atomic output commit failed on direct scanout.";
+        out.swap_pending = false;
+        base.next_state.reset();
+        return false;
+    }
+
+    base.next_state.reset();
+
+    // The content of our own buffers is unknown now. The next composited frame is painted fully.
+    out.egl->damageHistory.clear();
+    return true;
+}
+
+}
@@ -0,0 +1,176 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "wlr_includes.h"
+#include "wlr_non_owning_data_buffer.h"
+
+#include <QRegion>
+#include <QSize>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+
+namespace como::render::backend::wlroots
+{
+
+/**
+ * Wraps client memory into a wlr_buffer for uploads. The wrapper is allocated once per texture and
+ * only pointed to the current data on each upload.
+ */
+class shm_staging_buffer
+{
+public:
+    shm_staging_buffer() = default;
+    shm_staging_buffer(shm_staging_buffer const&) = delete;
+    shm_staging_buffer& operator=(shm_staging_buffer const&) = delete;
+
+    ~shm_staging_buffer()
+    {
+        if (buffer) {
+            wlr_buffer_drop(&buffer->base);
+        }
+    }
+
+    wlr_buffer* get(QSize const& size, uint32_t format, uint32_t stride, void* data)
+    {
+        if (!buffer) {
+            buffer = wlr_non_owning_data_buffer_create(
+                size.width(), size.height(), format, stride, data);
+            return buffer ? &buffer->base : nullptr;
+        }
+
+        buffer->base.width = size.width();
+        buffer->base.height = size.height();
+        buffer->format = format;
+        buffer->stride = stride;
+        buffer->data = data;
+        return &buffer->base;
+    }
+
+private:
+    wlr_non_owning_data_buffer* buffer{nullptr};
+};
+
+/**
+ * Holds textures of destroyed shm buffers for reuse by new buffers of the same format and size.
+ * This is the common case for windows that are shown repeatedly like menus and tooltips, and for
+ * windows switching between a few sizes like on maximizing.
+ *
+ * The pool is limited in count and size. The oldest textures are destroyed first. All calls must
+ * happen with the GL context being current.
+ */
+class shm_texture_pool
+{
+public:
+    static constexpr size_t max_count{16};
+    static constexpr size_t max_bytes{64 * 1024 * 1024};
+
+    shm_texture_pool() = default;
+    shm_texture_pool(shm_texture_pool const&) = delete;
+    shm_texture_pool& operator=(shm_texture_pool const&) = delete;
+
+    ~shm_texture_pool()
+    {
+        clear();
+    }
+
+    wlr_texture* take(uint32_t format, QSize const& size)
+    {
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+            if (it->format != format || it->size != size) {
+                continue;
+            }
+
+            auto native = it->native;
+            bytes -= get_bytes(size);
+            entries.erase(std::next(it).base());
+            return native;
+        }
+        return nullptr;
+    }
+
+    void put(wlr_texture* native, uint32_t format, QSize const& size)
+    {
+        if (get_bytes(size) > max_bytes) {
+            wlr_texture_destroy(native);
+            return;
+        }
+
+        entries.push_back({native, format, size});
+        bytes += get_bytes(size);
+
+        while (entries.size() > max_count || bytes > max_bytes) {
+            auto const& oldest = entries.front();
+            bytes -= get_bytes(oldest.size);
+            wlr_texture_destroy(oldest.native);
+            entries.pop_front();
+        }
+    }
+
+    void clear()
+    {
+        for (auto& entry : entries) {
+            wlr_texture_destroy(entry.native);
+        }
+        entries.clear();
+        bytes = 0;
+    }
+
+    size_t count() const
+    {
+        return entries.size();
+    }
+
+private:
+    struct entry {
+        wlr_texture* native;
+        uint32_t format;
+        QSize size;
+    };
+
+    static size_t get_bytes(QSize const& size)
+    {
+        // All shm formats we upload have 4 bytes per pixel.
+        return static_cast<size_t>(size.width()) * size.height() * 4;
+    }
+
+    std::deque<entry> entries;
+    size_t bytes{0};
+};
+
+/// Damage with more rects than this is always uploaded as its bounding rect.
+constexpr int shm_damage_rect_limit{16};
+
+/**
+ * Reduces the number of upload calls for @p damage clipped to @p bounds. Every rect is uploaded
+ * separately. When the bounding rect of the damage is at most twice as large as the damage itself
+ * uploading it in one go is cheaper than many small uploads.
+ */
+inline QRegion coalesce_damage(QRegion const& damage, QRect const& bounds)
+{
+    auto const region = damage.intersected(bounds);
+    if (region.rectCount() <= 1) {
+        return region;
+    }
+
+    auto const bounding = region.boundingRect();
+    if (region.rectCount() > shm_damage_rect_limit) {
+        return bounding;
+    }
+
+    int64_t area{0};
+    for (auto const& rect : region) {
+        area += static_cast<int64_t>(rect.width()) * rect.height();
+    }
+
+    if (2 * area >= static_cast<int64_t>(bounding.width()) * bounding.height()) {
+        return bounding;
+    }
+    return region;
+}
+
+}
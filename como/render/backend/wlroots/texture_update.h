@@ -8,7 +8,7 @@
 #include "platform.h"
 #include "wlr_helpers.h"
 #include "wlr_includes.h"
-#include "wlr_non_owning_data_buffer.h"
+#include "shm_upload.h"
 
 #include <como/render/gl/window.h>
 #include <como/render/wayland/buffer.h>
@@ -17,6 +17,7 @@
 
 #include <QImage>
 #include <QOpenGLFramebufferObject>
+#include <QPainter>
 #include <Wrapland/Server/buffer.h>
 #include <Wrapland/Server/linux_dmabuf_v1.h>
 #include <Wrapland/Server/surface.h>
@@ -102,15 +103,49 @@ bool update_texture_from_fbo(Texture& texture, std::shared_ptr<QOpenGLFramebuffe
     return true;
 }
 
+/**
+ * Returns @p image in @p format for uploading. When a conversion is needed it is written to
+ * @p cache. The cache holds the conversion of the previous update so only the @p damage in device
+ * pixels is converted again.
+ */
+inline QImage const&
+get_converted_image(QImage const& image, QImage::Format format, QRegion const& damage, QImage& cache)
+{
+    if (image.format() == format) {
+        cache = {};
+        return image;
+    }
+
+    if (cache.size() != image.size() || cache.format() != format) {
+        cache = image.convertToFormat(format);
+        cache.setDevicePixelRatio(1);
+        return cache;
+    }
+
+    // Wrap the source without its device pixel ratio, so the painter does not scale it.
+    QImage const source(
+        image.constBits(), image.width(), image.height(), image.bytesPerLine(), image.format());
+
+    QPainter painter(&cache);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+    for (auto const& rect : damage.intersected(image.rect())) {
+        painter.drawImage(rect.topLeft(), source, rect);
+    }
+
+    return cache;
+}
+
 template<typename Texture, typename WinBuffer>
 bool update_texture_from_internal_image_object(Texture& texture, WinBuffer const& buffer)
 {
-    auto const image = buffer.internal.image;
+    auto const& image = buffer.internal.image;
     if (image.isNull()) {
         return false;
     }
 
     uint32_t format;
+    QImage::Format upload_format;
 
     // TODO(romangg): The Qt pixel formats depend on the endianness while DRM is always LE. So on BE
     //                machines QImage::Format_RGBA8888_Premultiplied would instead correspond to
@@ -121,35 +156,52 @@ bool update_texture_from_internal_image_object(Texture& texture, WinBuffer const
     switch (image.format()) {
     case QImage::Format_ARGB32:
     case QImage::Format_ARGB32_Premultiplied:
-        format = DRM_FORMAT_ARGB8888;
+        if (Texture::s_supportsARGB32) {
+            format = DRM_FORMAT_ARGB8888;
+            upload_format = QImage::Format_ARGB32_Premultiplied;
+        } else {
+            format = DRM_FORMAT_ABGR8888;
+            upload_format = QImage::Format_RGBA8888_Premultiplied;
+        }
         break;
     case QImage::Format_RGB32:
-        format = DRM_FORMAT_XBGR8888;
+        if (Texture::s_supportsARGB32) {
+            format = DRM_FORMAT_XRGB8888;
+            upload_format = QImage::Format_RGB32;
+        } else {
+            format = DRM_FORMAT_XBGR8888;
+            upload_format = QImage::Format_RGBX8888;
+        }
         break;
     default:
         return false;
     }
 
-    QImage conv_image;
-    if (Texture::s_supportsARGB32 && format == DRM_FORMAT_ARGB8888) {
-        conv_image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
-    } else {
-        conv_image = image.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
-    }
-
     // We know it's an internal image so access the damage without the virtual buffer damage call.
     // TODO(romangg): Wrap this into a helper function in render::wayland namespace.
     auto const& damage = std::visit(
         overload{[&](auto&& win) -> QRegion { return win->render_data.damage_region; }},
         *buffer.buffer.window->ref_win);
 
+    auto const scale = static_cast<int>(image.devicePixelRatio());
+
+    QRegion device_damage;
+    for (auto const& rect : damage) {
+        device_damage += QRect(rect.topLeft() * scale, rect.size() * scale);
+    }
+
+    // The backing store of internal windows paints in a format we can upload directly in most
+    // cases. Otherwise we reuse the conversion of the previous update.
+    auto const& upload_image
+        = get_converted_image(image, upload_format, device_damage, texture.converted_image);
+
     return update_texture_from_data(texture,
                                     format,
-                                    image.bytesPerLine(),
+                                    upload_image.bytesPerLine(),
                                     image.size(),
                                     damage,
-                                    image.devicePixelRatio(),
-                                    conv_image.bits());
+                                    scale,
+                                    const_cast<uchar*>(upload_image.constBits()));
 }
 
 template<typename Texture>
@@ -180,6 +232,30 @@ bool update_texture_from_egl(Texture& texture, Wrapland::Server::Buffer* buffer)
     return true;
 }
 
+/**
+ * Hands the native texture of @p texture over to the shm texture pool of the backend or destroys
+ * it when the backend is already torn down or the texture was not created from shm data.
+ */
+template<typename Texture>
+void release_native_texture(Texture& texture)
+{
+    if (!texture.native) {
+        return;
+    }
+
+    if (texture.native_format && texture.m_backend->backend.frontend->egl_data) {
+        texture.m_backend->shm_textures.put(texture.native, texture.native_format, texture.m_size);
+    } else {
+        wlr_texture_destroy(texture.native);
+    }
+
+    texture.native = nullptr;
+    texture.native_format = 0;
+
+    // The GL texture is owned by the wlroots texture.
+    texture.m_texture = 0;
+}
+
 template<typename Texture, typename Dmabuf>
 bool update_texture_from_dmabuf(Texture& texture, Dmabuf* dmabuf)
 {
@@ -205,7 +281,7 @@ bool update_texture_from_dmabuf(Texture& texture, Dmabuf* dmabuf)
             dmabuf_attribs.fd[i] = plane.fd;
         }
 
-        wlr_texture_destroy(texture.native);
+        release_native_texture(texture);
         texture.native
             = wlr_texture_from_dmabuf(texture.m_backend->backend.renderer, &dmabuf_attribs);
         if (!texture.native) {
@@ -236,46 +312,98 @@ bool update_texture_from_dmabuf(Texture& texture, Dmabuf* dmabuf)
 }
 
 template<typename Texture>
-bool update_texture_from_data(Texture& texture,
+bool upload_texture_data(Texture& texture,
+                         uint32_t format,
+                         uint32_t stride,
+                         QSize const& size,
+                         pixman_region32_t* damage,
+                         void* data)
+{
+    auto buffer = texture.staging.get(size, format, stride, data);
+    if (!buffer) {
+        return false;
+    }
+
+    return wlr_texture_update_from_buffer(texture.native, buffer, damage);
+}
+
+template<typename Texture>
+bool create_texture_from_data(Texture& texture,
                               uint32_t format,
                               uint32_t stride,
                               QSize const& size,
-                              QRegion const& damage,
-                              int32_t scale,
                               void* data)
 {
-    if (size != texture.m_size) {
-        // First time update or size has changed.
-        wlr_texture_destroy(texture.native);
+    release_native_texture(texture);
+
+    if (auto native = texture.m_backend->shm_textures.take(format, size)) {
+        texture.native = native;
+
+        pixman_region32_t full;
+        pixman_region32_init_rect(&full, 0, 0, size.width(), size.height());
+        auto const success = upload_texture_data(texture, format, stride, size, &full, data);
+        pixman_region32_fini(&full);
+
+        if (!success) {
+            wlr_texture_destroy(texture.native);
+            texture.native = nullptr;
+        }
+
+        // The wrap mode is not part of the initial state we apply on bind. A previous owner might
+        // have changed it.
+        texture.m_wrapModeChanged = true;
+    }
+
+    if (!texture.native) {
         texture.native = wlr_texture_from_pixels(
             texture.m_backend->backend.renderer, format, stride, size.width(), size.height(), data);
         if (!texture.native) {
             return false;
         }
+    }
 
-        wlr_gles2_texture_attribs tex_attribs;
-        wlr_gles2_texture_get_attribs(texture.native, &tex_attribs);
+    texture.native_format = format;
 
-        texture.m_texture = tex_attribs.tex;
-        texture.q->unbind();
-        texture.q->set_content_transform(effect::transform_type::flipped_180);
-        texture.m_size = size;
-        texture.updateMatrix();
+    wlr_gles2_texture_attribs tex_attribs;
+    wlr_gles2_texture_get_attribs(texture.native, &tex_attribs);
 
-        return true;
+    texture.m_texture = tex_attribs.tex;
+    texture.q->unbind();
+    texture.q->set_content_transform(effect::transform_type::flipped_180);
+    texture.m_size = size;
+    texture.updateMatrix();
+
+    return true;
+}
+
+template<typename Texture>
+bool update_texture_from_data(Texture& texture,
+                              uint32_t format,
+                              uint32_t stride,
+                              QSize const& size,
+                              QRegion const& damage,
+                              int32_t scale,
+                              void* data)
+{
+    if (size != texture.m_size || format != texture.native_format) {
+        // First time update or size has changed.
+        return create_texture_from_data(texture, format, stride, size, data);
     }
 
     assert(size == texture.m_size);
 
-    auto buffer
-        = wlr_non_owning_data_buffer_create(size.width(), size.height(), format, stride, data);
-    auto pixman_damage = create_scaled_pixman_region(damage, scale);
+    // Damage is in logical coordinates. Round up to not lose the last row and column of a
+    // buffer with fractional logical size and clip to the buffer below.
+    auto const bounds
+        = QRect(0, 0, (size.width() + scale - 1) / scale, (size.height() + scale - 1) / scale);
+    auto pixman_damage = create_scaled_pixman_region(coalesce_damage(damage, bounds), scale);
+    pixman_region32_intersect_rect(
+        &pixman_damage, &pixman_damage, 0, 0, size.width(), size.height());
 
-    wlr_texture_update_from_buffer(texture.native, &buffer->base, &pixman_damage);
+    auto const success = upload_texture_data(texture, format, stride, size, &pixman_damage, data);
 
     pixman_region32_fini(&pixman_damage);
-    wlr_buffer_drop(&buffer->base);
-    return true;
+    return success;
 }
 
 template<typename Texture, typename WinBuffer>
@@ -0,0 +1,72 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "frame_timing.h"
+
+#include <QDBusConnection>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+namespace como::render::dbus
+{
+
+frame_timing_qobject::frame_timing_qobject()
+{
+    QDBusConnection::sessionBus().registerObject(QStringLiteral("/FrameTiming"),
+                                                 QStringLiteral("org.kde.kwin.FrameTiming"),
+                                                 this,
+                                                 QDBusConnection::ExportAllSlots);
+}
+
+frame_timing_qobject::~frame_timing_qobject()
+{
+    QDBusConnection::sessionBus().unregisterObject(QStringLiteral("/FrameTiming"));
+}
+
+QStringList frame_timing_qobject::outputs() const
+{
+    return integration.outputs();
+}
+
+QVariantMap frame_timing_qobject::statistics(QString const& name) const
+{
+    return integration.statistics(name);
+}
+
+QString frame_timing_qobject::report() const
+{
+    return integration.report();
+}
+
+QString frame_timing_qobject::repaintPolicy(QString const& name) const
+{
+    return integration.get_repaint_policy(name);
+}
+
+bool frame_timing_qobject::setRepaintPolicy(QString const& name, QString const& policy)
+{
+    return integration.set_repaint_policy(name, policy);
+}
+
+QString frame_timing_qobject::dump(QString const& path) const
+{
+    auto file_path = path;
+    if (file_path.isEmpty()) {
+        file_path
+            = QDir(QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation))
+                  .filePath(QStringLiteral("frame-timing.txt"));
+    }
+
+    QFile file(file_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return {};
+    }
+
+    file.write(report().toUtf8());
+    return file_path;
+}
+
+}
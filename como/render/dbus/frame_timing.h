@@ -0,0 +1,173 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "como_export.h"
+
+#include <como/render/frame_timing.h>
+
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+namespace como::render::dbus
+{
+
+struct frame_timing_integration {
+    std::function<QStringList(void)> outputs;
+    std::function<QVariantMap(QString const&)> statistics;
+    std::function<QString(void)> report;
+    std::function<QString(QString const&)> get_repaint_policy;
+    std::function<bool(QString const&, QString const&)> set_repaint_policy;
+};
+
+class COMO_EXPORT frame_timing_qobject : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.kwin.FrameTiming")
+
+public:
+    frame_timing_qobject();
+    ~frame_timing_qobject() override;
+
+    frame_timing_integration integration;
+
+public Q_SLOTS:
+    /**
+     * @brief Names of all outputs timings are recorded for.
+     */
+    QStringList outputs() const;
+
+    /**
+     * @brief Statistics of recent frames on output @p name.
+     *
+     * Keys are of the form "<record>.<statistic>" with the record being one of paint, render,
+     * slack and presentInterval. Durations are given in microseconds.
+     */
+    QVariantMap statistics(QString const& name) const;
+
+    /**
+     * @brief Human-readable statistics of recent frames on all outputs.
+     */
+    QString report() const;
+
+    /**
+     * @brief Writes the report to the file at @p path.
+     *
+     * If @p path is empty the report is written to frame-timing.txt in the runtime directory.
+     *
+     * @return The path written to or an empty string on failure.
+     */
+    QString dump(QString const& path) const;
+
+    /**
+     * @brief The repaint scheduling policy of output @p name.
+     *
+     * Either "max" or "percentile". Empty if the output does not exist.
+     */
+    QString repaintPolicy(QString const& name) const;
+
+    /**
+     * @brief Sets the repaint scheduling policy of output @p name.
+     *
+     * @return Whether the output exists and @p policy is a known policy.
+     */
+    bool setRepaintPolicy(QString const& name, QString const& policy);
+};
+
+template<size_t Capacity>
+void add_duration_stats(QVariantMap& map, QString const& prefix, duration_ring<Capacity> const& ring)
+{
+    auto const stats = get_duration_stats(ring);
+    auto to_us = [](std::chrono::nanoseconds val) {
+        return std::chrono::duration<double, std::micro>(val).count();
+    };
+
+    map.insert(prefix + QStringLiteral(".count"), static_cast<qulonglong>(stats.count));
+    map.insert(prefix + QStringLiteral(".min"), to_us(stats.min));
+    map.insert(prefix + QStringLiteral(".mean"), to_us(stats.mean));
+    map.insert(prefix + QStringLiteral(".p50"), to_us(stats.p50));
+    map.insert(prefix + QStringLiteral(".p90"), to_us(stats.p90));
+    map.insert(prefix + QStringLiteral(".p95"), to_us(stats.p95));
+    map.insert(prefix + QStringLiteral(".p99"), to_us(stats.p99));
+    map.insert(prefix + QStringLiteral(".max"), to_us(stats.max));
+}
+
+template<typename Platform>
+class frame_timing
+{
+public:
+    explicit frame_timing(Platform& platform)
+        : qobject{std::make_unique<frame_timing_qobject>()}
+        , platform{platform}
+    {
+        qobject->integration.outputs = [this] {
+            QStringList ret;
+            for (auto output : this->platform.base.outputs) {
+                ret.push_back(output->name());
+            }
+            return ret;
+        };
+        qobject->integration.statistics = [this](auto const& name) {
+            QVariantMap ret;
+            auto output = get_output(name);
+            if (!output) {
+                return ret;
+            }
+
+            auto const& timings = output->render->timings;
+            add_duration_stats(ret, QStringLiteral("paint"), timings.paint);
+            add_duration_stats(ret, QStringLiteral("render"), timings.render);
+            add_duration_stats(ret, QStringLiteral("slack"), timings.slack);
+            add_duration_stats(ret, QStringLiteral("presentInterval"), timings.present_interval);
+            ret.insert(QStringLiteral("frames.hit"),
+                       static_cast<qulonglong>(timings.hit_frames.load()));
+            ret.insert(QStringLiteral("frames.missed"),
+                       static_cast<qulonglong>(timings.missed_frames.load()));
+            ret.insert(QStringLiteral("frames.scanout"),
+                       static_cast<qulonglong>(timings.scanout_frames.load()));
+            return ret;
+        };
+        qobject->integration.report = [this] {
+            QString ret;
+            for (auto output : this->platform.base.outputs) {
+                ret += frame_timing_report(output->name(), output->render->timings);
+            }
+            return ret;
+        };
+        qobject->integration.get_repaint_policy = [this](auto const& name) {
+            if (auto output = get_output(name)) {
+                return output->render->get_repaint_policy_name();
+            }
+            return QString();
+        };
+        qobject->integration.set_repaint_policy = [this](auto const& name, auto const& policy) {
+            if (auto output = get_output(name)) {
+                return output->render->set_repaint_policy(policy);
+            }
+            return false;
+        };
+    }
+
+    std::unique_ptr<frame_timing_qobject> qobject;
+
+private:
+    auto get_output(QString const& name) const
+    {
+        auto const& outputs = platform.base.outputs;
+        auto it = std::find_if(outputs.begin(), outputs.end(), [&name](auto output) {
+            return output->name() == name;
+        });
+        return it == outputs.end() ? nullptr : *it;
+    }
+
+    Platform& platform;
+};
+
+}
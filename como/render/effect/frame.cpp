@@ -243,7 +243,7 @@ effect_frame_impl::effect_frame_impl(EffectsHandler& effects,
     , m_view{new effect_frame_quick_scene(style, staticSize, position, alignment)}
 {
     connect(m_view, &OffscreenQuickView::repaintNeeded, this, [this] {
-        this->effects.addRepaint(geometry());
+        this->effects.addRepaint(m_view->damage().translated(geometry().topLeft()));
     });
     connect(m_view,
             &OffscreenQuickView::geometryChanged,
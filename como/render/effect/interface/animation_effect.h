@@ -298,6 +298,7 @@ public:
     ~AnimationEffect() override;
 
     bool isActive() const override;
+    bool blocksDirectScanout() const override;
 
     /**
      * Gets stored metadata.
@@ -308,6 +308,15 @@ public:
      */
     virtual bool isActive() const;
 
+    /**
+     * Overwrite this method to indicate whether your effect prevents fullscreen windows from being
+     * shown directly on an output while it is active. Effects that transform windows or paint on
+     * top of them must return @c true here.
+     *
+     * The default implementation of this method returns @c false.
+     */
+    virtual bool blocksDirectScanout() const;
+
     /**
      * Reimplement this method to provide online debugging.
      * This could be as trivial as printing specific detail information about the effect state
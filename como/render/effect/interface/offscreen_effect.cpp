@@ -256,6 +256,11 @@ void OffscreenEffect::drawWindow(effect::window_paint_data& data)
     d->paint(offscreenData->texture.data(), data, quads, offscreenData->shader);
 }
 
+bool OffscreenEffect::blocksDirectScanout() const
+{
+    return true;
+}
+
 void OffscreenEffect::handleWindowGeometryChanged(EffectWindow* window)
 {
     auto offscreenData = d->windows.value(window);
@@ -46,6 +46,7 @@ public:
 
 protected:
     void drawWindow(effect::window_paint_data& data) override;
+    bool blocksDirectScanout() const override;
 
     /**
      * This function must be called when the effect wants to animate the specified
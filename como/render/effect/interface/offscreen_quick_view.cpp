@@ -12,6 +12,7 @@
 #include <como/render/gl/interface/texture.h>
 
 #include <QGuiApplication>
+#include <QHash>
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
@@ -27,13 +28,26 @@
 #include <QTimer>
 #include <QTouchEvent>
 #include <QWindow>
+#include <cstring>
 
 // for QMutableEventPoint
 #include <QtGui/private/qeventpoint_p.h>
+// for the dirty state of items
+#include <QtQuick/private/qquickitem_p.h>
 
 namespace como
 {
 
+namespace
+{
+
+QRect scaledRect(QRect const& rect, qreal scale)
+{
+    return QRectF(QPointF(rect.topLeft()) * scale, QSizeF(rect.size()) * scale).toAlignedRect();
+}
+
+}
+
 class Q_DECL_HIDDEN OffscreenQuickView::Private
 {
 public:
@@ -53,6 +67,15 @@ public:
     bool m_hasAlphaChannel = true;
     bool m_automaticRepaint = true;
 
+    // Scene rects of the items with content at the last update. Compared against on the next
+    // update to find the changed region.
+    QHash<QQuickItem*, QRect> m_itemRects;
+    QSize m_nativeSize;
+    bool m_fullDamage = true;
+    QRegion m_damage;
+    // Changes of the image not yet uploaded to the exported texture.
+    QRegion m_exportDamage;
+
     QList<QEventPoint> touchPoints;
     QPointingDevice* touchDevice;
 
@@ -61,6 +84,15 @@ public:
 
     void releaseResources();
 
+    QRegion collectDamage();
+    void collectItemDamage(QQuickItem* item,
+                           bool dirty,
+                           bool effectSource,
+                           QHash<QQuickItem*, QRect>& rects,
+                           QRegion& damage,
+                           bool& full) const;
+    void readBack(QRegion const& region);
+
     void updateTouchState(Qt::TouchPointState state, qint32 id, const QPointF& pos);
 };
 
@@ -231,13 +263,27 @@ void OffscreenQuickView::update()
 
     bool usingGl = d->m_glcontext != nullptr;
 
+    const QSize nativeSize = d->m_view->size() * d->m_view->devicePixelRatio();
+    if (d->m_nativeSize != nativeSize) {
+        d->m_nativeSize = nativeSize;
+        d->m_fullDamage = true;
+    }
+
+    d->m_renderControl->polishItems();
+
+    auto const damage = d->collectDamage();
+    if (damage.isEmpty()) {
+        // Nothing painted changed. The scene graph is synced on the next update with damage.
+        return;
+    }
+
     if (usingGl) {
         if (!d->m_glcontext->makeCurrent(d->m_offscreenSurface.get())) {
             // probably a context loss event, kwin is about to reset all the effects anyway
+            d->m_fullDamage = true;
             return;
         }
 
-        const QSize nativeSize = d->m_view->size() * d->m_view->devicePixelRatio();
         if (!d->m_fbo || d->m_fbo->size() != nativeSize) {
             d->m_textureExport.reset(nullptr);
 
@@ -248,6 +294,7 @@ void OffscreenQuickView::update()
             d->m_fbo.reset(new QOpenGLFramebufferObject(nativeSize, fboFormat));
             if (!d->m_fbo->isValid()) {
                 d->m_fbo.reset();
+                d->m_fullDamage = true;
                 d->m_glcontext->doneCurrent();
                 return;
             }
@@ -256,7 +303,6 @@ void OffscreenQuickView::update()
             QQuickRenderTarget::fromOpenGLTexture(d->m_fbo->texture(), d->m_fbo->size()));
     }
 
-    d->m_renderControl->polishItems();
     d->m_renderControl->beginFrame();
     d->m_renderControl->sync();
     d->m_renderControl->render();
@@ -268,20 +314,27 @@ void OffscreenQuickView::update()
 
     if (d->m_useBlit) {
         if (usingGl) {
-            d->m_image = d->m_fbo->toImage();
-            d->m_image.setDevicePixelRatio(d->m_view->devicePixelRatio());
+            d->readBack(damage);
         } else {
             d->m_image = d->m_view->grabWindow();
         }
+        d->m_exportDamage += damage;
     }
 
     if (usingGl) {
         QOpenGLFramebufferObject::bindDefault();
         d->m_glcontext->doneCurrent();
     }
+
+    d->m_damage = damage;
     Q_EMIT repaintNeeded();
 }
 
+QRegion OffscreenQuickView::damage() const
+{
+    return d->m_damage;
+}
+
 void OffscreenQuickView::forwardMouseEvent(QEvent* e)
 {
     if (!d->m_visible) {
@@ -439,6 +492,8 @@ void OffscreenQuickView::setVisible(bool visible)
     d->m_visible = visible;
 
     if (visible) {
+        // The scene graph was released while hidden.
+        d->m_fullDamage = true;
         Q_EMIT d->m_renderControl->renderRequested();
     } else {
         // deferred to not change GL context
@@ -467,7 +522,17 @@ GLTexture* OffscreenQuickView::bufferAsTexture()
         if (d->m_image.isNull()) {
             return nullptr;
         }
-        d->m_textureExport.reset(new GLTexture(d->m_image));
+        if (!d->m_textureExport || d->m_textureExport->size() != d->m_image.size()) {
+            d->m_textureExport.reset(new GLTexture(d->m_image));
+        } else {
+            // Only upload what changed since the last call.
+            for (auto const& rect : d->m_exportDamage) {
+                auto const native
+                    = scaledRect(rect, d->m_image.devicePixelRatio()) & d->m_image.rect();
+                d->m_textureExport->update(d->m_image, native.topLeft(), native);
+            }
+        }
+        d->m_exportDamage = {};
     } else {
         if (!d->m_fbo) {
             return nullptr;
@@ -510,6 +575,112 @@ void OffscreenQuickView::Private::releaseResources()
     }
 }
 
+QRegion OffscreenQuickView::Private::collectDamage()
+{
+    QHash<QQuickItem*, QRect> rects;
+    rects.reserve(m_itemRects.size());
+
+    QRegion damage;
+    auto full = m_fullDamage;
+    collectItemDamage(m_view->contentItem(), false, false, rects, damage, full);
+
+    // Items removed from the scene or hidden since the last update.
+    for (auto it = m_itemRects.cbegin(); it != m_itemRects.cend(); ++it) {
+        if (!rects.contains(it.key())) {
+            damage += it.value();
+        }
+    }
+
+    m_itemRects = std::move(rects);
+    m_fullDamage = false;
+
+    QRect const viewRect({}, m_view->size());
+    return full ? QRegion(viewRect) : damage & viewRect;
+}
+
+void OffscreenQuickView::Private::collectItemDamage(QQuickItem* item,
+                                                    bool dirty,
+                                                    bool effectSource,
+                                                    QHash<QQuickItem*, QRect>& rects,
+                                                    QRegion& damage,
+                                                    bool& full) const
+{
+    if (!item->isVisible() || qFuzzyIsNull(item->opacity())) {
+        return;
+    }
+
+    auto item_d = QQuickItemPrivate::get(item);
+
+    // Added and removed children are found through their rects. Any other change of an item
+    // applies to its whole subtree.
+    dirty = dirty || (item_d->dirtyAttributes & ~QQuickItemPrivate::ChildrenChanged);
+    effectSource = effectSource || (item_d->extra.isAllocated() && item_d->extra->effectRefCount);
+
+    if (dirty && effectSource) {
+        // The item is shown through a shader effect elsewhere in the scene.
+        full = true;
+    }
+
+    if (item->flags() & QQuickItem::ItemHasContents) {
+        // Antialiased edges can reach into the next pixel.
+        auto const rect = item->mapRectToScene(item->boundingRect())
+                              .toAlignedRect()
+                              .adjusted(-1, -1, 1, 1);
+        rects.insert(item, rect);
+
+        auto const old = m_itemRects.constFind(item);
+        if (old == m_itemRects.cend()) {
+            damage += rect;
+        } else if (dirty || *old != rect) {
+            damage += *old;
+            damage += rect;
+        }
+    }
+
+    for (auto child : item->childItems()) {
+        collectItemDamage(child, dirty, effectSource, rects, damage, full);
+    }
+}
+
+void OffscreenQuickView::Private::readBack(QRegion const& region)
+{
+    auto const dpr = m_view->devicePixelRatio();
+
+    if (m_image.size() != m_fbo->size() || region == QRegion(QRect({}, m_view->size()))) {
+        m_image = m_fbo->toImage();
+        m_image.setDevicePixelRatio(dpr);
+        return;
+    }
+
+    // The framebuffer object can only be read back as a whole. Instead read the changed parts
+    // directly and patch them into the previous image.
+    m_fbo->bind();
+
+    auto const bytesPerPixel = m_image.depth() / 8;
+    for (auto const& rect : region) {
+        auto const native = scaledRect(rect, dpr) & m_image.rect();
+        if (native.isEmpty()) {
+            continue;
+        }
+
+        QImage part(native.size(), QImage::Format_RGBA8888_Premultiplied);
+        glReadPixels(native.x(),
+                     m_fbo->height() - native.y() - native.height(),
+                     native.width(),
+                     native.height(),
+                     GL_RGBA,
+                     GL_UNSIGNED_BYTE,
+                     part.bits());
+        part = part.mirrored().convertToFormat(m_image.format());
+
+        for (int y = 0; y < part.height(); y++) {
+            std::memcpy(m_image.scanLine(native.y() + y) + native.x() * bytesPerPixel,
+                        part.constScanLine(y),
+                        part.width() * bytesPerPixel);
+        }
+    }
+}
+
 void OffscreenQuickView::Private::updateTouchState(Qt::TouchPointState state,
                                                    qint32 id,
                                                    const QPointF& pos)
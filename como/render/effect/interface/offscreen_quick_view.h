@@ -9,6 +9,7 @@
 #include <como_export.h>
 
 #include <QObject>
+#include <QRegion>
 #include <memory>
 
 class QKeyEvent;
@@ -74,9 +75,17 @@ public:
      *
      * It can be manually invoked to update the contents immediately.
      * Note this will change the GL context
+     *
+     * Only when items of the scene changed since the last update the scene is rendered again.
      */
     void update();
 
+    /**
+     * The region of the view that changed with the last update, in view-local logical
+     * coordinates. Consumers should only repaint this region on repaintNeeded.
+     */
+    QRegion damage() const;
+
     /** The invisble root item of the window*/
     QQuickItem* contentItem() const;
     QQuickWindow* window() const;
@@ -185,7 +185,12 @@ void QuickSceneView::resetDirty()
 void QuickSceneView::scheduleRepaint()
 {
     markDirty();
-    effects->addRepaint(geometry());
+
+    // This repaint only drives a compositing cycle after which the view is updated. The actual
+    // changes are repainted once the view rendered them. Until then the region that changed last
+    // is the best guess.
+    auto const region = damage();
+    effects->addRepaint(region.isEmpty() ? geometry() : region.translated(geometry().topLeft()));
 }
 
 QuickSceneView* QuickSceneView::findView(QQuickItem* item)
@@ -455,6 +460,11 @@ bool QuickSceneEffect::isActive() const
     return !d->views.empty() && !effects->isScreenLocked();
 }
 
+bool QuickSceneEffect::blocksDirectScanout() const
+{
+    return true;
+}
+
 QVariantMap QuickSceneEffect::initialProperties(EffectScreen const* /*screen*/)
 {
     return QVariantMap();
@@ -485,9 +495,13 @@ void QuickSceneEffect::addScreen(EffectScreen const* screen)
                 if (view->contentItem()) {
                     view->contentItem()->setFocus(false);
                 }
-                connect(view.get(), &QuickSceneView::repaintNeeded, this, [screen]() {
-                    effects->addRepaint(screen->geometry());
-                });
+                connect(view.get(),
+                        &QuickSceneView::repaintNeeded,
+                        this,
+                        [view = view.get()]() {
+                            effects->addRepaint(
+                                view->damage().translated(view->geometry().topLeft()));
+                        });
                 connect(view.get(),
                         &QuickSceneView::renderRequested,
                         view.get(),
@@ -143,6 +143,7 @@ public:
     void paintScreen(effect::screen_paint_data& data) override;
     void postPaintScreen() override;
     bool isActive() const override;
+    bool blocksDirectScanout() const override;
 
     void windowInputMouseEvent(QEvent* event) override;
     void grabbedKeyboardEvent(QKeyEvent* keyEvent) override;
@@ -7,6 +7,14 @@
 
 #include <QMatrix4x4>
 #include <QtMath>
+#include <algorithm>
+
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define COMO_VERTEX_SIMD 1
+#include <immintrin.h>
+#else
+#define COMO_VERTEX_SIMD 0
+#endif
 
 namespace como
 {
@@ -103,7 +111,11 @@ double WindowQuad::originalBottom() const
 
 WindowQuad WindowQuad::makeSubQuad(double x1, double y1, double x2, double y2) const
 {
-    Q_ASSERT(x1 < x2 && y1 < y2 && x1 >= left() && x2 <= right() && y1 >= top() && y2 <= bottom());
+    // Grids split windows into thousands of quads. Compute the bounds only once per sub-quad.
+    auto const left = this->left();
+    auto const top = this->top();
+
+    Q_ASSERT(x1 < x2 && y1 < y2 && x1 >= left && x2 <= right() && y1 >= top && y2 <= bottom());
 #if !defined(QT_NO_DEBUG)
     if (isTransformed())
         qFatal("Splitting quads is allowed only in pre-paint calls!");
@@ -133,17 +145,17 @@ WindowQuad WindowQuad::makeSubQuad(double x1, double y1, double x2, double y2) c
     const double my_v0 = verts[0].ty;
     const double my_v1 = verts[2].ty;
 
-    const double width = right() - left();
-    const double height = bottom() - top();
+    const double width = right() - left;
+    const double height = bottom() - top;
 
     const double texWidth = my_u1 - my_u0;
     const double texHeight = my_v1 - my_v0;
 
     if (!uvAxisSwapped()) {
-        const double u0 = (x1 - left()) / width * texWidth + my_u0;
-        const double u1 = (x2 - left()) / width * texWidth + my_u0;
-        const double v0 = (y1 - top()) / height * texHeight + my_v0;
-        const double v1 = (y2 - top()) / height * texHeight + my_v0;
+        const double u0 = (x1 - left) / width * texWidth + my_u0;
+        const double u1 = (x2 - left) / width * texWidth + my_u0;
+        const double v0 = (y1 - top) / height * texHeight + my_v0;
+        const double v1 = (y2 - top) / height * texHeight + my_v0;
 
         ret.verts[0].tx = u0;
         ret.verts[3].tx = u0;
@@ -154,10 +166,10 @@ WindowQuad WindowQuad::makeSubQuad(double x1, double y1, double x2, double y2) c
         ret.verts[2].ty = v1;
         ret.verts[3].ty = v1;
     } else {
-        const double u0 = (y1 - top()) / height * texWidth + my_u0;
-        const double u1 = (y2 - top()) / height * texWidth + my_u0;
-        const double v0 = (x1 - left()) / width * texHeight + my_v0;
-        const double v1 = (x2 - left()) / width * texHeight + my_v0;
+        const double u0 = (y1 - top) / height * texWidth + my_u0;
+        const double u1 = (y2 - top) / height * texWidth + my_u0;
+        const double v0 = (x1 - left) / width * texHeight + my_v0;
+        const double v1 = (x2 - left) / width * texHeight + my_v0;
 
         ret.verts[0].tx = u0;
         ret.verts[1].tx = u0;
@@ -245,6 +257,42 @@ WindowQuadList WindowQuadList::splitAtY(double y) const
     return ret;
 }
 
+namespace
+{
+
+// Number of quads a grid with cells of the given size and origin splits the quads into.
+qsizetype get_grid_quad_count(WindowQuadList const& quads,
+                              double left,
+                              double top,
+                              double cell_width,
+                              double cell_height)
+{
+    qsizetype count{0};
+
+    for (auto const& quad : quads) {
+        auto const quad_left = quad.left();
+        auto const quad_top = quad.top();
+        auto const quad_width = quad.right() - quad_left;
+        auto const quad_height = quad.bottom() - quad_top;
+
+        if (quad_width == 0 || quad_height == 0) {
+            count++;
+            continue;
+        }
+
+        auto const x_begin = left + qFloor((quad_left - left) / cell_width) * cell_width;
+        auto const y_begin = top + qFloor((quad_top - top) / cell_height) * cell_height;
+
+        // Rounding errors of the increments in the splitting loops are covered by an extra cell.
+        count += static_cast<qsizetype>((quad_left + quad_width - x_begin) / cell_width + 1)
+            * static_cast<qsizetype>((quad_top + quad_height - y_begin) / cell_height + 1);
+    }
+
+    return count;
+}
+
+}
+
 WindowQuadList WindowQuadList::makeGrid(int maxQuadSize) const
 {
     if (empty())
@@ -268,6 +316,7 @@ WindowQuadList WindowQuadList::makeGrid(int maxQuadSize) const
     }
 
     WindowQuadList ret;
+    ret.reserve(get_grid_quad_count(*this, left, top, maxQuadSize, maxQuadSize));
 
     for (const WindowQuad& quad : *this) {
         const double quadLeft = quad.left();
@@ -328,6 +377,7 @@ WindowQuadList WindowQuadList::makeRegularGrid(int xSubdivisions, int ySubdivisi
     double yIncrement = (bottom - top) / ySubdivisions;
 
     WindowQuadList ret;
+    ret.reserve(get_grid_quad_count(*this, left, top, xIncrement, yIncrement));
 
     for (const WindowQuad& quad : *this) {
         const double quadLeft = quad.left();
@@ -370,60 +420,169 @@ WindowQuadList WindowQuadList::makeRegularGrid(int xSubdivisions, int ySubdivisi
 #define GL_QUADS 0x0007
 #endif
 
-void WindowQuadList::makeInterleavedArrays(unsigned int type,
-                                           std::span<GLVertex2D> vertices,
-                                           QMatrix4x4 const& textureMatrix) const
+namespace
 {
-    // Since we know that the texture matrix just scales and translates
-    // we can use this information to optimize the transformation
-    const QVector2D coeff(textureMatrix(0, 0), textureMatrix(1, 1));
-    const QVector2D offset(textureMatrix(0, 3), textureMatrix(1, 3));
 
-    size_t index = 0;
-    Q_ASSERT(type == GL_QUADS || type == GL_TRIANGLES);
+using vertex_kernel = void (*)(WindowQuadList const& quads,
+                               GLVertex2D* vertices,
+                               bool triangles,
+                               QVector2D const& coeff,
+                               QVector2D const& offset);
+
+#if !COMO_VERTEX_SIMD
 
-    switch (type) {
-    case GL_QUADS: {
-        for (const WindowQuad& quad : *this) {
+void make_vertices_scalar(WindowQuadList const& quads,
+                          GLVertex2D* vertices,
+                          bool triangles,
+                          QVector2D const& coeff,
+                          QVector2D const& offset)
+{
+    for (const WindowQuad& quad : quads) {
+        GLVertex2D v[4]; // Four unique vertices / quad
 #pragma GCC unroll 4
-            for (int j = 0; j < 4; j++) {
-                const WindowVertex& wv = quad[j];
+        for (int j = 0; j < 4; j++) {
+            const WindowVertex& wv = quad[j];
 
-                GLVertex2D v;
-                v.position = QVector2D(wv.x(), wv.y());
-                v.texcoord = QVector2D(wv.u(), wv.v()) * coeff + offset;
+            v[j].position = QVector2D(wv.x(), wv.y());
+            v[j].texcoord = QVector2D(wv.u(), wv.v()) * coeff + offset;
+        }
 
-                vertices[index++] = v;
-            }
+        if (!triangles) {
+            std::copy(v, v + 4, vertices);
+            vertices += 4;
+            continue;
         }
-        break;
+
+        // First triangle
+        *vertices++ = v[1]; // Top-right
+        *vertices++ = v[0]; // Top-left
+        *vertices++ = v[3]; // Bottom-left
+
+        // Second triangle
+        *vertices++ = v[3]; // Bottom-left
+        *vertices++ = v[2]; // Bottom-right
+        *vertices++ = v[1]; // Top-right
     }
-    case GL_TRIANGLES: {
-        for (const WindowQuad& quad : *this) {
-            GLVertex2D v[4]; // Four unique vertices / quad
-#pragma GCC unroll 4
-            for (int j = 0; j < 4; j++) {
-                const WindowVertex& wv = quad[j];
+}
 
-                v[j].position = QVector2D(wv.x(), wv.y());
-                v[j].texcoord = QVector2D(wv.u(), wv.v()) * coeff + offset;
-            }
+#else
+
+static_assert(sizeof(GLVertex2D) == 4 * sizeof(float));
+
+// Stores the vertices of a quad given as (x, y, u, v) registers. Returns the number of vertices.
+inline int store_quad(float* dst, __m128 const (&v)[4], bool triangles)
+{
+    if (!triangles) {
+        for (int j = 0; j < 4; j++) {
+            _mm_storeu_ps(dst + 4 * j, v[j]);
+        }
+        return 4;
+    }
+
+    // Same order as in the scalar kernel.
+    _mm_storeu_ps(dst, v[1]);
+    _mm_storeu_ps(dst + 4, v[0]);
+    _mm_storeu_ps(dst + 8, v[3]);
+    _mm_storeu_ps(dst + 12, v[3]);
+    _mm_storeu_ps(dst + 16, v[2]);
+    _mm_storeu_ps(dst + 20, v[1]);
+    return 6;
+}
+
+void make_vertices_sse2(WindowQuadList const& quads,
+                        GLVertex2D* vertices,
+                        bool triangles,
+                        QVector2D const& coeff,
+                        QVector2D const& offset)
+{
+    auto const tex_coeff = _mm_setr_ps(coeff.x(), coeff.y(), 0, 0);
+    auto const tex_offset = _mm_setr_ps(offset.x(), offset.y(), 0, 0);
+    auto dst = reinterpret_cast<float*>(vertices);
+
+    for (auto const& quad : quads) {
+        __m128 v[4];
+
+        for (int j = 0; j < 4; j++) {
+            auto const& wv = quad[j];
+            auto const pos = _mm_cvtpd_ps(_mm_set_pd(wv.y(), wv.x()));
+            auto const tex = _mm_cvtpd_ps(_mm_set_pd(wv.v(), wv.u()));
+            v[j] = _mm_movelh_ps(pos, _mm_add_ps(_mm_mul_ps(tex, tex_coeff), tex_offset));
+        }
+
+        dst += 4 * store_quad(dst, v, triangles);
+    }
+}
 
-            // First triangle
-            vertices[index++] = v[1]; // Top-right
-            vertices[index++] = v[0]; // Top-left
-            vertices[index++] = v[3]; // Bottom-left
+// Converts the doubles of two vertices at once.
+__attribute__((target("avx"))) void make_vertices_avx(WindowQuadList const& quads,
+                                                      GLVertex2D* vertices,
+                                                      bool triangles,
+                                                      QVector2D const& coeff,
+                                                      QVector2D const& offset)
+{
+    auto const tex_coeff = _mm_setr_ps(coeff.x(), coeff.y(), coeff.x(), coeff.y());
+    auto const tex_offset = _mm_setr_ps(offset.x(), offset.y(), offset.x(), offset.y());
+    auto dst = reinterpret_cast<float*>(vertices);
+
+    for (auto const& quad : quads) {
+        __m128 v[4];
+
+        for (int j = 0; j < 4; j += 2) {
+            auto const& first = quad[j];
+            auto const& second = quad[j + 1];
 
-            // Second triangle
-            vertices[index++] = v[3]; // Bottom-left
-            vertices[index++] = v[2]; // Bottom-right
-            vertices[index++] = v[1]; // Top-right
+            auto const pos = _mm256_cvtpd_ps(
+                _mm256_set_pd(second.y(), second.x(), first.y(), first.x()));
+            auto tex = _mm256_cvtpd_ps(
+                _mm256_set_pd(second.v(), second.u(), first.v(), first.u()));
+            tex = _mm_add_ps(_mm_mul_ps(tex, tex_coeff), tex_offset);
+
+            v[j] = _mm_movelh_ps(pos, tex);
+            v[j + 1] = _mm_movehl_ps(tex, pos);
         }
-        break;
+
+        dst += 4 * store_quad(dst, v, triangles);
     }
-    default:
-        break;
+}
+
+#endif
+
+vertex_kernel get_vertex_kernel()
+{
+#if COMO_VERTEX_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        return make_vertices_avx;
     }
+    return make_vertices_sse2;
+#else
+    return make_vertices_scalar;
+#endif
+}
+
+}
+
+void WindowQuadList::makeInterleavedArrays(unsigned int type,
+                                           std::span<GLVertex2D> vertices,
+                                           QMatrix4x4 const& textureMatrix) const
+{
+    // Selected once by the features of the CPU we run on.
+    static auto const kernel = get_vertex_kernel();
+
+    // Since we know that the texture matrix just scales and translates
+    // we can use this information to optimize the transformation
+    const QVector2D coeff(textureMatrix(0, 0), textureMatrix(1, 1));
+    const QVector2D offset(textureMatrix(0, 3), textureMatrix(1, 3));
+
+    Q_ASSERT(type == GL_QUADS || type == GL_TRIANGLES);
+    if (type != GL_QUADS && type != GL_TRIANGLES) {
+        return;
+    }
+
+    auto const triangles = type == GL_TRIANGLES;
+    Q_ASSERT(vertices.size() >= static_cast<size_t>(count()) * (triangles ? 6 : 4));
+
+    kernel(*this, vertices.data(), triangles, coeff, offset);
 }
 
 void WindowQuadList::makeArrays(float** vertices,
@@ -23,6 +23,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <como/render/gl/interface/platform.h>
 
 #include <KDecoration2/DecorationSettings>
+#include <algorithm>
 
 namespace como::render
 {
@@ -503,6 +504,13 @@ QStringList effects_handler_wrap::activeEffects() const
     return ret;
 }
 
+bool effects_handler_wrap::blocks_direct_scanout() const
+{
+    return std::any_of(loaded_effects.cbegin(), loaded_effects.cend(), [](auto const& effect) {
+        return effect.second->isActive() && effect.second->blocksDirectScanout();
+    });
+}
+
 Wrapland::Server::Display* effects_handler_wrap::waylandDisplay() const
 {
     return nullptr;
@@ -147,6 +147,15 @@ public:
     QList<EffectWindow*> elevatedWindows() const;
     QStringList activeEffects() const;
 
+    /// Whether an active effect requires the scene to be composited on all outputs.
+    bool blocks_direct_scanout() const;
+
+    /// Whether effects take part in the current paint pass.
+    bool has_active_effects() const
+    {
+        return !m_activeEffects.isEmpty();
+    }
+
     Wrapland::Server::Display* waylandDisplay() const override;
 
     bool touchDown(qint32 id, const QPointF& pos, quint32 time);
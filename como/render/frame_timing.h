@@ -0,0 +1,199 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QString>
+#include <QTextStream>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace como::render
+{
+
+/**
+ * Ring buffer of the most recent durations.
+ *
+ * Samples are written by a single producer (the output's render loop). Readers may run on any
+ * thread and get the last written samples without taking a lock.
+ */
+template<size_t Capacity = 128>
+class duration_ring
+{
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+    static constexpr size_t capacity{Capacity};
+
+    void add(std::chrono::nanoseconds duration)
+    {
+        auto const pos = head.load(std::memory_order_relaxed);
+        samples[pos & (Capacity - 1)].store(duration.count(), std::memory_order_relaxed);
+        head.store(pos + 1, std::memory_order_release);
+    }
+
+    /// Number of samples currently held.
+    size_t size() const
+    {
+        return std::min<uint64_t>(head.load(std::memory_order_acquire), Capacity);
+    }
+
+    /// Number of samples added since creation.
+    uint64_t total() const
+    {
+        return head.load(std::memory_order_acquire);
+    }
+
+    std::vector<std::chrono::nanoseconds> snapshot() const
+    {
+        auto const end = head.load(std::memory_order_acquire);
+        auto const count = std::min<uint64_t>(end, Capacity);
+
+        std::vector<std::chrono::nanoseconds> ret;
+        ret.reserve(count);
+
+        for (auto pos = end - count; pos < end; pos++) {
+            ret.emplace_back(samples[pos & (Capacity - 1)].load(std::memory_order_relaxed));
+        }
+        return ret;
+    }
+
+    std::chrono::nanoseconds max() const
+    {
+        auto const count = size();
+
+        std::chrono::nanoseconds::rep ret{0};
+        for (size_t i = 0; i < count; i++) {
+            ret = std::max(ret, samples[i].load(std::memory_order_relaxed));
+        }
+        return std::chrono::nanoseconds(ret);
+    }
+
+    /**
+     * Returns the value below which @p percentile percent of the held samples fall. With no
+     * samples held zero is returned.
+     */
+    std::chrono::nanoseconds percentile(double percentile) const
+    {
+        auto const count = size();
+        if (!count) {
+            return {};
+        }
+
+        // Called on every frame by the repaint scheduling. So we select on the stack.
+        std::array<std::chrono::nanoseconds::rep, Capacity> values;
+        for (size_t i = 0; i < count; i++) {
+            values[i] = samples[i].load(std::memory_order_relaxed);
+        }
+
+        auto const rank = std::clamp(percentile, 0., 100.) / 100. * (count - 1);
+        auto nth = values.begin() + static_cast<size_t>(rank + 0.5);
+        std::nth_element(values.begin(), nth, values.begin() + count);
+        return std::chrono::nanoseconds(*nth);
+    }
+
+private:
+    std::array<std::atomic<std::chrono::nanoseconds::rep>, Capacity> samples{};
+    std::atomic<uint64_t> head{0};
+};
+
+struct duration_stats {
+    size_t count{0};
+    std::chrono::nanoseconds min{0};
+    std::chrono::nanoseconds mean{0};
+    std::chrono::nanoseconds p50{0};
+    std::chrono::nanoseconds p90{0};
+    std::chrono::nanoseconds p95{0};
+    std::chrono::nanoseconds p99{0};
+    std::chrono::nanoseconds max{0};
+};
+
+template<size_t Capacity>
+duration_stats get_duration_stats(duration_ring<Capacity> const& ring)
+{
+    auto values = ring.snapshot();
+    if (values.empty()) {
+        return {};
+    }
+
+    std::sort(values.begin(), values.end());
+
+    auto at = [&values](double percentile) {
+        return values.at(static_cast<size_t>(percentile / 100. * (values.size() - 1) + 0.5));
+    };
+
+    std::chrono::nanoseconds sum{0};
+    for (auto val : values) {
+        sum += val;
+    }
+
+    duration_stats stats;
+    stats.count = values.size();
+    stats.min = values.front();
+    stats.mean = sum / static_cast<int64_t>(values.size());
+    stats.p50 = at(50);
+    stats.p90 = at(90);
+    stats.p95 = at(95);
+    stats.p99 = at(99);
+    stats.max = values.back();
+    return stats;
+}
+
+/**
+ * Timings of the most recent frames on an output.
+ */
+struct frame_timing {
+    /// CPU time spent in painting the scene.
+    duration_ring<> paint;
+    /// GPU time spent in rendering as reported by timer queries.
+    duration_ring<> render;
+    /// Difference between when the delay timer fired and when it was supposed to fire.
+    duration_ring<> slack;
+    /// Intervals between subsequent presentations on the display.
+    duration_ring<> present_interval;
+
+    /// Frames presented at the targeted vblank.
+    std::atomic<uint64_t> hit_frames{0};
+    /// Frames presented at a later vblank than targeted.
+    std::atomic<uint64_t> missed_frames{0};
+    /// Frames shown by direct scanout of a window buffer instead of compositing.
+    std::atomic<uint64_t> scanout_frames{0};
+};
+
+inline void print_duration_stats(QTextStream& stream, char const* name, duration_stats const& stats)
+{
+    auto to_ms = [](std::chrono::nanoseconds val) {
+        return QString::number(std::chrono::duration<double, std::milli>(val).count(), 'f', 3);
+    };
+
+    stream << "  " << name << ": count " << stats.count << " min " << to_ms(stats.min) << " mean "
+           << to_ms(stats.mean) << " p50 " << to_ms(stats.p50) << " p90 " << to_ms(stats.p90)
+           << " p95 " << to_ms(stats.p95) << " p99 " << to_ms(stats.p99) << " max "
+           << to_ms(stats.max) << " (ms)\n";
+}
+
+inline QString frame_timing_report(QString const& output_name, frame_timing const& timing)
+{
+    QString ret;
+    QTextStream stream(&ret);
+
+    stream << "Output " << output_name << ":\n";
+    print_duration_stats(stream, "paint", get_duration_stats(timing.paint));
+    print_duration_stats(stream, "render", get_duration_stats(timing.render));
+    print_duration_stats(stream, "slack", get_duration_stats(timing.slack));
+    print_duration_stats(stream, "present interval", get_duration_stats(timing.present_interval));
+    stream << "  frames: hit " << timing.hit_frames.load() << " missed "
+           << timing.missed_frames.load() << " scanout " << timing.scanout_frames.load() << "\n";
+
+    return ret;
+}
+
+}
@@ -0,0 +1,310 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/render/gl/interface/framebuffer.h>
+#include <como/render/gl/interface/texture.h>
+#include <como/render/gl/interface/utils.h>
+
+#include <QRect>
+#include <QSize>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace como::render::gl
+{
+
+/**
+ * Texture shared by the decorations of all windows. Decorations get a rectangle of it assigned
+ * through shelf packing: the atlas is split into rows of similar height which are filled from left
+ * to right. Freed rectangles are merged with free neighbours and reused by later allocations.
+ * Empty shelves are merged with empty neighbour shelves and split again for shelves of any height.
+ *
+ * When the atlas is full it grows and the content is copied over. Replaced textures are kept alive
+ * until the next frame, so windows already drawn with them in the current frame stay valid.
+ */
+class deco_atlas
+{
+public:
+    /// Returns an empty rect when the atlas can not provide the requested size.
+    QRect allocate(QSize const& size)
+    {
+        if (size.isEmpty()) {
+            return {};
+        }
+
+        if (!m_texture && !resize(initial_size.expandedTo(size))) {
+            return {};
+        }
+
+        if (auto rect = allocate_in_shelves(size); !rect.isEmpty()) {
+            return rect;
+        }
+
+        // The atlas is full. Double its size until the new shelf fits.
+        auto new_size = m_texture->size();
+        auto const needed_height = shelves_height() + align(size.height(), shelf_alignment);
+        while (new_size.width() < size.width() || new_size.height() < needed_height) {
+            new_size = QSize(new_size.width() < size.width() ? new_size.width() * 2
+                                                              : new_size.width(),
+                             new_size.height() < needed_height ? new_size.height() * 2
+                                                               : new_size.height());
+        }
+
+        if (!resize(new_size)) {
+            return {};
+        }
+        return allocate_in_shelves(size);
+    }
+
+    void free(QRect const& rect)
+    {
+        auto shelf_it = std::find_if(
+            shelves.begin(), shelves.end(), [&](auto const& shelf) { return shelf.y == rect.y(); });
+        if (shelf_it == shelves.end()) {
+            return;
+        }
+
+        auto& slots = shelf_it->slots;
+        auto slot_it = std::find_if(
+            slots.begin(), slots.end(), [&](auto const& slot) { return slot.x == rect.x(); });
+        if (slot_it == slots.end()) {
+            return;
+        }
+
+        slot_it->used = false;
+
+        if (auto next = std::next(slot_it); next != slots.end() && !next->used) {
+            slot_it->width += next->width;
+            slot_it = std::prev(slots.erase(next));
+        }
+        if (slot_it != slots.begin()) {
+            if (auto prev = std::prev(slot_it); !prev->used) {
+                prev->width += slot_it->width;
+                slots.erase(slot_it);
+            }
+        }
+
+        if (is_empty(*shelf_it)) {
+            if (auto next = std::next(shelf_it); next != shelves.end() && is_empty(*next)) {
+                shelf_it->height += next->height;
+                shelf_it = std::prev(shelves.erase(next));
+            }
+            if (shelf_it != shelves.begin()) {
+                if (auto prev = std::prev(shelf_it); is_empty(*prev)) {
+                    prev->height += shelf_it->height;
+                    shelves.erase(shelf_it);
+                }
+            }
+        }
+
+        // An empty shelf at the bottom is removed, so the atlas can grow below the last used one.
+        if (!shelves.empty() && is_empty(shelves.back())) {
+            shelves.pop_back();
+        }
+    }
+
+    GLTexture* texture() const
+    {
+        return m_texture.get();
+    }
+
+    /// Must be called at the beginning of a frame.
+    void release_retired()
+    {
+        retired.clear();
+    }
+
+    /// Releases all GL resources. The GL context must be current.
+    void clear()
+    {
+        shelves.clear();
+        retired.clear();
+        m_texture.reset();
+    }
+
+private:
+    struct slot {
+        int x;
+        int width;
+        bool used;
+    };
+
+    struct shelf {
+        int y;
+        int height;
+        std::vector<slot> slots;
+    };
+
+    static int align(int value, int align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    static bool is_empty(shelf const& shelf)
+    {
+        return shelf.slots.size() == 1 && !shelf.slots.front().used;
+    }
+
+    int shelves_height() const
+    {
+        return shelves.empty() ? 0 : shelves.back().y + shelves.back().height;
+    }
+
+    QRect allocate_in_shelves(QSize const& size)
+    {
+        // Best fit: the shelf with the least height wasted that has a wide enough free slot.
+        shelf* best_shelf{nullptr};
+        std::vector<slot>::iterator best_slot;
+
+        for (auto& shelf : shelves) {
+            if (shelf.height < size.height() || shelf.height > size.height() * 2) {
+                continue;
+            }
+            if (best_shelf && best_shelf->height <= shelf.height) {
+                continue;
+            }
+            auto slot_it = std::find_if(shelf.slots.begin(), shelf.slots.end(), [&](auto& slot) {
+                return !slot.used && slot.width >= size.width();
+            });
+            if (slot_it != shelf.slots.end()) {
+                best_shelf = &shelf;
+                best_slot = slot_it;
+            }
+        }
+
+        if (!best_shelf) {
+            best_shelf = add_shelf(size);
+            if (!best_shelf) {
+                return {};
+            }
+            best_slot = best_shelf->slots.begin();
+        }
+
+        QRect const rect(best_slot->x, best_shelf->y, size.width(), size.height());
+
+        if (best_slot->width > size.width()) {
+            best_shelf->slots.insert(
+                std::next(best_slot),
+                {best_slot->x + size.width(), best_slot->width - size.width(), false});
+        }
+
+        // The insertion may have invalidated the iterator.
+        auto& allocated = *std::find_if(best_shelf->slots.begin(),
+                                        best_shelf->slots.end(),
+                                        [&](auto const& slot) { return slot.x == rect.x(); });
+        allocated.width = size.width();
+        allocated.used = true;
+
+        return rect;
+    }
+
+    /// Returns nullptr when there is no space left for a shelf fitting @p size.
+    shelf* add_shelf(QSize const& size)
+    {
+        auto const height = align(size.height(), shelf_alignment);
+        if (size.width() > m_texture->width()) {
+            return nullptr;
+        }
+
+        // Reuse the smallest empty shelf that is high enough. The rest of it stays empty.
+        auto empty = shelves.end();
+        for (auto it = shelves.begin(); it != shelves.end(); it++) {
+            if (is_empty(*it) && it->height >= height
+                && (empty == shelves.end() || it->height < empty->height)) {
+                empty = it;
+            }
+        }
+
+        if (empty != shelves.end()) {
+            if (auto const rest = empty->height - height; rest > 0) {
+                empty->height = height;
+                empty = std::prev(shelves.insert(
+                    std::next(empty),
+                    {empty->y + height, rest, {{0, m_texture->width(), false}}}));
+            }
+            return &*empty;
+        }
+
+        auto const y = shelves_height();
+        if (y + height > m_texture->height()) {
+            return nullptr;
+        }
+        shelves.push_back({y, height, {{0, m_texture->width(), false}}});
+        return &shelves.back();
+    }
+
+    bool resize(QSize const& size)
+    {
+        GLint max_size{0};
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+
+        auto const new_size = size.boundedTo(QSize(max_size, max_size));
+        if (new_size.width() < size.width() || new_size.height() < size.height()) {
+            return false;
+        }
+        if (m_texture && !GLFramebuffer::supported()) {
+            // The content can not be copied over.
+            return false;
+        }
+
+        auto texture = std::make_unique<GLTexture>(GL_RGBA8, new_size);
+        texture->set_content_transform(effect::transform_type::flipped_180);
+        texture->setWrapMode(GL_CLAMP_TO_EDGE);
+        texture->clear();
+
+        if (m_texture) {
+            copy(*m_texture, *texture);
+
+            // Shelves extend to the new width.
+            if (auto const added = new_size.width() - m_texture->width(); added > 0) {
+                for (auto& shelf : shelves) {
+                    if (auto& last = shelf.slots.back(); last.used) {
+                        shelf.slots.push_back({m_texture->width(), added, false});
+                    } else {
+                        last.width += added;
+                    }
+                }
+            }
+
+            retired.push_back(std::move(m_texture));
+        }
+
+        m_texture = std::move(texture);
+        return true;
+    }
+
+    static void copy(GLTexture& source, GLTexture& target)
+    {
+        GLint prev_fbo{0};
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prev_fbo);
+
+        GLuint fbo{0};
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, source.target(), source.texture(), 0);
+
+        target.bind();
+        glCopyTexSubImage2D(target.target(), 0, 0, 0, 0, 0, source.width(), source.height());
+        target.unbind();
+
+        glBindFramebuffer(GL_FRAMEBUFFER, prev_fbo);
+        glDeleteFramebuffers(1, &fbo);
+    }
+
+    static constexpr QSize initial_size{2048, 512};
+
+    // Shelf heights are aligned, so decorations with slightly different heights share shelves.
+    static constexpr int shelf_alignment{8};
+
+    std::vector<shelf> shelves;
+    std::unique_ptr<GLTexture> m_texture;
+    std::vector<std::unique_ptr<GLTexture>> retired;
+};
+
+}
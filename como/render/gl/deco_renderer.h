@@ -7,6 +7,8 @@
 */
 #pragma once
 
+#include "deco_atlas.h"
+
 #include <como/win/deco/renderer.h>
 
 // Must be included before.
@@ -56,9 +58,35 @@ public:
     ~deco_render_data() override
     {
         scene.makeOpenGLContextCurrent();
+        release();
+    }
+
+    /// Usually the atlas shared by all decorations.
+    GLTexture* texture() const
+    {
+        return atlas_rect.isEmpty() ? own_texture.get() : scene.decoration_atlas.texture();
+    }
+
+    /// Position of the decoration in the texture in device pixels.
+    QPoint texture_offset() const
+    {
+        return atlas_rect.topLeft();
+    }
+
+    void release()
+    {
+        if (!atlas_rect.isEmpty()) {
+            scene.decoration_atlas.free(atlas_rect);
+            atlas_rect = {};
+        }
+        own_texture.reset();
     }
 
-    std::unique_ptr<GLTexture> texture;
+    // Empty when the decoration is not in the atlas.
+    QRect atlas_rect;
+
+    // Only used when the atlas can not hold the decoration.
+    std::unique_ptr<GLTexture> own_texture;
 
 private:
     Scene& scene;
@@ -87,7 +115,8 @@ public:
             this->image_size_dirty = false;
         }
 
-        if (!get_data().texture) {
+        auto& data = get_data();
+        if (!data.texture()) {
             // for invalid sizes we get no texture, see BUG 361551
             return;
         }
@@ -101,10 +130,10 @@ public:
         // We pad each part in the decoration atlas in order to avoid texture bleeding.
         const int padding = 1;
 
-        auto renderPart = [=, this](const QRect& geo,
-                                    const QRect& partRect,
-                                    const QPoint& position,
-                                    bool rotated = false) {
+        auto renderPart = [=, this, &data](const QRect& geo,
+                                           const QRect& partRect,
+                                           const QPoint& position,
+                                           bool rotated = false) {
             if (!geo.isValid()) {
                 return;
             }
@@ -157,8 +186,10 @@ public:
             }
 
             const QPoint dirtyOffset = geo.topLeft() - partRect.topLeft();
-            get_data().texture->update(
-                image, (position + dirtyOffset - viewport.topLeft()) * image.devicePixelRatio());
+            data.texture()->update(image,
+                                   data.texture_offset()
+                                       + (position + dirtyOffset - viewport.topLeft())
+                                           * image.devicePixelRatio());
         };
 
         const QPoint topPosition(padding, padding);
@@ -172,17 +203,13 @@ public:
         renderPart(bottom.intersected(geometry), bottom, bottomPosition);
     }
 
-    GLTexture* texture()
-    {
-        return get_data().texture.get();
-    }
     GLTexture* texture() const
     {
-        return get_data().texture.get();
+        return get_data().texture();
     }
 
 private:
-    deco_render_data<Scene>& get_data()
+    deco_render_data<Scene>& get_data() const
     {
         return static_cast<deco_render_data<Scene>&>(*this->data);
     }
@@ -256,19 +283,33 @@ private:
 
         auto& data = get_data();
 
-        if (data.texture && data.texture->size() == size) {
+        if (size.isEmpty()) {
+            data.release();
             return;
         }
 
-        if (size.isEmpty()) {
-            data.texture.reset();
+        // While resizing interactively the allocation is kept as long as the decoration fits and
+        // does not waste most of it in either dimension.
+        if (auto const& rect = data.atlas_rect; !rect.isEmpty() && size.width() <= rect.width()
+            && size.height() <= rect.height() && size.width() * 2 > rect.width()
+            && size.height() * 2 > rect.height()) {
+            return;
+        }
+        if (data.own_texture && data.own_texture->size() == size) {
+            return;
+        }
+
+        data.release();
+
+        data.atlas_rect = scene.decoration_atlas.allocate(size);
+        if (!data.atlas_rect.isEmpty()) {
             return;
         }
 
-        data.texture = std::make_unique<GLTexture>(GL_RGBA8, size.width(), size.height());
-        data.texture->set_content_transform(effect::transform_type::flipped_180);
-        data.texture->setWrapMode(GL_CLAMP_TO_EDGE);
-        data.texture->clear();
+        data.own_texture = std::make_unique<GLTexture>(GL_RGBA8, size.width(), size.height());
+        data.own_texture->set_content_transform(effect::transform_type::flipped_180);
+        data.own_texture->setWrapMode(GL_CLAMP_TO_EDGE);
+        data.own_texture->clear();
     }
 
     Scene& scene;
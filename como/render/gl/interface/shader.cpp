@@ -174,6 +174,37 @@ bool GLShader::load(const QByteArray& vertexSource, const QByteArray& fragmentSo
     return link();
 }
 
+bool GLShader::loadBinary(GLenum format, const QByteArray& binary)
+{
+    glProgramBinary(mProgram, format, binary.constData(), binary.size());
+
+    int status;
+    glGetProgramiv(mProgram, GL_LINK_STATUS, &status);
+    mValid = status != 0;
+
+    return mValid;
+}
+
+void GLShader::setBinaryRetrievable()
+{
+    glProgramParameteri(mProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+QByteArray GLShader::binary(GLenum& format) const
+{
+    int length = 0;
+    glGetProgramiv(mProgram, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return {};
+    }
+
+    QByteArray binary(length, Qt::Uninitialized);
+    glGetProgramBinary(mProgram, length, &length, &format, binary.data());
+    binary.resize(length);
+
+    return binary;
+}
+
 void GLShader::bindAttributeLocation(const char* name, int index)
 {
     glBindAttribLocation(mProgram, index, name);
@@ -103,6 +103,16 @@ protected:
     bool load(const QByteArray& vertexSource, const QByteArray& fragmentSource);
     const QByteArray prepareSource(GLenum shaderType, const QByteArray& sourceCode) const;
     bool compile(GLuint program, GLenum shaderType, const QByteArray& sourceCode) const;
+    /**
+     * Loads a program binary previously retrieved with binary() instead of compiling and linking
+     * the sources. Sets the shader valid when the driver accepted the binary.
+     */
+    bool loadBinary(GLenum format, const QByteArray& binary);
+    /**
+     * Must be called before linking to be able to retrieve the binary afterwards.
+     */
+    void setBinaryRetrievable();
+    QByteArray binary(GLenum& format) const;
     void bind();
     void unbind();
     void resolveLocations();
@@ -0,0 +1,161 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "shader_cache.h"
+
+#include "platform.h"
+
+#include <como/base/config-como.h>
+#include <como/base/logging.h>
+#include <como/render/gl/interface/utils.h>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace como
+{
+
+namespace
+{
+
+constexpr quint32 file_magic = 0x43534842;
+constexpr quint32 file_version = 1;
+
+// Marks the subdirectories owned by the cache. Only these are pruned.
+constexpr char directory_prefix[] = "programs-";
+
+}
+
+ShaderCache::ShaderCache(QString const& directory)
+{
+    auto gl = GLPlatform::instance();
+
+    m_driver = gl->glVendorString() + '\n' + gl->glRendererString() + '\n'
+        + gl->glVersionString() + '\n' + QByteArray::number(gl->driverVersion());
+
+    // Shader sources change between versions, so cached programs of other versions are stale too.
+    auto const hash = QCryptographicHash::hash(m_driver + '\n' + COMO_VERSION_STRING,
+                                               QCryptographicHash::Sha256);
+    auto const name = QString::fromLatin1(directory_prefix + hash.toHex().left(16));
+
+    m_directory = directory + QLatin1Char('/') + name;
+    prune(directory, name);
+}
+
+bool ShaderCache::isSupported()
+{
+    if (GLPlatform::instance()->isGLES()) {
+        if (!hasGLVersion(3, 0)) {
+            return false;
+        }
+    } else if (!hasGLVersion(4, 1)
+               && !hasGLExtension(QByteArrayLiteral("GL_ARB_get_program_binary"))) {
+        return false;
+    }
+
+    // Drivers may support the API without supporting any binary format.
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+QByteArray ShaderCache::key(QByteArray const& vertexSource,
+                            QByteArray const& fragmentSource,
+                            QByteArray const& locations) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+
+    for (auto const& part : {m_driver, vertexSource, fragmentSource, locations}) {
+        // The size separates the parts, so different splits of the same bytes differ.
+        hash.addData(QByteArray::number(part.size()) + ':');
+        hash.addData(part);
+    }
+
+    return hash.result().toHex();
+}
+
+std::optional<ShaderCache::Binary> ShaderCache::read(QByteArray const& key) const
+{
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    QDataStream stream(&file);
+    quint32 magic;
+    quint32 version;
+    quint32 format;
+    QByteArray data;
+    stream >> magic >> version >> format >> data;
+
+    if (stream.status() != QDataStream::Ok || magic != file_magic || version != file_version
+        || data.isEmpty()) {
+        return {};
+    }
+
+    return Binary{format, data};
+}
+
+void ShaderCache::write(QByteArray const& key, Binary const& binary) const
+{
+    if (!QDir().mkpath(m_directory)) {
+        qCWarning(KWIN_CORE) << "Failed to create shader cache directory" << m_directory;
+        return;
+    }
+
+    // Written atomically so that concurrent sessions never read a partial program.
+    QSaveFile file(filePath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KWIN_CORE) << "Failed to write shader cache file" << file.fileName();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << file_magic << file_version << static_cast<quint32>(binary.format) << binary.data;
+
+    if (!file.commit()) {
+        qCWarning(KWIN_CORE) << "Failed to write shader cache file" << file.fileName();
+    }
+}
+
+void ShaderCache::remove(QByteArray const& key) const
+{
+    QFile::remove(filePath(key));
+}
+
+QString ShaderCache::directory() const
+{
+    return m_directory;
+}
+
+void ShaderCache::prune(QString const& directory, QString const& current) const
+{
+    auto const entries = QDir(directory).entryInfoList(
+        {QString::fromLatin1(directory_prefix) + QLatin1Char('*')},
+        QDir::Dirs | QDir::NoDotAndDotDot);
+
+    for (auto const& entry : entries) {
+        if (entry.fileName() == current) {
+            continue;
+        }
+
+        qCDebug(KWIN_CORE) << "Removing stale shader cache entry" << entry.filePath();
+
+        if (!QDir(entry.filePath()).removeRecursively()) {
+            qCWarning(KWIN_CORE) << "Failed to remove stale shader cache entry" << entry.filePath();
+        }
+    }
+}
+
+QString ShaderCache::filePath(QByteArray const& key) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(key);
+}
+
+}
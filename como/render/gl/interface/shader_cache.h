@@ -0,0 +1,61 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/render/gl/interface/utils_funcs.h>
+
+#include <QByteArray>
+#include <QString>
+#include <optional>
+
+namespace como
+{
+
+/**
+ * @short On-disk cache of linked shader program binaries.
+ *
+ * Programs are identified by the driver they were linked with and the sources and locations they
+ * were built from. They are stored in a subdirectory per driver and compositor version. On
+ * construction the subdirectories of other drivers and versions are removed, so their programs do
+ * not pile up. Other entries of the cache directory are left alone.
+ *
+ * @internal
+ */
+class ShaderCache
+{
+public:
+    struct Binary {
+        GLenum format;
+        QByteArray data;
+    };
+
+    explicit ShaderCache(QString const& directory);
+
+    /**
+     * @return Whether the current context can retrieve and load program binaries.
+     */
+    static bool isSupported();
+
+    QByteArray key(QByteArray const& vertexSource,
+                   QByteArray const& fragmentSource,
+                   QByteArray const& locations) const;
+
+    std::optional<Binary> read(QByteArray const& key) const;
+    void write(QByteArray const& key, Binary const& binary) const;
+    void remove(QByteArray const& key) const;
+
+    /// The subdirectory of the current driver and version.
+    QString directory() const;
+
+private:
+    void prune(QString const& directory, QString const& current) const;
+    QString filePath(QByteArray const& key) const;
+
+    QString m_directory;
+    QByteArray m_driver;
+};
+
+}
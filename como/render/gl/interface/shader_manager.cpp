@@ -8,6 +8,7 @@
 #include "shader_manager.h"
 
 #include "platform.h"
+#include "shader_cache.h"
 
 #include <como/base/logging.h>
 #include <como/render/effect/interface/paint_data.h>
@@ -15,7 +16,9 @@
 #include <como/render/gl/interface/shader.h>
 #include <como/render/gl/interface/vertex_buffer.h>
 
+#include <QElapsedTimer>
 #include <QFile>
+#include <QStandardPaths>
 
 namespace como
 {
@@ -37,6 +40,8 @@ void ShaderManager::cleanup()
 }
 
 ShaderManager::ShaderManager()
+    : m_cacheDirectory(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                       + QStringLiteral("/como/shaders"))
 {
 }
 
@@ -187,17 +192,100 @@ std::unique_ptr<GLShader> ShaderManager::generateCustomShader(ShaderTraits trait
     qCDebug(KWIN_CORE) << "**************";
 #endif
 
+    return createShader(vertex, fragment, true);
+}
+
+std::unique_ptr<GLShader> ShaderManager::createShader(const QByteArray& vertexSource,
+                                                      const QByteArray& fragmentSource,
+                                                      bool generic)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto cache = this->cache();
+    QByteArray key;
+
+    if (cache) {
+        // Generic and custom shaders bind different attribute names.
+        key = cache->key(vertexSource, fragmentSource, generic ? "generic" : "custom");
+
+        if (auto binary = cache->read(key)) {
+            std::unique_ptr<GLShader> shader{new GLShader(GLShader::ExplicitLinking)};
+            if (shader->loadBinary(binary->format, binary->data)) {
+                qCDebug(KWIN_CORE) << "Loaded cached shader program in"
+                                   << timer.nsecsElapsed() / 1000 << "us";
+                return shader;
+            }
+
+            // The driver changed without changing its identification.
+            cache->remove(key);
+        }
+    }
+
     std::unique_ptr<GLShader> shader{new GLShader(GLShader::ExplicitLinking)};
-    shader->load(vertex, fragment);
+    shader->load(vertexSource, fragmentSource);
 
-    shader->bindAttributeLocation("position", VA_Position);
-    shader->bindAttributeLocation("texcoord", VA_TexCoord);
-    shader->bindFragDataLocation("fragColor", 0);
+    if (generic) {
+        shader->bindAttributeLocation("position", VA_Position);
+        shader->bindAttributeLocation("texcoord", VA_TexCoord);
+    } else {
+        bindAttributeLocations(shader.get());
+    }
+    bindFragDataLocations(shader.get());
+
+    if (cache) {
+        shader->setBinaryRetrievable();
+    }
 
     shader->link();
+
+    if (cache && shader->isValid()) {
+        GLenum format;
+        if (auto data = shader->binary(format); !data.isEmpty()) {
+            cache->write(key, {format, data});
+        }
+    }
+
+    qCDebug(KWIN_CORE) << "Compiled shader program in" << timer.nsecsElapsed() / 1000 << "us";
     return shader;
 }
 
+ShaderCache* ShaderManager::cache()
+{
+    if (!m_cacheInitialized) {
+        m_cacheInitialized = true;
+        if (!m_cacheDirectory.isEmpty() && ShaderCache::isSupported()) {
+            m_cache = std::make_unique<ShaderCache>(m_cacheDirectory);
+        }
+    }
+    return m_cache.get();
+}
+
+void ShaderManager::setCacheDirectory(QString const& directory)
+{
+    m_cacheDirectory = directory;
+    m_cache.reset();
+    m_cacheInitialized = false;
+}
+
+QString ShaderManager::cacheDirectory() const
+{
+    return m_cacheDirectory;
+}
+
+void ShaderManager::precompile(std::vector<ShaderTraits> const& traits)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (auto const& shaderTraits : traits) {
+        shader(shaderTraits);
+    }
+
+    qCDebug(KWIN_CORE) << "Precompiled" << traits.size() << "shader programs in"
+                       << timer.elapsed() << "ms";
+}
+
 static QString resolveShaderFilePath(const QString& filePath)
 {
     QString suffix;
@@ -323,12 +411,7 @@ void ShaderManager::bindAttributeLocations(GLShader* shader) const
 std::unique_ptr<GLShader> ShaderManager::loadShaderFromCode(const QByteArray& vertexSource,
                                                             const QByteArray& fragmentSource)
 {
-    std::unique_ptr<GLShader> shader{new GLShader(GLShader::ExplicitLinking)};
-    shader->load(vertexSource, fragmentSource);
-    bindAttributeLocations(shader.get());
-    bindFragDataLocations(shader.get());
-    shader->link();
-    return shader;
+    return createShader(vertexSource, fragmentSource, false);
 }
 
 }
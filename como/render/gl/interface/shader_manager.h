@@ -16,11 +16,13 @@
 #include <map>
 #include <memory>
 #include <stack>
+#include <vector>
 
 namespace como
 {
 
 class GLShader;
+class ShaderCache;
 
 enum class ShaderTrait {
     MapTexture = (1 << 0),
@@ -141,6 +143,24 @@ public:
                                                      const QString& vertexFile = QString(),
                                                      const QString& fragmentFile = QString());
 
+    /**
+     * Creates the shaders with the given @p traits if they do not exist yet. This should be
+     * called on startup for the traits commonly used when painting so that the first frames
+     * using them are not delayed by compiling their shaders.
+     */
+    void precompile(std::vector<ShaderTraits> const& traits);
+
+    /**
+     * Sets the @p directory linked shader programs are cached in. Programs found in the cache are
+     * loaded from there instead of compiling their sources. An empty directory disables the
+     * cache. By default programs are cached in the user's generic cache location.
+     *
+     * The cache prunes subdirectories it created for other drivers or compositor versions from
+     * @p directory. Other files and directories in it are kept.
+     */
+    void setCacheDirectory(QString const& directory);
+    QString cacheDirectory() const;
+
     /**
      * @return a pointer to the ShaderManager instance
      */
@@ -161,9 +181,17 @@ private:
     QByteArray generateVertexSource(ShaderTraits traits) const;
     QByteArray generateFragmentSource(ShaderTraits traits) const;
     std::unique_ptr<GLShader> generateShader(ShaderTraits traits);
+    std::unique_ptr<GLShader>
+    createShader(const QByteArray& vertexSource, const QByteArray& fragmentSource, bool generic);
+    ShaderCache* cache();
 
     std::stack<GLShader*> m_boundShaders;
     std::map<ShaderTraits, std::unique_ptr<GLShader>> m_shaderHash;
+
+    QString m_cacheDirectory;
+    std::unique_ptr<ShaderCache> m_cache;
+    bool m_cacheInitialized{false};
+
     static ShaderManager* s_shaderManager;
 };
 
@@ -503,13 +503,18 @@ void GLTexture::unbind()
 }
 
 void GLTexture::render(QSize const& target_size)
+{
+    render({{}, d_ptr->get_buffer_size()}, target_size);
+}
+
+void GLTexture::render(QRect const& source, QSize const& target_size)
 {
     if (target_size.isEmpty()) {
         // nothing to paint. m_vbo is likely nullptr and cacheed size empty as well, #337090
         return;
     }
 
-    d_ptr->update_cache({{}, d_ptr->get_buffer_size()}, target_size);
+    d_ptr->update_cache(source, target_size);
     d_ptr->m_vbo->render(GL_TRIANGLE_STRIP);
 }
 
@@ -699,7 +704,7 @@ void GLTexturePrivate::updateMatrix()
 
 void GLTexturePrivate::update_cache(QRect const& source, QSize const& size)
 {
-    if (cache.size == size && cache.source != source) {
+    if (cache.size == size && cache.source == source) {
         return;
     }
 
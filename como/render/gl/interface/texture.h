@@ -100,6 +100,7 @@ public:
     void unbind();
 
     void render(QSize const& target_size);
+    void render(QRect const& source, QSize const& target_size);
     void render(effect::render_data const& data, QRegion const& region, QSize const& target_size);
     void render(effect::render_data const& data,
                 QRect const& source,
@@ -0,0 +1,224 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/base/logging.h>
+#include <como/render/effect/interface/paint_data.h>
+#include <como/render/effect/interface/types.h>
+#include <como/render/effect/interface/window_quad.h>
+
+#include <como/render/gl/interface/shader.h>
+#include <como/render/gl/interface/shader_manager.h>
+#include <como/render/gl/interface/texture.h>
+#include <como/render/gl/interface/vertex_buffer.h>
+
+#include <QMatrix4x4>
+#include <QPoint>
+#include <QVector2D>
+#include <QVector4D>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace como::render::gl
+{
+
+/**
+ * Collects the textured quads of windows painted one after the other and submits them together.
+ *
+ * The vertices of all windows are written into one mapped range of the streaming buffer. They are
+ * translated by the window position, so windows painted without transformations share the same
+ * projection matrix. On submission the draws keep their order. A shader is only bound and
+ * uniforms are only uploaded when they change from one draw to the next. Consecutive draws of the
+ * same texture with the same state are merged.
+ *
+ * Must only be filled while no other rendering can happen in between, i.e. when no effect takes
+ * part in the current paint pass.
+ */
+class render_batch
+{
+public:
+    struct node {
+        GLTexture* texture{nullptr};
+        TextureCoordinateType coordinate_type{UnnormalizedCoordinates};
+
+        // Position of the content in the texture, for textures shared by several windows.
+        QPoint texture_offset;
+
+        WindowQuadList quads;
+
+        // Added to the positions of all vertices.
+        QPoint offset;
+
+        ShaderTraits traits;
+        QMatrix4x4 mvp;
+        QVector4D modulation;
+        float saturation{1.};
+        bool blend{false};
+
+        int first_vertex{0};
+        int vertex_count{0};
+    };
+
+    bool empty() const
+    {
+        return nodes.empty();
+    }
+
+    void add(node&& node)
+    {
+        nodes.push_back(std::move(node));
+    }
+
+    void submit(effect::render_data const& render)
+    {
+        if (nodes.empty()) {
+            return;
+        }
+
+        auto const count = nodes.size();
+        auto const indexed_quads = GLVertexBuffer::supportsIndexedQuads();
+        auto const primitive_type = indexed_quads ? GL_QUADS : GL_TRIANGLES;
+        auto const vertices_per_quad = indexed_quads ? 4 : 6;
+
+        int quad_count = 0;
+        for (auto const& node : nodes) {
+            quad_count += node.quads.count();
+        }
+
+        auto vbo = GLVertexBuffer::streamingBuffer();
+        vbo->reset();
+
+        constexpr std::array layout{
+            GLVertexAttrib{
+                .attributeIndex = VA_Position,
+                .componentCount = 2,
+                .type = GL_FLOAT,
+                .relativeOffset = offsetof(GLVertex2D, position),
+            },
+            GLVertexAttrib{
+                .attributeIndex = VA_TexCoord,
+                .componentCount = 2,
+                .type = GL_FLOAT,
+                .relativeOffset = offsetof(GLVertex2D, texcoord),
+            },
+        };
+        vbo->setAttribLayout(std::span(layout), sizeof(GLVertex2D));
+
+        auto map = vbo->map<GLVertex2D>(vertices_per_quad * quad_count);
+        if (!map) {
+            qCWarning(KWIN_CORE) << "Could not map vertices to submit render batch";
+            clear();
+            return;
+        }
+
+        for (int v = 0; auto& node : nodes) {
+            node.first_vertex = v;
+            node.vertex_count = node.quads.count() * vertices_per_quad;
+
+            auto vertices = (*map).subspan(v, node.vertex_count);
+            auto texture_matrix = node.texture->matrix(node.coordinate_type);
+            texture_matrix.translate(node.texture_offset.x(), node.texture_offset.y());
+            node.quads.makeInterleavedArrays(primitive_type, vertices, texture_matrix);
+
+            if (!node.offset.isNull()) {
+                QVector2D const offset(node.offset);
+                for (auto& vertex : vertices) {
+                    vertex.position += offset;
+                }
+            }
+
+            v += node.vertex_count;
+        }
+
+        vbo->unmap();
+        vbo->bindArrays();
+
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+        GLShader* shader{nullptr};
+
+        // Blending is disabled outside of window painting.
+        bool blend{false};
+
+        for (size_t i = 0; i < count;) {
+            auto const& node = nodes[i];
+
+            if (!shader || node.traits != nodes[i - 1].traits) {
+                if (shader) {
+                    ShaderManager::instance()->popShader();
+                }
+                shader = ShaderManager::instance()->pushShader(node.traits);
+                shader->setUniform(GLShader::ModelViewProjectionMatrix, node.mvp);
+                shader->setUniform(GLShader::Saturation, node.saturation);
+                shader->setUniform(GLShader::ModulationConstant, node.modulation);
+            } else {
+                auto const& prev = nodes[i - 1];
+                if (node.mvp != prev.mvp) {
+                    shader->setUniform(GLShader::ModelViewProjectionMatrix, node.mvp);
+                }
+                if (node.saturation != prev.saturation) {
+                    shader->setUniform(GLShader::Saturation, node.saturation);
+                }
+                if (node.modulation != prev.modulation) {
+                    shader->setUniform(GLShader::ModulationConstant, node.modulation);
+                }
+            }
+
+            if (node.blend != blend) {
+                if (node.blend) {
+                    glEnable(GL_BLEND);
+                } else {
+                    glDisable(GL_BLEND);
+                }
+                blend = node.blend;
+            }
+
+            node.texture->setFilter(GL_LINEAR);
+            node.texture->setWrapMode(GL_CLAMP_TO_EDGE);
+            node.texture->bind();
+
+            // Vertices of consecutive nodes are consecutive too.
+            auto vertex_count = node.vertex_count;
+            auto next = i + 1;
+            while (next < count && can_merge(node, nodes[next])) {
+                vertex_count += nodes[next].vertex_count;
+                next++;
+            }
+
+            vbo->draw(render, infiniteRegion(), primitive_type, node.first_vertex, vertex_count);
+            i = next;
+        }
+
+        ShaderManager::instance()->popShader();
+        vbo->unbindArrays();
+
+        if (blend) {
+            glDisable(GL_BLEND);
+        }
+
+        clear();
+    }
+
+    /// Drops all nodes. The node storage is kept for the next frame.
+    void clear()
+    {
+        nodes.clear();
+    }
+
+private:
+    static bool can_merge(node const& first, node const& second)
+    {
+        return first.texture == second.texture && first.coordinate_type == second.coordinate_type
+            && first.traits == second.traits && first.mvp == second.mvp
+            && first.modulation == second.modulation && first.saturation == second.saturation
+            && first.blend == second.blend;
+    }
+
+    std::vector<node> nodes;
+};
+
+}
@@ -10,6 +10,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include "buffer.h"
 #include "deco_renderer.h"
 #include "lanczos_filter.h"
+#include "render_batch.h"
 #include "window.h"
 
 #include <como/base/logging.h>
@@ -19,6 +20,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <como/render/shadow.h>
 
 #include <como/render/gl/interface/platform.h>
+#include <como/render/gl/interface/shader_manager.h>
 #include <como/render/gl/interface/utils.h>
 
 #include <KNotification>
@@ -80,6 +82,14 @@ public:
             glBindVertexArray(vao);
         }
 
+        // Have the shaders for painting windows ready before the first frame.
+        ShaderManager::instance()->precompile({
+            ShaderTrait::MapTexture,
+            ShaderTrait::MapTexture | ShaderTrait::Modulate,
+            ShaderTrait::MapTexture | ShaderTrait::Modulate | ShaderTrait::AdjustSaturation,
+            ShaderTrait::UniformColor,
+        });
+
         qCDebug(KWIN_CORE) << "OpenGL 2 compositing successfully initialized";
     }
 
@@ -89,6 +99,7 @@ public:
 
         // Need to reset early, otherwise the GL context is gone.
         sw_cursor.texture.reset();
+        decoration_atlas.clear();
 
         if (lanczos) {
             delete lanczos;
@@ -121,6 +132,8 @@ public:
             return 0;
         }
 
+        prepare_decorations();
+
         auto mask = paint_type::none;
         QRegion update;
         QRegion valid;
@@ -128,7 +141,11 @@ public:
         vp_projection = render.projection * render.view;
 
         // Call generic implementation.
+        batching = true;
         this->paintScreen(render, mask, damage, repaint, &update, &valid, presentTime);
+        batching = false;
+        batch.submit(render);
+
         paintCursor(render);
 
         assert(render.targets.size() == 1);
@@ -273,6 +290,13 @@ public:
 
     std::unordered_map<uint32_t, gl_window_t*> windows;
 
+    /// Shared by the decorations of all windows.
+    deco_atlas decoration_atlas;
+
+    /// Draws of windows painted in a screen pass. Only filled while batching is true.
+    render_batch batch;
+    bool batching{false};
+
 protected:
     std::unique_ptr<window_t> createWindow(typename window_t::ref_t ref_win) override
     {
@@ -456,10 +480,6 @@ protected:
         auto shader = ShaderManager::instance()->pushShader(traits);
         auto const rect = view->geometry();
 
-        auto mvp = vp_projection;
-        mvp.translate(rect.x(), rect.y());
-        shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
-
         if (opacity != 1.0) {
             shader->setUniform(GLShader::ModulationConstant,
                                QVector4D(opacity, opacity, opacity, opacity));
@@ -468,7 +488,33 @@ protected:
         glEnable(GL_BLEND);
         glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
         texture->bind();
-        texture->render(rect.size());
+
+        if (this->painted_region == infiniteRegion()) {
+            auto mvp = vp_projection;
+            mvp.translate(rect.x(), rect.y());
+            shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
+            texture->render(rect.size());
+        } else {
+            // Outside of the painted region the view is still on screen from a previous frame.
+            // Painting it there again would blend its translucent parts twice.
+            auto const scale_x = texture->width() / static_cast<qreal>(rect.width());
+            auto const scale_y = texture->height() / static_cast<qreal>(rect.height());
+
+            for (auto const& clip : this->painted_region & rect) {
+                auto mvp = vp_projection;
+                mvp.translate(clip.x(), clip.y());
+                shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
+
+                auto const local = clip.translated(-rect.topLeft());
+                auto const source = QRectF(local.x() * scale_x,
+                                           local.y() * scale_y,
+                                           local.width() * scale_x,
+                                           local.height() * scale_y)
+                                        .toAlignedRect();
+                texture->render(source, clip.size());
+            }
+        }
+
         texture->unbind();
         glDisable(GL_BLEND);
 
@@ -566,12 +612,26 @@ private:
         return leads;
     }
 
+    /**
+     * Decorations are rasterized and uploaded before any window is drawn. This way the atlas does
+     * not grow in the middle of the frame.
+     */
+    void prepare_decorations()
+    {
+        decoration_atlas.release_retired();
+
+        for (auto win : this->stacking_order) {
+            static_cast<gl_window_t*>(win)->prepare_decoration();
+        }
+    }
+
     void performPaintWindow(effect::window_paint_data& data)
     {
         auto& eff_win = static_cast<effect_window_t&>(data.window);
         auto mask = static_cast<paint_type>(data.paint.mask);
 
         if (flags(mask & paint_type::window_lanczos)) {
+            batch.submit(data.render);
             if (!lanczos) {
                 lanczos = new lanczos_filter<scene>(this);
             }
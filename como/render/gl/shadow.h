@@ -5,85 +5,19 @@
 */
 #pragma once
 
+#include "shadow_texture_cache.h"
+
 #include <como/render/shadow.h>
 
 #include <como/render/gl/interface/platform.h>
 #include <como/render/gl/interface/utils.h>
 
 #include <QPainter>
-#include <QSharedPointer>
+#include <memory>
 
 namespace como::render::gl
 {
 
-template<typename Shadow>
-class DecorationShadowTextureCache
-{
-public:
-    ~DecorationShadowTextureCache()
-    {
-        assert(m_cache.isEmpty());
-    }
-
-    DecorationShadowTextureCache(const DecorationShadowTextureCache&) = delete;
-
-    static DecorationShadowTextureCache& instance()
-    {
-        static DecorationShadowTextureCache s_instance;
-        return s_instance;
-    }
-
-    void unregister(Shadow* shadow)
-    {
-        auto it = m_cache.begin();
-        while (it != m_cache.end()) {
-            auto& d = it.value();
-            // check whether the Vector of Shadows contains our shadow and remove all of them
-            auto glIt = d.shadows.begin();
-            while (glIt != d.shadows.end()) {
-                if (*glIt == shadow) {
-                    glIt = d.shadows.erase(glIt);
-                } else {
-                    glIt++;
-                }
-            }
-            // if there are no shadows any more we can erase the cache entry
-            if (d.shadows.isEmpty()) {
-                it = m_cache.erase(it);
-            } else {
-                it++;
-            }
-        }
-    }
-
-    QSharedPointer<GLTexture> getTexture(Shadow* shadow)
-    {
-        Q_ASSERT(shadow->hasDecorationShadow());
-        unregister(shadow);
-        auto const decoShadow = shadow->decorationShadow().lock();
-        Q_ASSERT(decoShadow);
-        auto it = m_cache.find(decoShadow.get());
-        if (it != m_cache.end()) {
-            Q_ASSERT(!it.value().shadows.contains(shadow));
-            it.value().shadows << shadow;
-            return it.value().texture;
-        }
-        Data d;
-        d.shadows << shadow;
-        d.texture = QSharedPointer<GLTexture>::create(shadow->decorationShadowImage());
-        m_cache.insert(decoShadow.get(), d);
-        return d.texture;
-    }
-
-private:
-    DecorationShadowTextureCache() = default;
-    struct Data {
-        QSharedPointer<GLTexture> texture;
-        QVector<Shadow*> shadows;
-    };
-    QHash<KDecoration2::DecorationShadow*, Data> m_cache;
-};
-
 template<typename Window, typename Scene>
 class shadow : public render::shadow<Window>
 {
@@ -99,13 +33,12 @@ public:
     ~shadow() override
     {
         scene.makeOpenGLContextCurrent();
-        DecorationShadowTextureCache<type>::instance().unregister(this);
         m_texture.reset();
     }
 
     GLTexture* shadowTexture()
     {
-        return m_texture.data();
+        return m_texture.get();
     }
 
 protected:
@@ -348,7 +281,8 @@ protected:
         if (this->hasDecorationShadow()) {
             // simplifies a lot by going directly to
             scene.makeOpenGLContextCurrent();
-            m_texture = DecorationShadowTextureCache<type>::instance().getTexture(this);
+            m_texture = shadow_texture_cache::instance().get(
+                this->decorationShadow().lock(), [this] { return this->decorationShadowImage(); });
 
             return true;
         }
@@ -441,13 +375,7 @@ protected:
         }
 
         scene.makeOpenGLContextCurrent();
-        m_texture = QSharedPointer<GLTexture>::create(image);
-
-        if (m_texture->internalFormat() == GL_R8) {
-            // Swizzle red to alpha and all other channels to zero
-            m_texture->bind();
-            m_texture->setSwizzle(GL_ZERO, GL_ZERO, GL_ZERO, GL_RED);
-        }
+        m_texture = shadow_texture_cache::instance().get(image);
 
         return true;
     }
@@ -475,7 +403,7 @@ private:
         }
     }
 
-    QSharedPointer<GLTexture> m_texture;
+    std::shared_ptr<GLTexture> m_texture;
     Scene& scene;
 };
 
@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/render/gl/interface/texture.h>
+#include <como/render/gl/interface/utils.h>
+
+#include <KDecoration2/DecorationShadow>
+#include <QHashFunctions>
+#include <QImage>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+namespace como::render::gl
+{
+
+/**
+ * Shares shadow textures between windows by their content. Toolkits usually give all their
+ * windows the same shadow, so independent of the shadow source (decoration, X11 property or
+ * Wayland protocol) most windows use one of only a few textures.
+ *
+ * Textures are looked up by a hash of the shadow image together with its size and format. The
+ * image itself is not kept after the upload. Decoration shadows are additionally looked up by
+ * their shadow object, so the shadow image is only rendered for the first window using it.
+ * A texture is removed from the cache when the last shadow using it releases it.
+ */
+class shadow_texture_cache
+{
+public:
+    struct report {
+        size_t textures{0};
+        size_t users{0};
+        size_t bytes{0};
+
+        // Texture memory that would be in use additionally without sharing.
+        size_t saved_bytes{0};
+    };
+
+    shadow_texture_cache(shadow_texture_cache const&) = delete;
+
+    static shadow_texture_cache& instance()
+    {
+        static shadow_texture_cache cache;
+        return cache;
+    }
+
+    /// The GL context must be current.
+    std::shared_ptr<GLTexture> get(QImage const& image)
+    {
+        auto const key = hash(image);
+
+        for (auto [it, end] = entries.equal_range(key); it != end; it++) {
+            if (it->second.size == image.size() && it->second.format == image.format()) {
+                if (auto texture = it->second.texture.lock()) {
+                    return texture;
+                }
+            }
+        }
+
+        auto texture = std::shared_ptr<GLTexture>(new GLTexture(image), [this, key](auto raw) {
+            remove(key, raw);
+            delete raw;
+        });
+
+        if (texture->internalFormat() == GL_R8) {
+            // Swizzle red to alpha and all other channels to zero
+            texture->bind();
+            texture->setSwizzle(GL_ZERO, GL_ZERO, GL_ZERO, GL_RED);
+        }
+
+        entries.insert({key, {image.size(), image.format(), texture, texture.get()}});
+        return texture;
+    }
+
+    /// The GL context must be current. Calls @p render_image only when the decoration shadow has
+    /// no texture yet.
+    template<typename RenderImage>
+    std::shared_ptr<GLTexture> get(std::shared_ptr<KDecoration2::DecorationShadow> const& shadow,
+                                   RenderImage render_image)
+    {
+        if (auto it = decoration_entries.find(shadow.get()); it != decoration_entries.end()) {
+            // The weak pointer to the shadow rules out a new shadow at the address of a deleted
+            // one.
+            if (!it->second.shadow.expired()) {
+                if (auto texture = it->second.texture.lock()) {
+                    return texture;
+                }
+            }
+            decoration_entries.erase(it);
+        }
+
+        auto texture = get(render_image());
+        decoration_entries.insert({shadow.get(), {shadow, texture, texture.get()}});
+        return texture;
+    }
+
+    report get_report() const
+    {
+        report report;
+
+        for (auto const& [key, entry] : entries) {
+            auto const users = static_cast<size_t>(entry.texture.use_count());
+            auto const bytes = static_cast<size_t>(entry.size.width()) * entry.size.height()
+                * (entry.raw->internalFormat() == GL_R8 ? 1 : 4);
+
+            report.textures++;
+            report.users += users;
+            report.bytes += bytes;
+            if (users > 1) {
+                report.saved_bytes += (users - 1) * bytes;
+            }
+        }
+
+        return report;
+    }
+
+private:
+    struct entry {
+        QSize size;
+        QImage::Format format;
+        std::weak_ptr<GLTexture> texture;
+
+        // Identifies the entry on removal, when the weak pointer has already expired.
+        GLTexture const* raw;
+    };
+
+    struct decoration_entry {
+        std::weak_ptr<KDecoration2::DecorationShadow> shadow;
+        std::weak_ptr<GLTexture> texture;
+        GLTexture const* raw;
+    };
+
+    shadow_texture_cache() = default;
+
+    static size_t hash(QImage const& image)
+    {
+        auto const seed = qHashMulti(0, image.width(), image.height(), image.format());
+        return qHashBits(image.constBits(), image.sizeInBytes(), seed);
+    }
+
+    void remove(size_t key, GLTexture const* texture)
+    {
+        std::erase_if(decoration_entries,
+                      [texture](auto const& entry) { return entry.second.raw == texture; });
+
+        for (auto [it, end] = entries.equal_range(key); it != end; it++) {
+            if (it->second.raw == texture) {
+                entries.erase(it);
+                return;
+            }
+        }
+    }
+
+    std::unordered_multimap<size_t, entry> entries;
+    std::unordered_map<KDecoration2::DecorationShadow const*, decoration_entry> decoration_entries;
+};
+
+}
@@ -53,6 +53,9 @@ public:
         float opacity;
         bool hasAlpha;
         TextureCoordinateType coordinateType;
+
+        // Position of the texture content, for textures shared with other windows.
+        QPoint texture_offset;
     };
 
     using type = window<RefWin, Scene>;
@@ -76,36 +79,18 @@ public:
         return new buffer_t(this, scene);
     }
 
+    /// Uploads decoration updates to the shared atlas ahead of painting.
+    void prepare_decoration()
+    {
+        update_decoration();
+    }
+
     void performPaint(paint_type mask, effect::window_paint_data& data) override
     {
         if (!beginRenderWindow(mask, data)) {
             return;
         }
 
-        auto shader = data.shader;
-        if (!shader) {
-            ShaderTraits traits = ShaderTrait::MapTexture;
-
-            if (data.paint.opacity != 1.0 || data.paint.brightness != 1.0
-                || data.cross_fade_progress != 1.0) {
-                traits |= ShaderTrait::Modulate;
-            }
-
-            if (data.paint.saturation != 1.0) {
-                traits |= ShaderTrait::AdjustSaturation;
-            }
-
-            shader = ShaderManager::instance()->pushShader(traits);
-        }
-
-        QMatrix4x4 pos_matrix;
-        auto const win_pos = std::visit(overload{[](auto&& ref_win) { return ref_win->geo.pos(); }},
-                                        *this->ref_win);
-        pos_matrix.translate(win_pos.x(), win_pos.y());
-
-        shader->setUniform(GLShader::ModelViewProjectionMatrix, effect::get_mvp(data) * pos_matrix);
-        shader->setUniform(GLShader::Saturation, data.paint.saturation);
-
         std::vector<WindowQuadList> quads;
         quads.resize(ContentLeaf + 1);
         int last_content_id = this->id();
@@ -192,6 +177,31 @@ public:
             }
         }
 
+        std::vector<LeafNode> nodes;
+        setupLeafNodes(nodes, quads, has_previous_content, data);
+
+        auto const win_pos = std::visit(overload{[](auto&& ref_win) { return ref_win->geo.pos(); }},
+                                        *this->ref_win);
+
+        if (can_batch(mask, data)) {
+            add_to_batch(quads, nodes, win_pos, data);
+            return;
+        }
+
+        // Windows painted earlier must be drawn first.
+        scene.batch.submit(data.render);
+
+        auto shader = data.shader;
+        if (!shader) {
+            shader = ShaderManager::instance()->pushShader(get_shader_traits(data));
+        }
+
+        QMatrix4x4 pos_matrix;
+        pos_matrix.translate(win_pos.x(), win_pos.y());
+
+        shader->setUniform(GLShader::ModelViewProjectionMatrix, effect::get_mvp(data) * pos_matrix);
+        shader->setUniform(GLShader::Saturation, data.paint.saturation);
+
         const bool indexedQuads = GLVertexBuffer::supportsIndexedQuads();
         const GLenum primitiveType = indexedQuads ? GL_QUADS : GL_TRIANGLES;
         const int verticesPerQuad = indexedQuads ? 4 : 6;
@@ -208,9 +218,6 @@ public:
             return;
         }
 
-        std::vector<LeafNode> nodes;
-        setupLeafNodes(nodes, quads, has_previous_content, data);
-
         for (size_t i = 0, v = 0; i < quads.size(); i++) {
             if (quads[i].isEmpty() || !nodes[i].texture)
                 continue;
@@ -218,7 +225,8 @@ public:
             nodes[i].firstVertex = v;
             nodes[i].vertexCount = quads[i].count() * verticesPerQuad;
 
-            const QMatrix4x4 matrix = nodes[i].texture->matrix(nodes[i].coordinateType);
+            auto matrix = nodes[i].texture->matrix(nodes[i].coordinateType);
+            matrix.translate(nodes[i].texture_offset.x(), nodes[i].texture_offset.y());
 
             quads[i].makeInterleavedArrays(primitiveType, (*map).subspan(v), matrix);
             v += quads[i].count() * verticesPerQuad;
@@ -271,10 +279,72 @@ public:
     }
 
 private:
-    GLTexture* getDecorationTexture() const
+    static ShaderTraits get_shader_traits(effect::window_paint_data const& data)
+    {
+        ShaderTraits traits = ShaderTrait::MapTexture;
+
+        if (data.paint.opacity != 1.0 || data.paint.brightness != 1.0
+            || data.cross_fade_progress != 1.0) {
+            traits |= ShaderTrait::Modulate;
+        }
+
+        if (data.paint.saturation != 1.0) {
+            traits |= ShaderTrait::AdjustSaturation;
+        }
+
+        return traits;
+    }
+
+    /**
+     * Windows can be drawn together with the other windows of the frame when they are painted
+     * untransformed with the default shader and no effect can draw in between.
+     */
+    bool can_batch(paint_type mask, effect::window_paint_data const& data) const
+    {
+        if (!scene.batching || data.shader || m_hardwareClipping) {
+            return false;
+        }
+        if (flags(mask
+                  & (paint_type::window_transformed | paint_type::screen_transformed
+                     | paint_type::window_lanczos))) {
+            return false;
+        }
+        return !scene.platform.effects->has_active_effects();
+    }
+
+    void add_to_batch(std::vector<WindowQuadList>& quads,
+                      std::vector<LeafNode> const& nodes,
+                      QPoint const& win_pos,
+                      effect::window_paint_data const& data)
+    {
+        auto const traits = get_shader_traits(data);
+        auto const mvp = effect::get_mvp(data);
+
+        for (size_t i = 0; i < quads.size(); i++) {
+            if (quads[i].isEmpty() || !nodes[i].texture) {
+                continue;
+            }
+
+            scene.batch.add({
+                .texture = nodes[i].texture,
+                .coordinate_type = nodes[i].coordinateType,
+                .texture_offset = nodes[i].texture_offset,
+                .quads = std::move(quads[i]),
+                .offset = win_pos,
+                .traits = traits,
+                .mvp = mvp,
+                .modulation = modulate(nodes[i].opacity, data.paint.brightness),
+                .saturation = static_cast<float>(data.paint.saturation),
+                .blend = nodes[i].hasAlpha || nodes[i].opacity < 1.0,
+            });
+        }
+    }
+
+    /// Renders pending decoration updates.
+    deco_render_data<Scene> const* update_decoration() const
     {
         return std::visit(
-            overload{[&](auto&& ref_win) -> GLTexture* {
+            overload{[&](auto&& ref_win) -> deco_render_data<Scene> const* {
                 if (ref_win->control) {
                     if (ref_win->noBorder()) {
                         return nullptr;
@@ -287,15 +357,13 @@ private:
                     if (auto renderer = static_cast<deco_renderer_t*>(
                             ref_win->control->deco.client->renderer()->injector.get())) {
                         renderer->render();
-                        return renderer->texture();
+                        return static_cast<deco_render_data<Scene>*>(renderer->data.get());
                     }
                 } else if (auto& remnant = ref_win->remnant) {
                     if (!remnant->data.deco_render || remnant->data.no_border) {
                         return nullptr;
                     }
-                    if (auto& renderer = remnant->data.deco_render) {
-                        return static_cast<deco_render_data<Scene>&>(*renderer).texture.get();
-                    }
+                    return static_cast<deco_render_data<Scene>*>(remnant->data.deco_render.get());
                 }
                 return nullptr;
             }},
@@ -336,7 +404,10 @@ private:
         }
 
         if (!quads[DecorationLeaf].isEmpty()) {
-            nodes[DecorationLeaf].texture = getDecorationTexture();
+            if (auto deco = update_decoration()) {
+                nodes[DecorationLeaf].texture = deco->texture();
+                nodes[DecorationLeaf].texture_offset = deco->texture_offset();
+            }
             nodes[DecorationLeaf].opacity = data.paint.opacity;
             nodes[DecorationLeaf].hasAlpha = true;
             nodes[DecorationLeaf].coordinateType = UnnormalizedCoordinates;
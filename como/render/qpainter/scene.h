@@ -186,6 +186,10 @@ protected:
             return;
         }
         painter->save();
+        if (this->painted_region != infiniteRegion()) {
+            // Outside of the painted region the view is still on screen from a previous frame.
+            painter->setClipRegion(this->painted_region, Qt::IntersectClip);
+        }
         painter->setOpacity(view->opacity());
         painter->drawImage(view->geometry(), buffer);
         painter->restore();
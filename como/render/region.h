@@ -0,0 +1,536 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QRect>
+#include <QRegion>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <memory>
+
+namespace como::render
+{
+
+/**
+ * Set of pixels for the region algebra in hot paths like the scene's occlusion culling.
+ *
+ * Pixels are stored as y-x banded boxes. Boxes are sorted by y and then x. Boxes in one band share
+ * their vertical extent and do not touch each other. Adjacent bands with equal horizontal spans
+ * are merged. With that every set of pixels has a unique representation and comparing regions is
+ * a plain comparison of their boxes.
+ *
+ * In contrast to QRegion a region is not implicitly shared. The boxes of small regions are stored
+ * inline. Larger regions keep their buffer when being cleared or assigned to, so a region that is
+ * reused from frame to frame stops allocating once it has grown to its working size. Operations
+ * assigning to an operand compute into a per-thread scratch region whose buffer is swapped in.
+ */
+class region
+{
+public:
+    /// Box with exclusive right and bottom edges.
+    struct box {
+        int x1;
+        int y1;
+        int x2;
+        int y2;
+
+        bool operator==(box const& other) const = default;
+    };
+
+    static constexpr size_t inline_capacity{8};
+
+    region() = default;
+
+    explicit region(QRect const& rect)
+    {
+        assign(rect);
+    }
+
+    explicit region(QRegion const& qregion)
+    {
+        assign(qregion);
+    }
+
+    region(region const& other)
+    {
+        *this = other;
+    }
+
+    region& operator=(region const& other)
+    {
+        if (this != &other) {
+            reserve(other.count);
+            std::copy(other.begin(), other.end(), data());
+            count = other.count;
+        }
+        return *this;
+    }
+
+    region(region&& other) noexcept
+    {
+        swap(other);
+    }
+
+    region& operator=(region&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    void swap(region& other) noexcept
+    {
+        if (heap && other.heap) {
+            std::swap(heap, other.heap);
+            std::swap(capacity, other.capacity);
+            std::swap(count, other.count);
+            return;
+        }
+
+        if (!heap && !other.heap) {
+            std::swap(inline_boxes, other.inline_boxes);
+            std::swap(count, other.count);
+            return;
+        }
+
+        // One buffer is on the heap and the other inline.
+        auto& with_heap = heap ? *this : other;
+        auto& without_heap = heap ? other : *this;
+
+        std::copy(without_heap.inline_boxes.begin(),
+                  without_heap.inline_boxes.begin() + without_heap.count,
+                  with_heap.inline_boxes.begin());
+        without_heap.heap = std::move(with_heap.heap);
+
+        std::swap(with_heap.capacity, without_heap.capacity);
+        std::swap(with_heap.count, without_heap.count);
+    }
+
+    bool is_empty() const
+    {
+        return count == 0;
+    }
+
+    size_t rect_count() const
+    {
+        return count;
+    }
+
+    box const* begin() const
+    {
+        return data();
+    }
+
+    box const* end() const
+    {
+        return data() + count;
+    }
+
+    /// Removes all boxes but keeps the buffer.
+    void clear()
+    {
+        count = 0;
+    }
+
+    QRect bounding_rect() const
+    {
+        if (!count) {
+            return {};
+        }
+
+        auto const boxes = data();
+        int x1{INT_MAX};
+        int x2{INT_MIN};
+
+        // The first and last box of each band hold the horizontal extent of the band.
+        for (size_t i = 0; i < count; i = band_end(boxes, count, i)) {
+            x1 = std::min(x1, boxes[i].x1);
+            x2 = std::max(x2, boxes[band_end(boxes, count, i) - 1].x2);
+        }
+
+        return QRect(QPoint(x1, boxes[0].y1), QPoint(x2 - 1, boxes[count - 1].y2 - 1));
+    }
+
+    void assign(QRect const& rect)
+    {
+        clear();
+        if (!rect.isEmpty()) {
+            push_back({rect.left(), rect.top(), rect.right() + 1, rect.bottom() + 1});
+        }
+    }
+
+    void assign(QRegion const& qregion)
+    {
+        clear();
+        reserve(qregion.rectCount());
+
+        size_t band_start{0};
+        size_t prev_band_start{0};
+
+        // QRegion holds its rects banded as well. Only touching rects and bands are not always
+        // merged in it.
+        for (auto const& rect : qregion) {
+            if (rect.isEmpty()) {
+                continue;
+            }
+
+            box const next{rect.left(), rect.top(), rect.right() + 1, rect.bottom() + 1};
+
+            if (count > band_start) {
+                auto& last = data()[count - 1];
+                if (next.y1 == last.y1 && next.y2 == last.y2) {
+                    if (next.x1 < last.x2) {
+                        assign_unordered(qregion);
+                        return;
+                    }
+                    if (next.x1 == last.x2) {
+                        last.x2 = next.x2;
+                        continue;
+                    }
+                    push_back(next);
+                    continue;
+                }
+                if (next.y1 < last.y2) {
+                    assign_unordered(qregion);
+                    return;
+                }
+
+                // A new band starts.
+                if (coalesce(prev_band_start, band_start)) {
+                    band_start = prev_band_start;
+                } else {
+                    prev_band_start = band_start;
+                }
+                band_start = count;
+            }
+
+            push_back(next);
+        }
+
+        if (count > band_start) {
+            coalesce(prev_band_start, band_start);
+        }
+    }
+
+    QRegion to_qregion() const
+    {
+        if (!count) {
+            return {};
+        }
+        if (count == 1) {
+            auto const& b = data()[0];
+            return QRegion(b.x1, b.y1, b.x2 - b.x1, b.y2 - b.y1);
+        }
+
+        QVarLengthArray<QRect, 32> rects;
+        rects.reserve(count);
+        for (auto const& b : *this) {
+            rects.append(QRect(b.x1, b.y1, b.x2 - b.x1, b.y2 - b.y1));
+        }
+
+        QRegion ret;
+        ret.setRects(rects.constData(), static_cast<int>(rects.size()));
+        return ret;
+    }
+
+    region& operator|=(region const& other)
+    {
+        if (other.is_empty() || this == &other) {
+            return *this;
+        }
+        if (is_empty()) {
+            return *this = other;
+        }
+        return apply(other, [](bool in_this, bool in_other) { return in_this || in_other; });
+    }
+
+    region& operator-=(region const& other)
+    {
+        if (this == &other) {
+            clear();
+            return *this;
+        }
+        if (is_empty() || other.is_empty() || !bounds_overlap(other)) {
+            return *this;
+        }
+        return apply(other, [](bool in_this, bool in_other) { return in_this && !in_other; });
+    }
+
+    region& operator&=(region const& other)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        if (is_empty() || other.is_empty() || !bounds_overlap(other)) {
+            clear();
+            return *this;
+        }
+        return apply(other, [](bool in_this, bool in_other) { return in_this && in_other; });
+    }
+
+    /// Computes @p lhs minus @p rhs into @p out. The buffer of @p out is reused.
+    static void subtract(region const& lhs, region const& rhs, region& out)
+    {
+        assert(&out != &lhs && &out != &rhs);
+        if (lhs.is_empty() || rhs.is_empty() || !lhs.bounds_overlap(rhs)) {
+            out = lhs;
+            return;
+        }
+        combine(lhs, rhs, out, [](bool in_lhs, bool in_rhs) { return in_lhs && !in_rhs; });
+    }
+
+    friend region operator|(region lhs, region const& rhs)
+    {
+        return lhs |= rhs;
+    }
+
+    friend region operator-(region lhs, region const& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    friend region operator&(region lhs, region const& rhs)
+    {
+        return lhs &= rhs;
+    }
+
+    bool operator==(region const& other) const
+    {
+        return count == other.count && std::equal(begin(), end(), other.begin());
+    }
+
+private:
+    box* data()
+    {
+        return heap ? heap.get() : inline_boxes.data();
+    }
+
+    box const* data() const
+    {
+        return heap ? heap.get() : inline_boxes.data();
+    }
+
+    void reserve(size_t size)
+    {
+        if (size <= capacity) {
+            return;
+        }
+
+        auto const new_capacity = std::max(size, capacity * 2);
+        auto new_heap = std::make_unique_for_overwrite<box[]>(new_capacity);
+        std::copy(begin(), end(), new_heap.get());
+
+        heap = std::move(new_heap);
+        capacity = new_capacity;
+    }
+
+    void push_back(box const& b)
+    {
+        if (count == capacity) {
+            reserve(count + 1);
+        }
+        data()[count++] = b;
+    }
+
+    static size_t band_end(box const* boxes, size_t size, size_t start)
+    {
+        auto end = start + 1;
+        while (end < size && boxes[end].y1 == boxes[start].y1) {
+            end++;
+        }
+        return end;
+    }
+
+    bool bounds_overlap(region const& other) const
+    {
+        auto const& first = *data();
+        auto const& last = data()[count - 1];
+        auto const& other_first = *other.data();
+        auto const& other_last = other.data()[other.count - 1];
+
+        // Only the vertical extent is known without going through the bands.
+        return first.y1 < other_last.y2 && other_first.y1 < last.y2;
+    }
+
+    /**
+     * Merges the band starting at @p band_start into the previous one starting at
+     * @p prev_band_start if they touch and have the same horizontal spans. The band must be the
+     * last one.
+     */
+    bool coalesce(size_t prev_band_start, size_t band_start)
+    {
+        if (prev_band_start == band_start) {
+            return false;
+        }
+
+        auto boxes = data();
+        auto const size = band_start - prev_band_start;
+
+        if (count - band_start != size || boxes[prev_band_start].y2 != boxes[band_start].y1) {
+            return false;
+        }
+
+        for (size_t i = 0; i < size; i++) {
+            auto const& prev = boxes[prev_band_start + i];
+            auto const& cur = boxes[band_start + i];
+            if (prev.x1 != cur.x1 || prev.x2 != cur.x2) {
+                return false;
+            }
+        }
+
+        auto const y2 = boxes[band_start].y2;
+        for (size_t i = prev_band_start; i < band_start; i++) {
+            boxes[i].y2 = y2;
+        }
+        count = band_start;
+        return true;
+    }
+
+    void assign_unordered(QRegion const& qregion)
+    {
+        clear();
+
+        region rect_region;
+        for (auto const& rect : qregion) {
+            rect_region.assign(rect);
+            *this |= rect_region;
+        }
+    }
+
+    template<typename Op>
+    region& apply(region const& other, Op op)
+    {
+        thread_local region scratch;
+
+        combine(*this, other, scratch, op);
+        swap(scratch);
+        return *this;
+    }
+
+    /**
+     * Sweeps over the bands of @p lhs and @p rhs from top to bottom. Where bands of both overlap
+     * vertically their spans are swept from left to right. A pixel ends up in @p out if @p op
+     * returns true for it being in @p lhs and @p rhs.
+     */
+    template<typename Op>
+    static void combine(region const& lhs, region const& rhs, region& out, Op op)
+    {
+        out.clear();
+        out.reserve(lhs.count + rhs.count);
+
+        auto const a = lhs.data();
+        auto const b = rhs.data();
+        auto const a_size = lhs.count;
+        auto const b_size = rhs.count;
+
+        size_t ia{0};
+        size_t ib{0};
+        size_t prev_band_start{0};
+        int y = std::min(a_size ? a[0].y1 : INT_MAX, b_size ? b[0].y1 : INT_MAX);
+
+        while (true) {
+            while (ia < a_size && a[ia].y2 <= y) {
+                ia = band_end(a, a_size, ia);
+            }
+            while (ib < b_size && b[ib].y2 <= y) {
+                ib = band_end(b, b_size, ib);
+            }
+            if (ia == a_size && ib == b_size) {
+                break;
+            }
+
+            auto const in_a = ia < a_size && a[ia].y1 <= y;
+            auto const in_b = ib < b_size && b[ib].y1 <= y;
+
+            auto y_next = INT_MAX;
+            if (ia < a_size) {
+                y_next = std::min(y_next, in_a ? a[ia].y2 : a[ia].y1);
+            }
+            if (ib < b_size) {
+                y_next = std::min(y_next, in_b ? b[ib].y2 : b[ib].y1);
+            }
+
+            if ((in_a && op(true, false)) || (in_b && op(false, true)) || (in_a && in_b)) {
+                auto const band_start = out.count;
+
+                combine_band(in_a ? a + ia : a,
+                             in_a ? a + band_end(a, a_size, ia) : a,
+                             in_b ? b + ib : b,
+                             in_b ? b + band_end(b, b_size, ib) : b,
+                             y,
+                             y_next,
+                             out,
+                             op);
+
+                if (out.count > band_start) {
+                    if (!out.coalesce(prev_band_start, band_start)) {
+                        prev_band_start = band_start;
+                    }
+                }
+            }
+
+            y = y_next;
+        }
+    }
+
+    template<typename Op>
+    static void combine_band(box const* a,
+                             box const* a_end,
+                             box const* b,
+                             box const* b_end,
+                             int y1,
+                             int y2,
+                             region& out,
+                             Op op)
+    {
+        auto const band_start = out.count;
+        auto x = std::min(a != a_end ? a->x1 : INT_MAX, b != b_end ? b->x1 : INT_MAX);
+
+        while (true) {
+            while (a != a_end && a->x2 <= x) {
+                a++;
+            }
+            while (b != b_end && b->x2 <= x) {
+                b++;
+            }
+            if (a == a_end && b == b_end) {
+                break;
+            }
+
+            auto const in_a = a != a_end && a->x1 <= x;
+            auto const in_b = b != b_end && b->x1 <= x;
+
+            auto x_next = INT_MAX;
+            if (a != a_end) {
+                x_next = std::min(x_next, in_a ? a->x2 : a->x1);
+            }
+            if (b != b_end) {
+                x_next = std::min(x_next, in_b ? b->x2 : b->x1);
+            }
+
+            if (op(in_a, in_b)) {
+                auto boxes = out.data();
+                if (out.count > band_start && boxes[out.count - 1].x2 == x) {
+                    boxes[out.count - 1].x2 = x_next;
+                } else {
+                    out.push_back({x, y1, x_next, y2});
+                }
+            }
+
+            x = x_next;
+        }
+    }
+
+    std::array<box, inline_capacity> inline_boxes;
+    std::unique_ptr<box[]> heap;
+    size_t count{0};
+    size_t capacity{inline_capacity};
+};
+
+}
@@ -7,6 +7,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "buffer.h"
 #include "effect/window_group_impl.h"
+#include "region.h"
 #include "shadow.h"
 #include "singleton_interface.h"
 #include "types.h"
@@ -516,43 +517,53 @@ public:
             fullRepaint = (dirtyArea == displayRegion);
         }
 
-        QRegion allclips, upperTranslucentDamage;
-        upperTranslucentDamage = repaint_region;
+        auto& cull = occlusion_culling;
+        cull.window_regions.resize(phase2data.count());
+        cull.clips.clear();
+        cull.upper_translucent_damage.assign(repaint_region);
 
         // This is the occlusion culling pass
         for (int i = phase2data.count() - 1; i >= 0; --i) {
             Phase2Data* data = &phase2data[i];
+            auto& win_region = cull.window_regions[i];
 
             if (fullRepaint) {
-                data->region = displayRegion;
+                win_region.assign(displayRegion.boundingRect());
             } else {
-                data->region |= upperTranslucentDamage;
+                win_region.assign(data->region);
+                win_region |= cull.upper_translucent_damage;
             }
 
             // subtract the parts which will possibly been drawn as part of
             // a higher opaque window
-            data->region -= allclips;
+            win_region -= cull.clips;
 
             // Here we rely on WindowPrePaintData::setTranslucent() to remove
             // the clip if needed.
             if (!data->clip.isEmpty() && !(data->mask & paint_type::window_translucent)) {
+                cull.clip.assign(data->clip);
+
                 // clip away the opaque regions for all windows below this one
-                allclips |= data->clip;
+                cull.clips |= cull.clip;
                 // extend the translucent damage for windows below this by remaining (translucent)
                 // regions
                 if (!fullRepaint) {
-                    upperTranslucentDamage |= data->region - data->clip;
+                    render::region::subtract(win_region, cull.clip, cull.remainder);
+                    cull.upper_translucent_damage |= cull.remainder;
                 }
             } else if (!fullRepaint) {
-                upperTranslucentDamage |= data->region;
+                cull.upper_translucent_damage |= win_region;
             }
         }
 
-        QRegion paintedArea;
+        auto& painted = cull.painted;
+        painted.clear();
+
         // Fill any areas of the root window not covered by opaque windows
         if (!(orig_mask & paint_type::screen_background_first)) {
-            paintedArea = dirtyArea - allclips;
-            paintBackground(paintedArea, render_data.projection * render_data.view);
+            cull.remainder.assign(dirtyArea);
+            render::region::subtract(cull.remainder, cull.clips, painted);
+            paintBackground(painted.to_qregion(), render_data.projection * render_data.view);
         }
 
         // Now walk the list bottom to top and draw the windows.
@@ -560,12 +571,22 @@ public:
             Phase2Data* data = &phase2data[i];
 
             // add all regions which have been drawn so far
-            paintedArea |= data->region;
-            data->region = paintedArea;
+            if (auto const& win_region = cull.window_regions[i]; !win_region.is_empty()) {
+                painted |= win_region;
+            }
+
+            // Without transformations a window paints only inside its expanded geometry. So only
+            // that part of the painted region is converted for it.
+            auto& window_painted = cull.window_painted;
+            window_painted.assign(data->window->effect->expandedGeometry());
+            window_painted &= painted;
+            data->region = window_painted.to_qregion();
 
             paintWindow(render_data, data->window, data->mask, data->region, data->quads);
         }
 
+        auto const paintedArea = painted.to_qregion();
+
         if (fullRepaint) {
             painted_region = displayRegion;
             damaged_region = displayRegion - repaintClip;
@@ -669,6 +690,18 @@ public:
 private:
     std::chrono::milliseconds m_expectedPresentTimestamp = std::chrono::milliseconds::zero();
 
+    // Regions of the occlusion culling in paintSimpleScreen. They are kept from frame to frame so
+    // their buffers are reused.
+    struct {
+        std::vector<render::region> window_regions;
+        render::region clips;
+        render::region upper_translucent_damage;
+        render::region clip;
+        render::region remainder;
+        render::region painted;
+        render::region window_painted;
+    } occlusion_culling;
+
     // Windows stacking order of the current paint run.
     std::vector<window_t*> stacking_order;
 };
@@ -5,12 +5,14 @@
 */
 #pragma once
 
-#include "duration_record.h"
 #include "presentation.h"
+#include "repaint_policy.h"
+#include "scanout.h"
 
 #include <como/base/logging.h>
 #include <como/base/seat/session.h>
 #include <como/debug/perf/ftrace.h>
+#include <como/render/frame_timing.h>
 #include <como/render/gl/scene.h>
 #include <como/render/gl/timer_query.h>
 #include <como/win/remnant.h>
@@ -26,6 +28,7 @@
 #include <chrono>
 #include <deque>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace como::render::wayland
@@ -69,6 +72,7 @@ public:
     {
         delay_timer.stop();
         frame_timer.stop();
+        present_target = {};
     }
     void add_repaint(QRegion const& region)
     {
@@ -101,7 +105,7 @@ public:
                                                         return false;
                                                     }
                                                     render_time_debug = timer.time();
-                                                    render_durations.update(timer.time());
+                                                    timings.render.add(timer.time());
                                                     return true;
                                                 }),
                                  last_timer_queries.end());
@@ -116,13 +120,11 @@ public:
         auto const refresh
             = data.refresh > std::chrono::nanoseconds::zero() ? data.refresh : refresh_length();
 
-        // Some relative gap to factor in the unknown time the hardware needs to put a rendered
-        // image onto the scanout buffer.
-        auto const hw_margin = refresh / 10;
+        // Time for painting, rendering and the hardware as decided by our policy.
+        auto const margin = policy->margin(refresh, timings);
 
         // We try to delay the next paint shortly before next vblank factoring in our margins.
-        auto try_delay = refresh - vblank_to_now - hw_margin - paint_durations.get_max()
-            - render_durations.get_max();
+        auto try_delay = refresh - vblank_to_now - margin;
 
         // If our previous margins were too large we don't delay. We would likely miss the next
         // vblank.
@@ -134,9 +136,8 @@ public:
         debug << "\nSWAP total: " << to_ms((now - swap_ref_time)) << endl;
         debug << "vblank to now: " << to_ms(now) << " - " << to_ms(data.when) << " = "
               << to_ms(vblank_to_now) << endl;
-        debug << "MARGINS vblank: " << to_ms(hw_margin)
-              << " paint: " << to_ms(paint_durations.get_max())
-              << " render: " << to_ms(render_time_debug) << "(" << to_ms(render_durations.get_max())
+        debug << "MARGIN: " << to_ms(margin) << " paint: " << to_ms(timings.paint.max())
+              << " render: " << to_ms(render_time_debug) << "(" << to_ms(timings.render.max())
               << ")" << endl;
         debug << "refresh: " << to_ms(refresh) << " delay: " << to_ms(try_delay) << " ("
               << to_ms(delay) << ")";
@@ -159,7 +160,9 @@ public:
         Perf::Ftrace::mark(ftrace_identifier + QString::number(wait_time.count()));
 
         // Force 4fps minimum:
-        delay_timer.start(std::min(wait_time, std::chrono::milliseconds(250)).count(), this);
+        auto const timer_wait = std::min(wait_time, std::chrono::milliseconds(250));
+        delay_timer_target = std::chrono::steady_clock::now().time_since_epoch() + timer_wait;
+        delay_timer.start(timer_wait.count(), this);
     }
 
     template<typename Win>
@@ -196,17 +199,37 @@ public:
         auto now_ns = std::chrono::steady_clock::now().time_since_epoch();
         auto now = std::chrono::duration_cast<std::chrono::milliseconds>(now_ns);
 
-        // Start the actual painting process.
-        auto const duration
-            = std::chrono::nanoseconds(platform.scene->paint_output(&base, repaints, windows, now));
+        auto const target = next_vblank(now_ns);
+
+        if (auto candidate = get_scanout_candidate(*this, windows);
+            candidate && direct_scanout(*candidate)) {
+            // The scene resets the window repaints when painting. Without that the windows would
+            // keep requesting frames and the same buffer would be committed again and again.
+            for (auto win : windows) {
+                std::visit(overload{[this](auto&& win) { win::reset_repaints(*win, &base); }},
+                           win);
+            }
+
+            // The paint timings are not updated. They must still hold when we composite again.
+            timings.scanout_frames++;
+        } else {
+            // Start the actual painting process.
+            auto const duration = std::chrono::nanoseconds(
+                platform.scene->paint_output(&base, repaints, windows, now));
 
 #if SWAP_TIME_DEBUG
-        qDebug().noquote() << "RUN gap:" << to_ms(now_ns - swap_ref_time)
-                           << "paint:" << to_ms(duration);
-        swap_ref_time = now_ns;
+            qDebug().noquote() << "RUN gap:" << to_ms(now_ns - swap_ref_time)
+                               << "paint:" << to_ms(duration);
+            swap_ref_time = now_ns;
 #endif
 
-        paint_durations.update(duration);
+            timings.paint.add(duration);
+        }
+
+        // Only a committed buffer is presented. Otherwise no presentation event arrives that
+        // could be compared against the target.
+        present_target = swap_pending ? target : std::chrono::nanoseconds::zero();
+
         retard_next_run();
 
         if (!windows.empty()) {
@@ -225,9 +248,18 @@ public:
         Perf::Ftrace::end(ftrace_identifier, msc);
     }
 
+    /**
+     * Shows the buffer of @p window on the output instead of compositing the scene. Returns false
+     * if that is not possible for the current buffer.
+     */
+    virtual bool direct_scanout(typename space_t::window_t /*window*/)
+    {
+        return false;
+    }
+
     void dry_run()
     {
-        auto windows = win::render_stack(platform.space->stacking.order);
+        auto const& windows = win::render_stack(platform.space->stacking.order);
         std::deque<typename space_t::window_t> frame_windows;
 
         for (auto win : windows) {
@@ -253,6 +285,19 @@ public:
     void presented(presentation_data const& data)
     {
         platform.presentation->presented(this, data);
+
+        if (last_presentation.when > std::chrono::nanoseconds::zero()) {
+            timings.present_interval.add(data.when - last_presentation.when);
+        }
+        if (present_target > std::chrono::nanoseconds::zero()) {
+            auto const refresh
+                = data.refresh > std::chrono::nanoseconds::zero() ? data.refresh : refresh_length();
+            auto const missed = presentation_missed(present_target, data.when, refresh);
+
+            (missed ? timings.missed_frames : timings.hit_frames)++;
+            policy->presented(missed, refresh);
+            present_target = {};
+        }
         last_presentation = data;
     }
 
@@ -283,6 +328,33 @@ public:
     QBasicTimer frame_timer;
     std::vector<render::gl::timer_query> last_timer_queries;
 
+    void set_repaint_policy(repaint_policy_type type)
+    {
+        policy = create_repaint_policy(type);
+    }
+
+    QString get_repaint_policy_name() const
+    {
+        return repaint_policy_type_to_string(policy->type());
+    }
+
+    bool set_repaint_policy(QString const& name)
+    {
+        auto const type = repaint_policy_type_from_string(name);
+        if (!type) {
+            return false;
+        }
+        set_repaint_policy(*type);
+        return true;
+    }
+
+    render::frame_timing timings;
+    std::unique_ptr<repaint_policy> policy{
+        create_repaint_policy(repaint_policy_type::percentile)};
+
+    // The vblank the frame currently being presented targets.
+    std::chrono::nanoseconds present_target{0};
+
 private:
     template<typename Win>
     bool prepare_repaint(Win* win)
@@ -456,9 +528,25 @@ private:
         return std::chrono::nanoseconds(1000 * 1000 * (1000 * 1000 / base.refresh_rate()));
     }
 
+    std::chrono::nanoseconds next_vblank(std::chrono::nanoseconds now) const
+    {
+        if (last_presentation.when <= std::chrono::nanoseconds::zero()) {
+            return {};
+        }
+
+        auto const refresh = last_presentation.refresh > std::chrono::nanoseconds::zero()
+            ? last_presentation.refresh
+            : refresh_length();
+        auto const cycles = (now - last_presentation.when) / refresh + 1;
+
+        return last_presentation.when + cycles * refresh;
+    }
+
     void timerEvent(QTimerEvent* event) override
     {
         if (event->timerId() == delay_timer.timerId()) {
+            timings.slack.add(std::chrono::steady_clock::now().time_since_epoch()
+                              - delay_timer_target);
             run();
             return;
         }
@@ -476,9 +564,10 @@ private:
     // Compositing delay.
     std::chrono::nanoseconds delay{0};
 
-    presentation_data last_presentation;
-    duration_record paint_durations;
-    duration_record render_durations;
+    // When the delay timer is expected to fire.
+    std::chrono::nanoseconds delay_timer_target{0};
+
+    presentation_data last_presentation{};
 
     // Used for debugging rendering time.
     std::chrono::nanoseconds swap_ref_time{};
@@ -10,6 +10,7 @@
 #include <como/render/backend/wlroots/backend.h>
 #include <como/render/compositor_start.h>
 #include <como/render/dbus/compositing.h>
+#include <como/render/dbus/frame_timing.h>
 #include <como/render/gl/backend.h>
 #include <como/render/gl/egl_data.h>
 #include <como/render/gl/scene.h>
@@ -55,6 +56,7 @@ public:
                 base.server->display.get());
         })}
         , dbus{std::make_unique<dbus::compositing<type>>(*this)}
+        , frame_timing_dbus{std::make_unique<dbus::frame_timing<type>>(*this)}
     {
         singleton_interface::get_egl_data = [this] { return egl_data; };
 
@@ -309,6 +311,7 @@ public:
 private:
     int locked{0};
     std::unique_ptr<dbus::compositing<type>> dbus;
+    std::unique_ptr<dbus::frame_timing<type>> frame_timing_dbus;
 };
 
 }
@@ -0,0 +1,155 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/render/frame_timing.h>
+
+#include <QString>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+namespace como::render::wayland
+{
+
+enum class repaint_policy_type {
+    // Reserve the maximum of recent paint and render times plus a fixed hardware margin.
+    max,
+    // Reserve a high percentile of recent paint and render times plus a hardware margin that
+    // adapts to missed vblanks.
+    percentile,
+};
+
+/**
+ * Decides how much time before the next vblank an output reserves for painting, rendering and
+ * putting the result onto the scanout buffer.
+ */
+class repaint_policy
+{
+public:
+    virtual ~repaint_policy() = default;
+
+    virtual repaint_policy_type type() const = 0;
+
+    /**
+     * The time reserved before the next vblank. The smaller the margin the later we paint and
+     * the lower the latency, but the higher the chance to miss the vblank.
+     */
+    virtual std::chrono::nanoseconds margin(std::chrono::nanoseconds refresh,
+                                            render::frame_timing const& timings)
+        = 0;
+
+    /**
+     * Feedback on a presented frame. The frame @p missed its targeted vblank when it was
+     * presented at a later one.
+     */
+    virtual void presented(bool /*missed*/, std::chrono::nanoseconds /*refresh*/)
+    {
+    }
+};
+
+class max_repaint_policy : public repaint_policy
+{
+public:
+    repaint_policy_type type() const override
+    {
+        return repaint_policy_type::max;
+    }
+
+    std::chrono::nanoseconds margin(std::chrono::nanoseconds refresh,
+                                    render::frame_timing const& timings) override
+    {
+        // Some relative gap to factor in the unknown time the hardware needs to put a rendered
+        // image onto the scanout buffer.
+        auto const hw_margin = refresh / 10;
+        return hw_margin + timings.paint.max() + timings.render.max();
+    }
+};
+
+class percentile_repaint_policy : public repaint_policy
+{
+public:
+    explicit percentile_repaint_policy(double percentile = 95.)
+        : percentile{percentile}
+    {
+    }
+
+    repaint_policy_type type() const override
+    {
+        return repaint_policy_type::percentile;
+    }
+
+    std::chrono::nanoseconds margin(std::chrono::nanoseconds refresh,
+                                    render::frame_timing const& timings) override
+    {
+        return refresh / 20 + safety + timings.paint.percentile(percentile)
+            + timings.render.percentile(percentile);
+    }
+
+    void presented(bool missed, std::chrono::nanoseconds refresh) override
+    {
+        if (missed) {
+            // Back off quickly.
+            safety = std::min(safety + refresh / 10, refresh / 2);
+            return;
+        }
+
+        // And approach the vblank again slowly. From the maximum it takes around 500 frames.
+        safety -= std::min(safety, refresh / 1000);
+    }
+
+    double const percentile;
+
+    /// Additional margin grown on missed vblanks.
+    std::chrono::nanoseconds safety{0};
+};
+
+inline std::unique_ptr<repaint_policy> create_repaint_policy(repaint_policy_type type)
+{
+    switch (type) {
+    case repaint_policy_type::max:
+        return std::make_unique<max_repaint_policy>();
+    case repaint_policy_type::percentile:
+        return std::make_unique<percentile_repaint_policy>();
+    }
+    return {};
+}
+
+inline QString repaint_policy_type_to_string(repaint_policy_type type)
+{
+    switch (type) {
+    case repaint_policy_type::max:
+        return QStringLiteral("max");
+    case repaint_policy_type::percentile:
+        return QStringLiteral("percentile");
+    }
+    return {};
+}
+
+inline std::optional<repaint_policy_type> repaint_policy_type_from_string(QString const& name)
+{
+    if (name == QStringLiteral("max")) {
+        return repaint_policy_type::max;
+    }
+    if (name == QStringLiteral("percentile")) {
+        return repaint_policy_type::percentile;
+    }
+    return {};
+}
+
+/**
+ * Whether a frame presented at @p when missed the vblank at @p target. Presentation times are
+ * only precise up to the vblank. So a miss means being late by at least half a refresh cycle.
+ */
+inline bool presentation_missed(std::chrono::nanoseconds target,
+                                std::chrono::nanoseconds when,
+                                std::chrono::nanoseconds refresh)
+{
+    return when - target > refresh / 2;
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/base/wayland/output_transform.h>
+#include <como/utils/algorithm.h>
+#include <como/win/deco.h>
+#include <como/win/geo.h>
+#include <como/win/scene.h>
+
+#include <Wrapland/Server/buffer.h>
+#include <Wrapland/Server/linux_dmabuf_v1.h>
+#include <Wrapland/Server/surface.h>
+#include <deque>
+#include <optional>
+
+namespace como::render::wayland
+{
+
+/**
+ * Whether a client buffer can be shown on @p out as is. On a rotated or flipped output the logical
+ * geometry and the mode size may still match the buffer, but it would be shown transformed.
+ */
+template<typename Output>
+bool is_scanout_output(Output const& out)
+{
+    return out.base.transform() == base::wayland::output_transform::normal;
+}
+
+/**
+ * Whether the buffer of @p win can be shown on @p out as is. The window must cover the output
+ * exactly with an opaque dmabuf of the output's mode size that needs no transformation or scaling.
+ */
+template<typename Output, typename Win>
+bool is_scanout_capable(Output const& out, Win* win)
+{
+    if constexpr (requires(Win * win) { win->surface; }) {
+        if (!is_scanout_output(out)) {
+            return false;
+        }
+        if (!win->surface || win->transient->annexed || win::decoration(win)) {
+            return false;
+        }
+        if (win->opacity() < 1.) {
+            return false;
+        }
+
+        auto const out_geo = out.base.geometry();
+        if (win::render_geometry(win) != out_geo) {
+            return false;
+        }
+        if (win::has_alpha(*win)
+            && !win->render_data.opaque_region.contains(QRect({}, out_geo.size()))) {
+            return false;
+        }
+
+        auto const& state = win->surface->state();
+        if (!state.buffer || !state.children.empty() || state.source_rectangle.isValid()
+            || state.destination_size.isValid()
+            || state.transform != Wrapland::Server::output_transform::normal) {
+            // The buffer would be cropped, scaled by a viewport or transformed.
+            return false;
+        }
+
+        auto dmabuf = state.buffer->linuxDmabufBuffer();
+        if (!dmabuf || dmabuf->size != out.base.mode_size()
+            || (dmabuf->flags & Wrapland::Server::linux_dmabuf_flag_v1::y_inverted)) {
+            return false;
+        }
+
+        return true;
+    } else {
+        return false;
+    }
+}
+
+/**
+ * Returns the window that can be shown on @p out instead of compositing @p windows. That is the
+ * case when the topmost window painted on the output is scanout capable and no effect requires
+ * compositing.
+ */
+template<typename Output, typename Window>
+std::optional<Window> get_scanout_candidate(Output const& out, std::deque<Window> const& windows)
+{
+    auto& platform = out.platform;
+
+    if (!is_scanout_output(out) || platform.effects->blocks_direct_scanout()) {
+        return {};
+    }
+    if constexpr (requires { platform.software_cursor; }) {
+        if (platform.software_cursor && platform.software_cursor->enabled) {
+            return {};
+        }
+    }
+
+    auto const out_geo = out.base.geometry();
+
+    for (auto it = windows.rbegin(); it != windows.rend(); ++it) {
+        auto candidate = std::visit(overload{[&](auto&& win) -> std::optional<bool> {
+                                        if (!win->render || !win->render->isPaintingEnabled()
+                                            || !win::visible_rect(win).intersects(out_geo)) {
+                                            // Not visible on the output. Check the next one.
+                                            return {};
+                                        }
+                                        return is_scanout_capable(out, win);
+                                    }},
+                                    *it);
+        if (candidate) {
+            if (*candidate) {
+                return *it;
+            }
+            return {};
+        }
+    }
+
+    return {};
+}
+
+}
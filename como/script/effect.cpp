@@ -7,6 +7,7 @@
 #include "effect.h"
 
 #include "space.h"
+#include "utils.h"
 
 #include <como/base/options.h>
 #include <como/input/platform.h>
@@ -21,6 +22,7 @@
 #include <kconfigloader.h>
 
 #include <QAction>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QQmlEngine>
 #include <QStandardPaths>
@@ -199,6 +201,10 @@ bool effect::init(QString const& effectName, QString const& pathToScript, KShare
         qCDebug(KWIN_SCRIPTING) << "Could not open script file: " << pathToScript;
         return false;
     }
+
+    QElapsedTimer load_timer;
+    load_timer.start();
+
     m_effectName = effectName;
     m_scriptFile = pathToScript;
 
@@ -262,6 +268,7 @@ bool effect::init(QString const& effectName, QString const& pathToScript, KShare
     }
 
     const QJSValue result = m_engine->evaluate(QString::fromUtf8(scriptFile.readAll()));
+    m_loadTime = load_timer.elapsed();
 
     if (result.isError()) {
         qCWarning(KWIN_SCRIPTING,
@@ -286,6 +293,16 @@ QString effect::pluginId() const
     return m_effectName;
 }
 
+qint64 effect::loadTime() const
+{
+    return m_loadTime;
+}
+
+qint64 effect::heapSize() const
+{
+    return js_heap_size(*m_engine);
+}
+
 bool effect::isActiveFullScreenEffect() const
 {
     return effects.activeFullScreenEffect() == this;
@@ -48,6 +48,14 @@ class COMO_EXPORT effect : public como::AnimationEffect
      */
     Q_PROPERTY(bool isActiveFullScreenEffect READ isActiveFullScreenEffect NOTIFY
                    isActiveFullScreenEffectChanged)
+    /**
+     * Time in milliseconds spent on compiling and evaluating the script
+     */
+    Q_PROPERTY(qint64 loadTime READ loadTime CONSTANT)
+    /**
+     * Memory in bytes held by the script's JavaScript heap or -1 if not available in this build
+     */
+    Q_PROPERTY(qint64 heapSize READ heapSize)
 
 public:
     // copied from render/effect/interface.h
@@ -240,6 +248,8 @@ public:
 
     QString pluginId() const;
     bool isActiveFullScreenEffect() const;
+    qint64 loadTime() const;
+    qint64 heapSize() const;
 
 public Q_SLOTS:
     bool borderActivated(ElectricBorder border) override;
@@ -281,6 +291,7 @@ private:
     QHash<int, QJSValueList> m_realtimeScreenEdgeCallbacks;
     KConfigLoader* m_config{nullptr};
     int m_chainPosition{0};
+    qint64 m_loadTime{0};
     Effect* m_activeFullScreenEffect = nullptr;
 
     std::unordered_map<uint, std::unique_ptr<GLShader>> m_shaders;
@@ -21,6 +21,7 @@
 #include <QDBusConnection>
 #include <QDBusMessage>
 #include <QDBusPendingCallWatcher>
+#include <QElapsedTimer>
 #include <QFutureWatcher>
 #include <QMenu>
 #include <QQmlComponent>
@@ -170,6 +171,9 @@ void script::slotScriptLoadedFromFile()
         return;
     }
 
+    QElapsedTimer load_timer;
+    load_timer.start();
+
     // Install console functions (e.g. console.assert(), console.log(), etc).
     m_engine->installExtensions(QJSEngine::ConsoleExtension);
 
@@ -244,6 +248,8 @@ void script::slotScriptLoadedFromFile()
         deleteLater();
     }
 
+    m_loadTime = load_timer.elapsed();
+
     if (m_invocationContext.type() == QDBusMessage::MethodCallMessage) {
         auto reply = m_invocationContext.createReply();
         QDBusConnection::sessionBus().send(reply);
@@ -255,6 +261,11 @@ void script::slotScriptLoadedFromFile()
     m_starting = false;
 }
 
+qint64 script::heapSize() const
+{
+    return js_heap_size(*m_engine);
+}
+
 QVariant script::readConfig(const QString& key, const QVariant& defaultValue)
 {
     return config().readEntry(key, defaultValue);
@@ -562,7 +573,11 @@ void declarative_script::run()
         return;
     }
 
+    QElapsedTimer load_timer;
+    load_timer.start();
     m_component->loadUrl(QUrl::fromLocalFile(fileName()));
+    m_loadTime = load_timer.elapsed();
+
     if (m_component->isLoading()) {
         connect(
             m_component, &QQmlComponent::statusChanged, this, &declarative_script::createComponent);
@@ -576,9 +591,12 @@ void declarative_script::createComponent()
     if (m_component->isError()) {
         qCWarning(KWIN_SCRIPTING) << "Component failed to load: " << m_component->errors();
     } else {
+        QElapsedTimer load_timer;
+        load_timer.start();
         if (QObject* object = m_component->create(m_context)) {
             object->setParent(this);
         }
+        m_loadTime += load_timer.elapsed();
     }
     setRunning(true);
 }
@@ -41,6 +41,13 @@ class window;
 class COMO_EXPORT abstract_script : public QObject
 {
     Q_OBJECT
+
+    /// Time in milliseconds spent on compiling and evaluating the script.
+    Q_PROPERTY(qint64 loadTime READ loadTime)
+
+    /// Memory in bytes held by the script's JavaScript heap or -1 if not available in this build.
+    Q_PROPERTY(qint64 heapSize READ heapSize)
+
 public:
     abstract_script(int id,
                     QString scriptName,
@@ -64,6 +71,15 @@ public:
     {
         return m_running;
     }
+    qint64 loadTime() const
+    {
+        return m_loadTime;
+    }
+    virtual qint64 heapSize() const
+    {
+        // Declarative scripts share the QML engine and have no heap of their own.
+        return 0;
+    }
 
     KConfigGroup config() const;
 
@@ -84,6 +100,8 @@ protected:
         Q_EMIT runningChanged(m_running);
     }
 
+    qint64 m_loadTime{0};
+
 private:
     int m_scriptId;
     QString m_fileName;
@@ -106,6 +124,8 @@ public:
            QObject* parent = nullptr);
     virtual ~script();
 
+    qint64 heapSize() const override;
+
     Q_INVOKABLE QVariant readConfig(const QString& key, const QVariant& defaultValue = QVariant());
 
     Q_INVOKABLE void callDBus(const QString& service,
@@ -7,9 +7,17 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "scripting_logging.h"
 
+#include <como/base/config-como.h>
+
 #include <QDBusArgument>
 #include <QDBusObjectPath>
 #include <QDBusSignature>
+#include <QJSEngine>
+
+#if HAVE_SCRIPT_HEAP_SIZE
+#include <private/qv4engine_p.h>
+#include <private/qv4mm_p.h>
+#endif
 
 namespace como::scripting
 {
@@ -72,4 +80,15 @@ QVariant dbusToVariant(const QVariant& variant)
     return variant;
 }
 
+qint64 js_heap_size([[maybe_unused]] QJSEngine& engine)
+{
+#if HAVE_SCRIPT_HEAP_SIZE
+    auto const& memory = *engine.handle()->memoryManager;
+    return static_cast<qint64>(memory.getAllocatedMem() + memory.getLargeItemsMem());
+#else
+    // There is no public API for the heap size.
+    return -1;
+#endif
+}
+
 }
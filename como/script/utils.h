@@ -6,10 +6,16 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
 #include <QVariant>
+#include <QtGlobal>
+
+class QJSEngine;
 
 namespace como::scripting
 {
 
 QVariant dbusToVariant(const QVariant& variant);
 
+/// Memory held by the JavaScript heap of @p engine in bytes or -1 if the build does not support it.
+qint64 js_heap_size(QJSEngine& engine);
+
 }
@@ -15,6 +15,7 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <algorithm>
 
 namespace como::win::rules
 {
@@ -39,6 +40,7 @@ void book::deleteAll()
 {
     qDeleteAll(m_rules);
     m_rules.clear();
+    invalidate_index();
 }
 
 void book::load()
@@ -53,6 +55,7 @@ void book::load()
 
     settings->load();
     m_rules = settings->rules();
+    invalidate_index();
 }
 
 void book::save()
@@ -71,6 +74,67 @@ void book::requestDiskStorage()
     m_updateTimer->start();
 }
 
+std::vector<size_t> book::get_candidates(QByteArray const& res_class, QByteArray const& res_name)
+{
+    update_index();
+
+    auto get = [](auto const& map, auto const& key) -> std::vector<size_t> const* {
+        auto it = map.constFind(key);
+        return it == map.constEnd() ? nullptr : &*it;
+    };
+
+    auto const by_class = get(index.by_class, res_class);
+    auto const by_complete_class = get(index.by_complete_class, res_name + ' ' + res_class);
+
+    if (!by_class && !by_complete_class) {
+        return index.others;
+    }
+
+    std::vector<size_t> ret;
+    auto add = [&ret](auto const* indices) {
+        if (!indices) {
+            return;
+        }
+        auto const size = ret.size();
+        ret.insert(ret.end(), indices->begin(), indices->end());
+        std::inplace_merge(ret.begin(), ret.begin() + size, ret.end());
+    };
+
+    ret = index.others;
+    add(by_class);
+    add(by_complete_class);
+    return ret;
+}
+
+void book::invalidate_index()
+{
+    index.valid = false;
+}
+
+void book::update_index()
+{
+    if (index.valid) {
+        return;
+    }
+
+    index.by_class.clear();
+    index.by_complete_class.clear();
+    index.others.clear();
+
+    for (size_t i = 0; i < m_rules.size(); i++) {
+        auto const rule = m_rules.at(i);
+        if (rule->wmclass.match != name_match::exact) {
+            index.others.push_back(i);
+        } else if (rule->wmclasscomplete) {
+            index.by_complete_class[rule->wmclass.data].push_back(i);
+        } else {
+            index.by_class[rule->wmclass.data].push_back(i);
+        }
+    }
+
+    index.valid = true;
+}
+
 void book::setUpdatesDisabled(bool disable)
 {
     m_updatesDisabled = disable;
@@ -9,8 +9,11 @@
 #include <como/win/rules/book_settings.h>
 #include <como/win/rules/window.h>
 
+#include <QByteArray>
+#include <QHash>
 #include <QTimer>
 #include <deque>
+#include <vector>
 
 namespace como::win::rules
 {
@@ -39,12 +42,32 @@ public:
 
     void requestDiskStorage();
 
+    /**
+     * Indices of the rules in m_rules that might match a window with class @p res_class and name
+     * @p res_name. Rules requiring another window class exactly are left out. The indices are
+     * sorted.
+     */
+    std::vector<size_t> get_candidates(QByteArray const& res_class, QByteArray const& res_name);
+
+    /// Must be called when m_rules changed.
+    void invalidate_index();
+
     std::unique_ptr<book_qobject> qobject;
     std::unique_ptr<book_settings> settings;
     std::deque<ruling*> m_rules;
 
 private:
     void deleteAll();
+    void update_index();
+
+    struct {
+        // Rules matching the window class exactly.
+        QHash<QByteArray, std::vector<size_t>> by_class;
+        // Rules matching the window name and class exactly.
+        QHash<QByteArray, std::vector<size_t>> by_complete_class;
+        std::vector<size_t> others;
+        bool valid{false};
+    } index;
 
     QTimer* m_updateTimer;
     bool m_updatesDisabled;
@@ -31,6 +31,7 @@ void discard_used_rules(Book& book, RefWin& ref_win, bool withdrawn)
                 ref_win.control->remove_rule(*it);
                 auto r = *it;
                 it = book.m_rules.erase(it);
+                book.invalidate_index();
                 delete r;
                 if (index) {
                     book.settings->removeRuleSettingsAt(index.value());
@@ -79,15 +79,15 @@ window find_window(Book& book, RefWin& ref_win)
 {
     std::vector<ruling*> ret;
 
-    for (auto it = book.m_rules.begin(); it != book.m_rules.end();) {
-        if (match_rule(**it, ref_win)) {
-            auto rule = *it;
+    auto const candidates
+        = book.get_candidates(ref_win.meta.wm_class.res_class, ref_win.meta.wm_class.res_name);
+
+    for (auto index : candidates) {
+        auto rule = book.m_rules.at(index);
+        if (match_rule(*rule, ref_win)) {
             qCDebug(KWIN_CORE) << "Rule found:" << rule << ":" << &ref_win;
-            ++it;
             ret.push_back(rule);
-            continue;
         }
-        ++it;
     }
 
     return rules::window(ret);
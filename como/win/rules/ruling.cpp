@@ -290,6 +290,25 @@ bool ruling::matchType(win_type match_type) const
     return true;
 }
 
+static bool regex_matches(ruling::bytes_match const& match, QByteArray const& subject)
+{
+    if (match.regex_data != match.data) {
+        match.regex_data = match.data;
+        match.regex.setPattern(QString::fromUtf8(match.data));
+        match.regex.optimize();
+    }
+    return match.regex.match(QString::fromUtf8(subject)).hasMatch();
+}
+
+static bool regex_matches(ruling::string_match const& match, QString const& subject)
+{
+    if (match.regex.pattern() != match.data) {
+        match.regex.setPattern(match.data);
+        match.regex.optimize();
+    }
+    return match.regex.match(subject).hasMatch();
+}
+
 bool ruling::matchWMClass(QByteArray const& match_class, QByteArray const& match_name) const
 {
     if (wmclass.match != name_match::unimportant) {
@@ -301,10 +320,7 @@ bool ruling::matchWMClass(QByteArray const& match_class, QByteArray const& match
         }
         cwmclass.append(match_class);
 
-        if (wmclass.match == name_match::regex
-            && !QRegularExpression(QString::fromUtf8(wmclass.data))
-                    .match(QString::fromUtf8(cwmclass))
-                    .hasMatch()) {
+        if (wmclass.match == name_match::regex && !regex_matches(wmclass, cwmclass)) {
             return false;
         }
         if (wmclass.match == name_match::exact && wmclass.data != cwmclass)
@@ -318,10 +334,7 @@ bool ruling::matchWMClass(QByteArray const& match_class, QByteArray const& match
 bool ruling::matchRole(QByteArray const& match_role) const
 {
     if (windowrole.match != name_match::unimportant) {
-        if (windowrole.match == name_match::regex
-            && !QRegularExpression(QString::fromUtf8(windowrole.data))
-                    .match(QString::fromUtf8(match_role))
-                    .hasMatch()) {
+        if (windowrole.match == name_match::regex && !regex_matches(windowrole, match_role)) {
             return false;
         }
         if (windowrole.match == name_match::exact && windowrole.data != match_role)
@@ -335,8 +348,7 @@ bool ruling::matchRole(QByteArray const& match_role) const
 bool ruling::matchTitle(QString const& match_title) const
 {
     if (title.match != name_match::unimportant) {
-        if (title.match == name_match::regex
-            && !QRegularExpression(title.data).match(match_title).hasMatch()) {
+        if (title.match == name_match::regex && !regex_matches(title, match_title)) {
             return false;
         }
         if (title.match == name_match::exact && title.data != match_title)
@@ -354,9 +366,7 @@ bool ruling::matchClientMachine(QByteArray const& match_machine, bool local) con
         if (match_machine != "localhost" && local && matchClientMachine("localhost", true))
             return true;
         if (clientmachine.match == name_match::regex
-            && !QRegularExpression(QString::fromUtf8(clientmachine.data))
-                    .match(QString::fromUtf8(match_machine))
-                    .hasMatch()) {
+            && !regex_matches(clientmachine, match_machine)) {
             return false;
         }
         if (clientmachine.match == name_match::exact && clientmachine.data != match_machine)
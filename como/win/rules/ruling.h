@@ -9,6 +9,7 @@
 #include "types.h"
 
 #include <QRect>
+#include <QRegularExpression>
 
 #include <como/base/options.h>
 #include <como/win/subspace.h>
@@ -133,10 +134,16 @@ public:
     struct bytes_match {
         QByteArray data;
         name_match match{name_match::unimportant};
+
+        // Compiled once on first regex match and again only when the data changes.
+        mutable QByteArray regex_data;
+        mutable QRegularExpression regex;
     };
     struct string_match {
         QString data;
         name_match match{name_match::unimportant};
+
+        mutable QRegularExpression regex;
     };
 
     bytes_match wmclass;
@@ -5,9 +5,12 @@
 */
 #pragma once
 
+#include "desktop_get.h"
 #include "move.h"
 #include "space_areas.h"
 
+#include <algorithm>
+
 namespace como::win
 {
 
@@ -57,16 +60,19 @@ void update_space_areas_impl(Space& space, bool force)
 
     space.update_space_area_from_windows(desktop_area, screens_geos, new_areas);
 
-    auto changed = force || space.areas.screen.empty();
+    auto const full_update = force || space.areas.screen.empty()
+        || space.areas.work.size() != new_areas.work.size();
 
-    for (int desktop = 1; !changed && desktop <= desktops_count; ++desktop) {
-        changed |= space.areas.work[desktop] != new_areas.work[desktop];
-        changed |= space.areas.restrictedmove[desktop] != new_areas.restrictedmove[desktop];
-        changed |= space.areas.screen[desktop].size() != new_areas.screen[desktop].size();
+    // Windows only depend on the areas of their own subspaces. To not re-check all windows when
+    // a strut changes only the subspaces with changed areas are tracked.
+    std::vector<bool> changed_subspaces(desktops_count + 1, full_update);
+    auto changed = full_update;
 
-        for (size_t screen = 0; !changed && screen < screens_count; screen++) {
-            changed |= new_areas.screen[desktop][screen] != space.areas.screen[desktop][screen];
-        }
+    for (int desktop = 1; !full_update && desktop <= desktops_count; ++desktop) {
+        changed_subspaces[desktop] = space.areas.work[desktop] != new_areas.work[desktop]
+            || space.areas.restrictedmove[desktop] != new_areas.restrictedmove[desktop]
+            || space.areas.screen[desktop] != new_areas.screen[desktop];
+        changed |= changed_subspaces[desktop];
     }
 
     if (changed) {
@@ -77,9 +83,22 @@ void update_space_areas_impl(Space& space, bool force)
             space.update_work_area();
         }
 
+        auto is_affected = [&](auto win) {
+            if (on_all_subspaces(*win)) {
+                return true;
+            }
+            return std::any_of(win->topo.subspaces.cbegin(),
+                               win->topo.subspaces.cend(),
+                               [&](auto sub) {
+                                   auto const x11_id = static_cast<int>(sub->x11DesktopNumber());
+                                   return x11_id < 1 || x11_id > desktops_count
+                                       || changed_subspaces[x11_id];
+                               });
+        };
+
         for (auto win : space.windows) {
             std::visit(overload{[&](auto&& win) {
-                           if (win->control) {
+                           if (win->control && is_affected(win)) {
                                check_workspace_position(win);
                            }
                        }},
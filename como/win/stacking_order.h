@@ -22,20 +22,30 @@
 namespace como::win
 {
 
+/**
+ * Returns the windows to composite from bottom to top. The list is cached and only rebuilt after
+ * the stacking order or the render overlays changed. The returned reference stays valid until the
+ * next call.
+ */
 template<typename Order>
-auto render_stack(Order& order)
+auto const& render_stack(Order& order)
 {
     if (order.render_restack_required) {
         order.render_restack_required = false;
         order.render_overlays = {};
         Q_EMIT order.qobject->render_restack();
+        order.invalidate_render_stack();
     }
 
-    auto stack = order.stack;
-    std::copy(std::begin(order.render_overlays),
-              std::end(order.render_overlays),
-              std::back_inserter(stack));
-    return stack;
+    if (order.render_stack_dirty) {
+        order.render_stack_dirty = false;
+        order.render_list = order.stack;
+        std::copy(std::begin(order.render_overlays),
+                  std::end(order.render_overlays),
+                  std::back_inserter(order.render_list));
+    }
+
+    return order.render_list;
 }
 
 class COMO_EXPORT stacking_order_qobject : public QObject
@@ -116,6 +126,12 @@ public:
         unlock();
     }
 
+    /// Must be called when @ref stack or @ref render_overlays are changed directly.
+    void invalidate_render_stack()
+    {
+        render_stack_dirty = true;
+    }
+
     std::unique_ptr<stacking_order_qobject> qobject;
 
     /// How windows are configured in z-direction. Topmost window at back.
@@ -128,6 +144,10 @@ public:
 
     bool render_restack_required{false};
 
+    /// Cached result of @ref render_stack.
+    std::deque<Window> render_list;
+    bool render_stack_dirty{true};
+
 private:
     template<typename Win>
     static bool needs_child_restack(Win const* lead, Win const* child)
@@ -196,7 +216,10 @@ private:
         }
 
         auto order_changed = this->stack != stack;
-        this->stack = stack;
+        if (order_changed) {
+            this->stack = stack;
+            invalidate_render_stack();
+        }
         return order_changed;
     }
 
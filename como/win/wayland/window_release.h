@@ -37,6 +37,7 @@ void destroy_window(Win* win)
         remove_all(win->space.windows, var_win(win));
         remove_all(win->space.stacking.order.pre_stack, var_win(win));
         remove_all(win->space.stacking.order.stack, var_win(win));
+        win->space.stacking.order.invalidate_render_stack();
         delete win;
         return;
     }
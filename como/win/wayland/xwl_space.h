@@ -270,6 +270,8 @@ public:
 
     std::vector<window_t> windows;
     std::unordered_map<uint32_t, window_t> windows_map;
+    std::unordered_map<xcb_window_t, x11_window*> xcb_windows_map;
+    std::vector<std::unique_ptr<x11::window_prefetch>> map_requests;
     std::vector<win::x11::group<type>*> groups;
 
     stacking_state<window_t> stacking;
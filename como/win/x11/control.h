@@ -6,6 +6,7 @@
 #pragma once
 
 #include "command.h"
+#include "window_find.h"
 
 #include <como/win/control.h>
 #include <como/win/input.h>
@@ -120,7 +121,7 @@ public:
             control_t::destroy_decoration();
             move(m_window, grav);
         }
-        m_window->xcb_windows.input.reset();
+        update_xcb_windows(*m_window, [this] { m_window->xcb_windows.input.reset(); });
     }
 
     QSize adjusted_frame_size(QSize const& frame_size, size_mode mode) override
@@ -17,6 +17,7 @@
 #include "user_time.h"
 #include "win_info.h"
 #include "window_create.h"
+#include "window_prefetch.h"
 #include "xcb.h"
 
 #include <como/base/logging.h>
@@ -42,7 +43,8 @@ void embed_client(Win* win, xcb_visualid_t visualid, xcb_colormap_t colormap, ui
     // We don't want the window to be destroyed when we quit
     xcb_change_save_set(conn, XCB_SET_MODE_INSERT, win->xcb_windows.client);
 
-    win->xcb_windows.client.select_input(zero_value);
+    // Keep property changes selected so that the prefetched properties stay valid.
+    win->xcb_windows.client.select_input(XCB_EVENT_MASK_PROPERTY_CHANGE);
     win->xcb_windows.client.unmap();
     win->xcb_windows.client.set_border_width(zero_value);
 
@@ -636,19 +638,25 @@ void init_controlled_window(Win& win, bool isMapped, QRect const& client_geo)
  * Returns false if KWin is not going to manage this window.
  */
 template<typename Space>
-auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space) ->
+auto create_controlled_window(window_prefetch& prefetch, bool isMapped, Space& space) ->
     typename Space::x11_window*
 {
     using Win = typename Space::x11_window;
 
     blocker block(space.stacking.order);
 
-    base::x11::xcb::window_attributes attr(space.base.x11_data.connection, xcb_win);
-    base::x11::xcb::geometry windowGeometry(space.base.x11_data.connection, xcb_win);
+    auto const xcb_win = prefetch.window;
+    auto& attr = prefetch.attributes;
+    auto& windowGeometry = prefetch.geometry;
     if (attr.is_null() || windowGeometry.is_null()) {
         return nullptr;
     }
 
+    if (!prefetch.properties) {
+        prefetch_window_properties(space, prefetch);
+    }
+    auto& props = *prefetch.properties;
+
     auto win = new Win(xcb_win, space);
 
     // So that decorations don't start with size being (0,0).
@@ -725,29 +733,10 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     win->xcb_visual = attr->visual;
     win->render_data.bit_depth = windowGeometry->depth;
 
-    const net::Properties properties = net::WMDesktop | net::WMState | net::WMWindowType
-        | net::WMStrut | net::WMName | net::WMIconGeometry | net::WMIcon | net::WMPid
-        | net::WMIconName;
-    const net::Properties2 properties2 = net::WM2BlockCompositing | net::WM2WindowClass
-        | net::WM2WindowRole | net::WM2UserTime | net::WM2ExtendedStrut | net::WM2Opacity
-        | net::WM2FullscreenMonitors | net::WM2GroupLeader | net::WM2Urgency | net::WM2Input
-        | net::WM2Protocols | net::WM2InitialMappingState | net::WM2IconPixmap
-        | net::WM2OpaqueRegion | net::WM2DesktopFileName | net::WM2GTKFrameExtents
-        | net::WM2GTKApplicationId;
-
-    auto wmClientLeaderCookie = fetch_wm_client_leader(*win);
-    auto skipCloseAnimationCookie = fetch_skip_close_animation(*win);
-    auto showOnScreenEdgeCookie = fetch_show_on_screen_edge(win);
-    auto transientCookie = fetch_transient(win);
-
-    win->geometry_hints.init(win->xcb_windows.client);
-    win->motif_hints.init(win->xcb_windows.client);
-
-    win->net_info = new win_info<Win>(win,
-                                      win->xcb_windows.client,
-                                      win->space.base.x11_data.root_window,
-                                      properties,
-                                      properties2);
+    win->geometry_hints.init(win->xcb_windows.client, props.normal_hints);
+    win->motif_hints.init(win->xcb_windows.client, props.motif_hints);
+
+    win->net_info = new win_info<Win>(win, win->space.base.x11_data.root_window, props.info);
 
     if (is_desktop(win) && win->render_data.bit_depth == 32) {
         // force desktop windows to be opaque. It's a desktop after all, there is no window
@@ -757,7 +746,7 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     win->colormap = attr->colormap;
 
     fetch_wm_class(*win);
-    read_wm_client_leader(*win, wmClientLeaderCookie);
+    read_wm_client_leader(*win, props.wm_client_leader);
     fetch_wm_client_machine(*win);
     get_sync_counter(win);
 
@@ -788,7 +777,7 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     update_allowed_actions(win);
 
     win->transient->set_modal((win->net_info->state() & net::Modal) != 0);
-    read_transient_property(win, transientCookie);
+    read_transient_property(win, props.transient);
 
     QByteArray desktopFileName{win->net_info->desktopFileName()};
     if (desktopFileName.isEmpty()) {
@@ -805,7 +794,7 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     win->geometry_hints.read();
     get_motif_hints(win, true);
     fetch_wm_opaque_region(*win);
-    set_skip_close_animation(*win, skipCloseAnimationCookie.to_bool());
+    set_skip_close_animation(*win, props.skip_close_animation.to_bool());
 
     // TODO: Try to obey all state information from net_info->state()
 
@@ -850,7 +839,7 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     win->updateWindowRules(rules::type::all);
 
     win->setBlockingCompositing(win->net_info->isBlockingCompositing());
-    read_show_on_screen_edge(win, showOnScreenEdgeCookie);
+    read_show_on_screen_edge(win, props.show_on_screen_edge);
 
     // Forward all opacity values to the frame in case there'll be other CM running.
     auto comp_qobject = win->space.base.mod.render->qobject.get();
@@ -874,4 +863,13 @@ auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space)
     add_controlled_window_to_space(space, win);
     return win;
 }
+
+template<typename Space>
+auto create_controlled_window(xcb_window_t xcb_win, bool isMapped, Space& space) ->
+    typename Space::x11_window*
+{
+    auto prefetch = prefetch_window(space, xcb_win);
+    return create_controlled_window(*prefetch, isMapped, space);
+}
+
 }
@@ -7,6 +7,7 @@
 
 #include "net/net.h"
 #include "types.h"
+#include "window_find.h"
 
 #include "hidden_preview.h"
 #include <como/base/options.h>
@@ -56,7 +57,9 @@ void update_input_window(Win* win, QRect const& frame_geo)
     }
 
     if (region.isEmpty()) {
-        win->xcb_windows.input.reset();
+        if (win->xcb_windows.input.is_valid()) {
+            update_xcb_windows(*win, [win] { win->xcb_windows.input.reset(); });
+        }
         return;
     }
 
@@ -75,12 +78,14 @@ void update_input_window(Win* win, QRect const& frame_geo)
                                    XCB_EVENT_MASK_ENTER_WINDOW | XCB_EVENT_MASK_LEAVE_WINDOW
                                        | XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE
                                        | XCB_EVENT_MASK_POINTER_MOTION};
-        win->xcb_windows.input.create(win->space.base.x11_data.connection,
-                                      win->space.base.x11_data.root_window,
-                                      bounds,
-                                      XCB_WINDOW_CLASS_INPUT_ONLY,
-                                      mask,
-                                      values);
+        update_xcb_windows(*win, [&] {
+            win->xcb_windows.input.create(win->space.base.x11_data.connection,
+                                          win->space.base.x11_data.root_window,
+                                          bounds,
+                                          XCB_WINDOW_CLASS_INPUT_ONLY,
+                                          mask,
+                                          values);
+        });
         if (win->mapping == mapping_state::mapped) {
             win->xcb_windows.input.map();
         }
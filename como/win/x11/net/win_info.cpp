@@ -213,6 +213,31 @@ win_info::win_info(xcb_connection_t* connection,
                    net::Properties properties,
                    net::Properties2 properties2,
                    Role role)
+{
+    init(connection, window, rootWindow, properties, properties2, role);
+    update(p->properties, p->properties2);
+}
+
+win_info::win_info(xcb_window_t rootWindow, win_info_request& request, Role role)
+{
+    init(request.connection,
+         request.window,
+         rootWindow,
+         request.properties,
+         request.properties2,
+         role);
+
+    // Same as update(p->properties, p->properties2) with the requests already sent.
+    read_properties(request.properties, request.properties2, request.cookies.data());
+    request.cookies.clear();
+}
+
+void win_info::init(xcb_connection_t* connection,
+                    xcb_window_t window,
+                    xcb_window_t rootWindow,
+                    net::Properties properties,
+                    net::Properties2 properties2,
+                    Role role)
 {
     p = new win_info_private;
     p->ref = 1;
@@ -265,8 +290,6 @@ win_info::win_info(xcb_connection_t* connection,
     p->icon_count = 0;
 
     p->role = role;
-
-    update(p->properties, p->properties2);
 }
 
 win_info::win_info(const win_info& wininfo)
@@ -1557,265 +1580,301 @@ void win_info::updateWMState()
     update(XAWMState);
 }
 
-void win_info::update(net::Properties dirtyProperties, net::Properties2 dirtyProperties2)
+/**
+ * Sends the requests for the @p dirty properties. Returns the number of requests. The replies are
+ * read in the same order by win_info::read_properties.
+ */
+static int request_properties(xcb_connection_t* conn,
+                              xcb_window_t window,
+                              Atoms const& atoms,
+                              Properties dirty,
+                              Properties2 dirty2,
+                              xcb_get_property_cookie_t* cookies)
 {
-    Properties dirty = dirtyProperties & p->properties;
-    Properties2 dirty2 = dirtyProperties2 & p->properties2;
-
-    // We *always* want to update WM_STATE if set in dirty_props
-    if (dirtyProperties & XAWMState) {
-        dirty |= XAWMState;
-    }
-
-    xcb_get_property_cookie_t cookies[255];
     int c = 0;
 
     if (dirty & XAWMState) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(WM_STATE), p->atom(WM_STATE), 0, 1);
+            conn, false, window, atoms.atom(WM_STATE), atoms.atom(WM_STATE), 0, 1);
     }
 
     if (dirty & WMState) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_STATE), XCB_ATOM_ATOM, 0, 2048);
+            conn, false, window, atoms.atom(_NET_WM_STATE), XCB_ATOM_ATOM, 0, 2048);
     }
 
     if (dirty & WMDesktop) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_DESKTOP), XCB_ATOM_CARDINAL, 0, 1);
+            conn, false, window, atoms.atom(_NET_WM_DESKTOP), XCB_ATOM_CARDINAL, 0, 1);
     }
 
     if (dirty & WMName) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_NET_WM_NAME),
-                                        p->atom(UTF8_STRING),
+                                        window,
+                                        atoms.atom(_NET_WM_NAME),
+                                        atoms.atom(UTF8_STRING),
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty & WMVisibleName) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_NET_WM_VISIBLE_NAME),
-                                        p->atom(UTF8_STRING),
+                                        window,
+                                        atoms.atom(_NET_WM_VISIBLE_NAME),
+                                        atoms.atom(UTF8_STRING),
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty & WMIconName) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_NET_WM_ICON_NAME),
-                                        p->atom(UTF8_STRING),
+                                        window,
+                                        atoms.atom(_NET_WM_ICON_NAME),
+                                        atoms.atom(UTF8_STRING),
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty & WMVisibleIconName) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_NET_WM_VISIBLE_ICON_NAME),
-                                        p->atom(UTF8_STRING),
+                                        window,
+                                        atoms.atom(_NET_WM_VISIBLE_ICON_NAME),
+                                        atoms.atom(UTF8_STRING),
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty & WMWindowType) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_WINDOW_TYPE), XCB_ATOM_ATOM, 0, 2048);
+            conn, false, window, atoms.atom(_NET_WM_WINDOW_TYPE), XCB_ATOM_ATOM, 0, 2048);
     }
 
     if (dirty & WMStrut) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_STRUT), XCB_ATOM_CARDINAL, 0, 4);
+            conn, false, window, atoms.atom(_NET_WM_STRUT), XCB_ATOM_CARDINAL, 0, 4);
     }
 
     if (dirty2 & WM2ExtendedStrut) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_STRUT_PARTIAL), XCB_ATOM_CARDINAL, 0, 12);
+            conn, false, window, atoms.atom(_NET_WM_STRUT_PARTIAL), XCB_ATOM_CARDINAL, 0, 12);
     }
 
     if (dirty2 & WM2FullscreenMonitors) {
-        cookies[c++] = xcb_get_property(p->conn,
-                                        false,
-                                        p->window,
-                                        p->atom(_NET_WM_FULLSCREEN_MONITORS),
-                                        XCB_ATOM_CARDINAL,
-                                        0,
-                                        4);
+        cookies[c++] = xcb_get_property(
+            conn, false, window, atoms.atom(_NET_WM_FULLSCREEN_MONITORS), XCB_ATOM_CARDINAL, 0, 4);
     }
 
     if (dirty & WMIconGeometry) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_ICON_GEOMETRY), XCB_ATOM_CARDINAL, 0, 4);
+            conn, false, window, atoms.atom(_NET_WM_ICON_GEOMETRY), XCB_ATOM_CARDINAL, 0, 4);
     }
 
     if (dirty & WMIcon) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_ICON), XCB_ATOM_CARDINAL, 0, 0xffffffff);
+            conn, false, window, atoms.atom(_NET_WM_ICON), XCB_ATOM_CARDINAL, 0, 0xffffffff);
     }
 
     if (dirty & WMFrameExtents) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_FRAME_EXTENTS), XCB_ATOM_CARDINAL, 0, 4);
+            conn, false, window, atoms.atom(_NET_FRAME_EXTENTS), XCB_ATOM_CARDINAL, 0, 4);
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_KDE_NET_WM_FRAME_STRUT), XCB_ATOM_CARDINAL, 0, 4);
+            conn, false, window, atoms.atom(_KDE_NET_WM_FRAME_STRUT), XCB_ATOM_CARDINAL, 0, 4);
     }
 
     if (dirty2 & WM2FrameOverlap) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_FRAME_OVERLAP), XCB_ATOM_CARDINAL, 0, 4);
+            conn, false, window, atoms.atom(_NET_WM_FRAME_OVERLAP), XCB_ATOM_CARDINAL, 0, 4);
     }
 
     if (dirty2 & WM2Activities) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_KDE_NET_WM_ACTIVITIES),
+                                        window,
+                                        atoms.atom(_KDE_NET_WM_ACTIVITIES),
                                         XCB_ATOM_STRING,
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2BlockCompositing) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_KDE_NET_WM_BLOCK_COMPOSITING),
+                                        window,
+                                        atoms.atom(_KDE_NET_WM_BLOCK_COMPOSITING),
                                         XCB_ATOM_CARDINAL,
                                         0,
                                         1);
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_BYPASS_COMPOSITOR), XCB_ATOM_CARDINAL, 0, 1);
+            conn, false, window, atoms.atom(_NET_WM_BYPASS_COMPOSITOR), XCB_ATOM_CARDINAL, 0, 1);
     }
 
     if (dirty & WMPid) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_PID), XCB_ATOM_CARDINAL, 0, 1);
+            conn, false, window, atoms.atom(_NET_WM_PID), XCB_ATOM_CARDINAL, 0, 1);
     }
 
     if (dirty2 & WM2StartupId) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_NET_STARTUP_ID),
-                                        p->atom(UTF8_STRING),
+                                        window,
+                                        atoms.atom(_NET_STARTUP_ID),
+                                        atoms.atom(UTF8_STRING),
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2Opacity) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_WINDOW_OPACITY), XCB_ATOM_CARDINAL, 0, 1);
+            conn, false, window, atoms.atom(_NET_WM_WINDOW_OPACITY), XCB_ATOM_CARDINAL, 0, 1);
     }
 
     if (dirty2 & WM2AllowedActions) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_ALLOWED_ACTIONS), XCB_ATOM_ATOM, 0, 2048);
+            conn, false, window, atoms.atom(_NET_WM_ALLOWED_ACTIONS), XCB_ATOM_ATOM, 0, 2048);
     }
 
     if (dirty2 & WM2UserTime) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_NET_WM_USER_TIME), XCB_ATOM_CARDINAL, 0, 1);
+            conn, false, window, atoms.atom(_NET_WM_USER_TIME), XCB_ATOM_CARDINAL, 0, 1);
     }
 
     if (dirty2 & WM2TransientFor) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, XCB_ATOM_WM_TRANSIENT_FOR, XCB_ATOM_WINDOW, 0, 1);
+            conn, false, window, XCB_ATOM_WM_TRANSIENT_FOR, XCB_ATOM_WINDOW, 0, 1);
     }
 
     if (dirty2
         & (WM2GroupLeader | WM2Urgency | WM2Input | WM2InitialMappingState | WM2IconPixmap)) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, XCB_ATOM_WM_HINTS, XCB_ATOM_WM_HINTS, 0, 9);
+            conn, false, window, XCB_ATOM_WM_HINTS, XCB_ATOM_WM_HINTS, 0, 9);
     }
 
     if (dirty2 & WM2WindowClass) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 0, MAX_PROP_SIZE);
+            conn, false, window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 0, MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2WindowRole) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(WM_WINDOW_ROLE), XCB_ATOM_STRING, 0, MAX_PROP_SIZE);
+            conn, false, window, atoms.atom(WM_WINDOW_ROLE), XCB_ATOM_STRING, 0, MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2ClientMachine) {
-        cookies[c++] = xcb_get_property(p->conn,
-                                        false,
-                                        p->window,
-                                        XCB_ATOM_WM_CLIENT_MACHINE,
-                                        XCB_ATOM_STRING,
-                                        0,
-                                        MAX_PROP_SIZE);
+        cookies[c++] = xcb_get_property(
+            conn, false, window, XCB_ATOM_WM_CLIENT_MACHINE, XCB_ATOM_STRING, 0, MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2Protocols) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(WM_PROTOCOLS), XCB_ATOM_ATOM, 0, 2048);
+            conn, false, window, atoms.atom(WM_PROTOCOLS), XCB_ATOM_ATOM, 0, 2048);
     }
 
     if (dirty2 & WM2OpaqueRegion) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_NET_WM_OPAQUE_REGION),
+                                        window,
+                                        atoms.atom(_NET_WM_OPAQUE_REGION),
                                         XCB_ATOM_CARDINAL,
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2DesktopFileName) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_KDE_NET_WM_DESKTOP_FILE),
-                                        p->atom(UTF8_STRING),
+                                        window,
+                                        atoms.atom(_KDE_NET_WM_DESKTOP_FILE),
+                                        atoms.atom(UTF8_STRING),
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2GTKApplicationId) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_GTK_APPLICATION_ID),
-                                        p->atom(UTF8_STRING),
+                                        window,
+                                        atoms.atom(_GTK_APPLICATION_ID),
+                                        atoms.atom(UTF8_STRING),
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2GTKFrameExtents) {
         cookies[c++] = xcb_get_property(
-            p->conn, false, p->window, p->atom(_GTK_FRAME_EXTENTS), XCB_ATOM_CARDINAL, 0, 4);
+            conn, false, window, atoms.atom(_GTK_FRAME_EXTENTS), XCB_ATOM_CARDINAL, 0, 4);
     }
 
     if (dirty2 & WM2AppMenuObjectPath) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_KDE_NET_WM_APPMENU_OBJECT_PATH),
+                                        window,
+                                        atoms.atom(_KDE_NET_WM_APPMENU_OBJECT_PATH),
                                         XCB_ATOM_STRING,
                                         0,
                                         MAX_PROP_SIZE);
     }
 
     if (dirty2 & WM2AppMenuServiceName) {
-        cookies[c++] = xcb_get_property(p->conn,
+        cookies[c++] = xcb_get_property(conn,
                                         false,
-                                        p->window,
-                                        p->atom(_KDE_NET_WM_APPMENU_SERVICE_NAME),
+                                        window,
+                                        atoms.atom(_KDE_NET_WM_APPMENU_SERVICE_NAME),
                                         XCB_ATOM_STRING,
                                         0,
                                         MAX_PROP_SIZE);
     }
 
-    c = 0;
+    return c;
+}
+
+win_info_request::win_info_request(xcb_connection_t* connection,
+                                   xcb_window_t window,
+                                   net::Properties properties,
+                                   net::Properties2 properties2)
+    : connection{connection}
+    , window{window}
+    , properties{properties}
+    , properties2{properties2}
+{
+    auto const atoms = atomsForConnection(connection);
+
+    xcb_get_property_cookie_t requests[255];
+    auto const count = request_properties(
+        connection, window, *atoms.constData(), properties, properties2, requests);
+    cookies.assign(requests, requests + count);
+}
+
+win_info_request::~win_info_request()
+{
+    for (auto const& cookie : cookies) {
+        xcb_discard_reply(connection, cookie.sequence);
+    }
+}
+
+void win_info::update(net::Properties dirtyProperties, net::Properties2 dirtyProperties2)
+{
+    Properties dirty = dirtyProperties & p->properties;
+    Properties2 dirty2 = dirtyProperties2 & p->properties2;
+
+    // We *always* want to update WM_STATE if set in dirty_props
+    if (dirtyProperties & XAWMState) {
+        dirty |= XAWMState;
+    }
+
+    xcb_get_property_cookie_t cookies[255];
+    request_properties(p->conn, p->window, *p->atoms.constData(), dirty, dirty2, cookies);
+    read_properties(dirty, dirty2, cookies);
+}
+
+void win_info::read_properties(net::Properties dirty,
+                               net::Properties2 dirty2,
+                               xcb_get_property_cookie_t const* cookies)
+{
+    int c = 0;
 
     if (dirty & XAWMState) {
         p->mapping_state = Withdrawn;
@@ -20,6 +20,33 @@ struct win_info_private;
 template<class Z>
 class rarray;
 
+/**
+ * Requests the properties of a window without waiting for the replies. A win_info constructed
+ * from it reads the replies instead of requesting the properties itself. Unread replies are
+ * discarded on destruction.
+ */
+class COMO_EXPORT win_info_request
+{
+public:
+    win_info_request(xcb_connection_t* connection,
+                     xcb_window_t window,
+                     net::Properties properties,
+                     net::Properties2 properties2);
+    ~win_info_request();
+
+    win_info_request(win_info_request const&) = delete;
+    win_info_request& operator=(win_info_request const&) = delete;
+
+private:
+    xcb_connection_t* connection;
+    xcb_window_t window;
+    net::Properties properties;
+    net::Properties2 properties2;
+    std::vector<xcb_get_property_cookie_t> cookies;
+
+    friend class win_info;
+};
+
 class COMO_EXPORT win_info
 {
 public:
@@ -36,6 +63,11 @@ public:
              net::Properties properties,
              net::Properties2 properties2,
              Role role = Client);
+    /**
+     * Reads the properties requested by @p request. The request must be for the same connection
+     * and window.
+     */
+    win_info(xcb_window_t rootWindow, win_info_request& request, Role role = Client);
     win_info(const win_info& wininfo);
     virtual ~win_info();
 
@@ -167,8 +199,17 @@ protected:
     }
 
 private:
+    void init(xcb_connection_t* connection,
+              xcb_window_t window,
+              xcb_window_t rootWindow,
+              net::Properties properties,
+              net::Properties2 properties2,
+              Role role);
     void update(net::Properties dirtyProperties,
                 net::Properties2 dirtyProperties2 = net::Properties2());
+    void read_properties(net::Properties dirty,
+                         net::Properties2 dirty2,
+                         xcb_get_property_cookie_t const* cookies);
     void updateWMState();
     void setIconInternal(net::rarray<net::icon>& icons,
                          int& icon_count,
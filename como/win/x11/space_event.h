@@ -14,6 +14,7 @@
 #include <como/base/x11/event_filter_manager.h>
 #include <como/base/x11/xcb/proto.h>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -40,10 +41,66 @@ static std::vector<std::string> const xcb_errors({
     "BadName",   "BadLength",  "BadImplementation", "Unknown",
 });
 
+/**
+ * Starts managing the windows of queued map requests. Their data was requested already when the
+ * map requests came in.
+ */
+template<typename Space>
+void process_map_requests(Space& space)
+{
+    if (space.map_requests.empty()) {
+        return;
+    }
+
+    auto const requests = std::move(space.map_requests);
+    space.map_requests.clear();
+
+    for (auto const& prefetch : requests) {
+        if (!create_controlled_window(*prefetch, false, space)) {
+            xcb_map_window(space.base.x11_data.connection, prefetch->window);
+            const uint32_t values[] = {XCB_STACK_MODE_ABOVE};
+            xcb_configure_window(space.base.x11_data.connection,
+                                 prefetch->window,
+                                 XCB_CONFIG_WINDOW_STACK_MODE,
+                                 values);
+        }
+    }
+}
+
+/**
+ * Map requests often come in bursts, for example when an application starts up. The data of the
+ * windows is requested right away, but managing the windows is delayed until another kind of
+ * event is handled or all events read from the connection were processed. That way the requests
+ * for all windows of a burst go out in a single flight.
+ */
+template<typename Space>
+void queue_map_request(Space& space, xcb_window_t xcb_win)
+{
+    if (std::any_of(space.map_requests.cbegin(),
+                    space.map_requests.cend(),
+                    [xcb_win](auto const& prefetch) { return prefetch->window == xcb_win; })) {
+        return;
+    }
+
+    if (space.map_requests.empty()) {
+        QMetaObject::invokeMethod(
+            space.qobject.get(), [&space] { process_map_requests(space); }, Qt::QueuedConnection);
+    }
+
+    space.map_requests.push_back(prefetch_window(space, xcb_win));
+    xcb_flush(space.base.x11_data.connection);
+}
+
 template<typename Space>
 bool space_event(Space& space, xcb_generic_event_t* event)
 {
     uint8_t const event_type = event->response_type & ~0x80;
+
+    if (event_type != XCB_MAP_REQUEST && event_type != XCB_CREATE_NOTIFY) {
+        // The event might concern a window with a queued map request.
+        process_map_requests(space);
+    }
+
     if (!event_type) {
         // let's check whether it's an error from one of the extensions KWin uses
         auto error = reinterpret_cast<xcb_generic_error_t*>(event);
@@ -212,14 +269,7 @@ bool space_event(Space& space, xcb_generic_event_t* event)
             // children of WindowWrapper (=clients), the check is AFAIK useless anyway
             // NOTICE: The save-set support in X11Client::mapRequestEvent() actually requires that
             // this code doesn't check the parent to be root.
-            if (!create_controlled_window(map_req_event->window, false, space)) {
-                xcb_map_window(space.base.x11_data.connection, map_req_event->window);
-                const uint32_t values[] = {XCB_STACK_MODE_ABOVE};
-                xcb_configure_window(space.base.x11_data.connection,
-                                     map_req_event->window,
-                                     XCB_CONFIG_WINDOW_STACK_MODE,
-                                     values);
-            }
+            queue_map_request(space, map_req_event->window);
         }
 
         return true;
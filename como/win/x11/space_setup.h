@@ -170,19 +170,26 @@ void init_space(Space& space)
         base::x11::xcb::tree tree(x11_data.connection, x11_data.root_window);
         xcb_window_t* wins = xcb_query_tree_children(tree.data());
 
-        std::vector<base::x11::xcb::window_attributes> windowAttributes;
-        std::vector<base::x11::xcb::geometry> windowGeometries;
+        std::vector<std::unique_ptr<window_prefetch>> prefetches;
 
-        // Request the attributes and geometries of all toplevel windows
+        // Request the data of all toplevel windows in one go
         for (int i = 0; i < tree->children_len; i++) {
-            windowAttributes.push_back(
-                base::x11::xcb::window_attributes(x11_data.connection, wins[i]));
-            windowGeometries.push_back(base::x11::xcb::geometry(x11_data.connection, wins[i]));
+            prefetches.push_back(std::make_unique<window_prefetch>(x11_data.connection, wins[i]));
+        }
+
+        // Request the properties of the windows to manage in a second go
+        for (auto& prefetch : prefetches) {
+            auto& attr = prefetch->attributes;
+            if (!attr.is_null() && !attr->override_redirect
+                && attr->map_state != XCB_MAP_STATE_UNMAPPED) {
+                prefetch_window_properties(space, *prefetch);
+            }
         }
 
         // Get the replies
         for (int i = 0; i < tree->children_len; i++) {
-            base::x11::xcb::window_attributes attr(windowAttributes.at(i));
+            auto& prefetch = *prefetches.at(i);
+            auto& attr = prefetch.attributes;
 
             if (attr.is_null()) {
                 continue;
@@ -196,12 +203,14 @@ void init_space(Space& space)
             } else if (attr->map_state != XCB_MAP_STATE_UNMAPPED) {
                 if constexpr (requires(decltype(space.base) base) { base.crash_count; }) {
                     if (space.base.crash_count > 0) {
-                        fix_position_after_crash(space, wins[i], windowGeometries.at(i).data());
+                        fix_position_after_crash(space, wins[i], prefetch.geometry.data());
+
+                        // The prefetched geometry is outdated now.
+                        prefetch.geometry = base::x11::xcb::geometry(x11_data.connection, wins[i]);
                     }
                 }
 
-                // ### This will request the attributes again
-                create_controlled_window(wins[i], true, space);
+                create_controlled_window(prefetch, true, space);
             }
         }
 
@@ -272,6 +281,7 @@ void clear_space(Space& space)
     // "mutex" the stackingorder, since anything trying to access it from now on will find
     // many dangeling pointers and crash
     space.stacking.order.stack.clear();
+    space.stacking.order.invalidate_render_stack();
 
     // Only release windows on X11.
     auto const is_x11 = space.base.operation_mode == base::operation_mode::x11;
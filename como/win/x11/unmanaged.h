@@ -8,6 +8,7 @@
 #include "damage.h"
 #include "event.h"
 #include "meta.h"
+#include "window_find.h"
 #include "window_release.h"
 #include "xcb.h"
 
@@ -22,21 +23,11 @@ namespace como::win::x11
 template<typename Win, typename Space>
 Win* find_unmanaged(Space&& space, xcb_window_t xcb_win)
 {
-    for (auto& var_win : space.windows) {
-        if (auto win = std::visit(overload{[xcb_win](Win* win) -> Win* {
-                                               if (win->remnant || win->control
-                                                   || win->xcb_windows.client != xcb_win) {
-                                                   return nullptr;
-                                               }
-                                               return win;
-                                           },
-                                           [](auto&& /*win*/) -> Win* { return nullptr; }},
-                                  var_win)) {
-            return win;
-        }
+    auto win = find_indexed_window<Win>(space, xcb_win);
+    if (!win || win->remnant || win->control || win->xcb_windows.client != xcb_win) {
+        return nullptr;
     }
-
-    return nullptr;
+    return win;
 }
 
 template<typename Space>
@@ -128,6 +119,7 @@ auto create_unmanaged_window(xcb_window_t xcb_win, Space& space) -> typename Spa
                      [win] { win->space.base.mod.render->schedule_repaint(win); });
 
     space.windows.push_back(win);
+    index_window(*win);
     space.stacking.order.render_restack_required = true;
     Q_EMIT space.qobject->unmanagedAdded(win->meta.signal_id);
 
@@ -17,17 +17,8 @@ template<typename Win>
 class win_info : public net::win_info
 {
 public:
-    win_info(Win* window,
-             xcb_window_t xcb_win,
-             xcb_window_t rwin,
-             net::Properties properties,
-             net::Properties2 properties2)
-        : net::win_info(window->space.base.x11_data.connection,
-                        xcb_win,
-                        rwin,
-                        properties,
-                        properties2,
-                        net::WindowManager)
+    win_info(Win* window, xcb_window_t rwin, net::win_info_request& request)
+        : net::win_info(rwin, request, net::WindowManager)
         , window(window)
     {
     }
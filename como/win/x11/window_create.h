@@ -22,6 +22,7 @@ void add_controlled_window_to_space(Space& space, Win* win)
     auto grp = find_group(space, win->xcb_windows.client);
 
     space.windows.push_back(win);
+    index_window(*win);
     Q_EMIT space.qobject->clientAdded(win->meta.signal_id);
 
     if (grp) {
@@ -45,6 +46,7 @@ void add_controlled_window_to_space(Space& space, Win* win)
     if (!contains(space.stacking.order.stack, var_win(win))) {
         // It'll be updated later, and updateToolWindows() requires c to be in stacking.order.
         space.stacking.order.stack.push_back(win);
+        space.stacking.order.invalidate_render_stack();
     }
 
     // This cannot be in manage(), because the client got added only now
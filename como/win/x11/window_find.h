@@ -10,39 +10,106 @@
 #include <como/utils/algorithm.h>
 
 #include <QObject>
+#include <array>
+#include <cassert>
 #include <xcb/xcb.h>
 
 namespace como::win::x11
 {
 
+/**
+ * The X11 windows of managed and unmanaged windows are indexed by their XIDs in the space, so
+ * windows can be looked up in constant time on incoming events. A window is indexed while it is
+ * in the windows list of the space. Remnants are never indexed.
+ */
+template<typename Win>
+bool is_window_indexed(Win const& win)
+{
+    auto const& map = win.space.xcb_windows_map;
+    auto it = map.find(win.xcb_windows.client);
+    return it != map.end() && it->second == &win;
+}
+
+template<typename Win>
+std::array<xcb_window_t, 4> get_indexed_xcb_windows(Win const& win)
+{
+    return {win.xcb_windows.client,
+            win.xcb_windows.wrapper,
+            win.xcb_windows.outer,
+            win.xcb_windows.input};
+}
+
+template<typename Win>
+void index_window(Win& win)
+{
+    assert(!win.remnant);
+
+    auto& map = win.space.xcb_windows_map;
+    for (xcb_window_t xcb_win : get_indexed_xcb_windows(win)) {
+        if (xcb_win != XCB_WINDOW_NONE) {
+            map[xcb_win] = &win;
+        }
+    }
+}
+
+template<typename Win>
+void unindex_window(Win& win)
+{
+    auto& map = win.space.xcb_windows_map;
+    for (xcb_window_t xcb_win : get_indexed_xcb_windows(win)) {
+        if (auto it = map.find(xcb_win); it != map.end() && it->second == &win) {
+            map.erase(it);
+        }
+    }
+}
+
+/**
+ * Calls @p update to create or reset X11 windows of @p win and keeps the index in sync.
+ */
+template<typename Win, typename Update>
+void update_xcb_windows(Win& win, Update&& update)
+{
+    if (!is_window_indexed(win)) {
+        update();
+        return;
+    }
+
+    unindex_window(win);
+    update();
+    index_window(win);
+}
+
+template<typename Win, typename Space>
+Win* find_indexed_window(Space& space, xcb_window_t w)
+{
+    auto it = space.xcb_windows_map.find(w);
+    return it == space.xcb_windows_map.end() ? nullptr : it->second;
+}
+
 template<typename Win, typename Space>
 Win* find_controlled_window(Space& space, predicate_match predicate, xcb_window_t w)
 {
-    auto find_window = [&](std::function<bool(Win const*)> const& func) -> Win* {
-        for (auto& var_win : space.windows) {
-            if (auto win = std::visit(overload{[&](Win* win) -> Win* {
-                                                   return win->control && func(win) ? win : nullptr;
-                                               },
-                                               [&](auto&& /*win*/) -> Win* { return nullptr; }},
-                                      var_win)) {
-                return win;
-            }
-        }
+    auto win = find_indexed_window<Win>(space, w);
+    if (!win || !win->control) {
         return nullptr;
-    };
-
-    switch (predicate) {
-    case predicate_match::window:
-        return find_window([w](auto win) { return win->xcb_windows.client == w; });
-    case predicate_match::wrapper_id:
-        return find_window([w](auto win) { return win->xcb_windows.wrapper == w; });
-    case predicate_match::frame_id:
-        return find_window([w](auto win) { return win->xcb_windows.outer == w; });
-    case predicate_match::input_id:
-        return find_window([w](auto win) { return win->xcb_windows.input == w; });
     }
 
-    return nullptr;
+    auto matches = [&] {
+        switch (predicate) {
+        case predicate_match::window:
+            return win->xcb_windows.client == w;
+        case predicate_match::wrapper_id:
+            return win->xcb_windows.wrapper == w;
+        case predicate_match::frame_id:
+            return win->xcb_windows.outer == w;
+        case predicate_match::input_id:
+            return win->xcb_windows.input == w;
+        }
+        return false;
+    };
+
+    return matches() ? win : nullptr;
+}
 }
 
 }
@@ -0,0 +1,120 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/base/x11/atoms.h>
+#include <como/base/x11/xcb/geometry_hints.h>
+#include <como/base/x11/xcb/helpers.h>
+#include <como/base/x11/xcb/property.h>
+#include <como/base/x11/xcb/proto.h>
+#include <como/win/x11/net/win_info.h>
+
+#include <memory>
+#include <xcb/xcb.h>
+
+namespace como::win::x11
+{
+
+net::Properties const managed_window_properties = net::WMDesktop | net::WMState
+    | net::WMWindowType | net::WMStrut | net::WMName | net::WMIconGeometry | net::WMIcon
+    | net::WMPid | net::WMIconName;
+
+net::Properties2 const managed_window_properties2 = net::WM2BlockCompositing
+    | net::WM2WindowClass | net::WM2WindowRole | net::WM2UserTime | net::WM2ExtendedStrut
+    | net::WM2Opacity | net::WM2FullscreenMonitors | net::WM2GroupLeader | net::WM2Urgency
+    | net::WM2Input | net::WM2Protocols | net::WM2InitialMappingState | net::WM2IconPixmap
+    | net::WM2OpaqueRegion | net::WM2DesktopFileName | net::WM2GTKFrameExtents
+    | net::WM2GTKApplicationId;
+
+/**
+ * Requests the client properties read when starting to manage a window. Property changes must be
+ * selected on the window before, otherwise a change after the request goes unnoticed.
+ */
+struct window_properties_prefetch {
+    window_properties_prefetch(xcb_connection_t* con,
+                               base::x11::atoms const& atoms,
+                               xcb_window_t xcb_win)
+        : wm_client_leader{con, false, xcb_win, atoms.wm_client_leader, XCB_ATOM_WINDOW, 0, 10000}
+        , skip_close_animation{con,
+                               false,
+                               xcb_win,
+                               atoms.kde_skip_close_animation,
+                               XCB_ATOM_CARDINAL,
+                               0,
+                               1}
+        , show_on_screen_edge{con,
+                              false,
+                              xcb_win,
+                              atoms.kde_screen_edge_show,
+                              XCB_ATOM_CARDINAL,
+                              0,
+                              1}
+        , transient{con, xcb_win}
+        , normal_hints{con, xcb_win}
+        , motif_hints{con, false, xcb_win, atoms.motif_wm_hints, atoms.motif_wm_hints, 0, 5}
+        , info{con, xcb_win, managed_window_properties, managed_window_properties2}
+    {
+    }
+
+    base::x11::xcb::property wm_client_leader;
+    base::x11::xcb::property skip_close_animation;
+    base::x11::xcb::property show_on_screen_edge;
+    base::x11::xcb::transient_for transient;
+    base::x11::xcb::normal_hints normal_hints;
+    base::x11::xcb::property motif_hints;
+    net::win_info_request info;
+};
+
+/**
+ * Requests the window data needed to start managing a window. The requests are sent on
+ * construction without waiting for the replies. This way the requests for several windows that
+ * should be managed can go out in a single flight and their replies are read later on when
+ * creating the controlled windows.
+ *
+ * The properties are only requested through prefetch_window_properties, so they are not fetched
+ * for windows that end up not being managed.
+ */
+struct window_prefetch {
+    window_prefetch(xcb_connection_t* con, xcb_window_t xcb_win)
+        : window{xcb_win}
+        , attributes{con, xcb_win}
+        , geometry{con, xcb_win}
+    {
+    }
+
+    window_prefetch(window_prefetch const&) = delete;
+    window_prefetch& operator=(window_prefetch const&) = delete;
+
+    xcb_window_t window;
+
+    base::x11::xcb::window_attributes attributes;
+    base::x11::xcb::geometry geometry;
+
+    std::unique_ptr<window_properties_prefetch> properties;
+};
+
+template<typename Space>
+void prefetch_window_properties(Space& space, window_prefetch& prefetch)
+{
+    auto con = space.base.x11_data.connection;
+
+    // Until the window is embedded this is the only event selected on the client. Events arriving
+    // before the window is created first create it and are then handled by it.
+    base::x11::xcb::select_input(con, prefetch.window, XCB_EVENT_MASK_PROPERTY_CHANGE);
+
+    prefetch.properties
+        = std::make_unique<window_properties_prefetch>(con, *space.atoms, prefetch.window);
+}
+
+template<typename Space>
+std::unique_ptr<window_prefetch> prefetch_window(Space& space, xcb_window_t xcb_win)
+{
+    auto prefetch = std::make_unique<window_prefetch>(space.base.x11_data.connection, xcb_win);
+    prefetch_window_properties(space, *prefetch);
+    return prefetch;
+}
+
+}
@@ -76,6 +76,7 @@ void remove_controlled_window_from_space(Space& space, Win* win)
 
     // TODO: if marked client is removed, notify the marked list
     remove_window_from_lists(space, win);
+    unindex_window(*win);
     remove_all(space.stacking.attention_chain, var_win(win));
 
     auto group = find_group(space, win->xcb_windows.client);
@@ -132,6 +133,7 @@ void finish_unmanaged_removal(Win* win, Win* remnant)
     assert(contains(space.windows, var_win(win)));
 
     remove_window_from_lists(space, win);
+    unindex_window(*win);
     space.base.mod.render->addRepaint(visible_rect(win));
 
     Q_EMIT space.qobject->unmanagedRemoved(win->meta.signal_id);
@@ -319,8 +321,10 @@ void release_window(Win* win, bool on_shutdown)
         win->xcb_windows.client.unmap();
     }
 
-    win->xcb_windows.wrapper.reset();
-    win->xcb_windows.outer.reset();
+    update_xcb_windows(*win, [win] {
+        win->xcb_windows.wrapper.reset();
+        win->xcb_windows.outer.reset();
+    });
 
     // Don't use GeometryUpdatesBlocker, it would now set the geometry
     win->geo.update.block--;
@@ -394,8 +398,10 @@ void destroy_window(Win* win)
     remove_controlled_window_from_space(win->space, win);
 
     // invalidate
-    win->xcb_windows.wrapper.reset();
-    win->xcb_windows.outer.reset();
+    update_xcb_windows(*win, [win] {
+        win->xcb_windows.wrapper.reset();
+        win->xcb_windows.outer.reset();
+    });
 
     // Don't use GeometryUpdatesBlocker, it would now set the geometry
     win->geo.update.block--;
@@ -430,6 +436,7 @@ void cleanup_window(Win& win)
     delete win.client_machine;
     delete win.net_info;
     win.space.windows_map.erase(win.meta.signal_id);
+    unindex_window(win);
 }
 
 /// Kills the window via XKill
@@ -7,6 +7,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <como/base/logging.h>
 
+#include <algorithm>
 #include <unistd.h>
 
 namespace como::xwl
@@ -15,6 +16,19 @@ namespace como::xwl
 // in Bytes: equals 64KB
 constexpr uint32_t s_incrChunkSize = 63 * 1024;
 
+// Larger chunks need less round trips with the requestor but block the X server for longer.
+constexpr uint32_t s_maxIncrChunkSize = 1024 * 1024;
+
+static uint32_t get_incr_chunk_size(xcb_connection_t* connection)
+{
+    // In units of four bytes. Spare some space for the request header.
+    auto const max_request = static_cast<uint64_t>(xcb_get_maximum_request_length(connection)) * 4;
+    if (max_request < s_incrChunkSize + 1024) {
+        return s_incrChunkSize;
+    }
+    return std::min<uint64_t>(max_request - 1024, s_maxIncrChunkSize);
+}
+
 transfer::transfer(xcb_atom_t selection,
                    qint32 fd,
                    xcb_timestamp_t timestamp,
@@ -71,6 +85,7 @@ wl_to_x11_transfer::wl_to_x11_transfer(xcb_atom_t selection,
                                        QObject* parent)
     : transfer(selection, fd, 0, x11, parent)
     , request(request)
+    , chunk_size{get_incr_chunk_size(x11.connection)}
 {
 }
 
@@ -91,22 +106,40 @@ void wl_to_x11_transfer::start_transfer_from_source()
 
 int wl_to_x11_transfer::flush_source_data()
 {
+    if (chunks.empty()) {
+        // Source lags behind. Flushed once the next chunk is read.
+        return 0;
+    }
+
+    // The chunk might still be read into. Only the read part is valid.
+    auto const size = chunks.front().second;
+
     xcb_change_property(x11.connection,
                         XCB_PROP_MODE_REPLACE,
                         request->requestor,
                         request->property,
                         request->target,
                         8,
-                        chunks.front().first.size(),
-                        chunks.front().first.data());
+                        size,
+                        chunks.front().first.constData());
     xcb_flush(x11.connection);
 
     property_is_set = true;
     reset_timeout();
 
-    auto const rm = chunks.front();
     chunks.pop_front();
-    return rm.first.size();
+    buffered -= size;
+    update_source_notifier();
+
+    return size;
+}
+
+void wl_to_x11_transfer::update_source_notifier()
+{
+    if (auto notifier = socket_notifier()) {
+        // Pause reading from the source while the requestor lags behind.
+        notifier->setEnabled(buffered < max_read_ahead);
+    }
 }
 
 void wl_to_x11_transfer::start_incr()
@@ -117,7 +150,7 @@ void wl_to_x11_transfer::start_incr()
     xcb_change_window_attributes(x11.connection, request->requestor, XCB_CW_EVENT_MASK, mask);
 
     // spec says to make the available space larger
-    uint32_t const chunkSpace = 1024 + s_incrChunkSize;
+    uint32_t const chunkSpace = 1024 + chunk_size;
     xcb_change_property(x11.connection,
                         XCB_PROP_MODE_REPLACE,
                         request->requestor,
@@ -138,16 +171,13 @@ void wl_to_x11_transfer::start_incr()
 
 void wl_to_x11_transfer::read_wl_source()
 {
-    if (chunks.size() == 0 || chunks.back().second == s_incrChunkSize) {
+    if (chunks.size() == 0 || chunks.back().second == static_cast<int>(chunk_size)) {
         // append new chunk
-        auto next = std::pair<QByteArray, int>();
-        next.first.resize(s_incrChunkSize);
-        next.second = 0;
-        chunks.push_back(next);
+        chunks.emplace_back(QByteArray(chunk_size, Qt::Uninitialized), 0);
     }
 
     auto const oldLen = chunks.back().second;
-    auto const avail = s_incrChunkSize - chunks.back().second;
+    auto const avail = chunk_size - chunks.back().second;
     Q_ASSERT(avail > 0);
 
     ssize_t readLen = read(get_fd(), chunks.back().first.data() + oldLen, avail);
@@ -159,6 +189,7 @@ void wl_to_x11_transfer::read_wl_source()
         return;
     }
     chunks.back().second = oldLen + readLen;
+    buffered += readLen;
 
     if (readLen == 0) {
         // at the fd end - complete transfer now
@@ -179,7 +210,7 @@ void wl_to_x11_transfer::read_wl_source()
             Q_EMIT selection_notify(request, true);
             end_transfer();
         }
-    } else if (chunks.back().second == s_incrChunkSize) {
+    } else if (chunks.back().second == static_cast<int>(chunk_size)) {
         // first chunk full, but not yet at fd end -> go incremental
         if (get_incr()) {
             flush_property_on_delete = true;
@@ -192,6 +223,8 @@ void wl_to_x11_transfer::read_wl_source()
             start_incr();
         }
     }
+
+    update_source_notifier();
     reset_timeout();
 }
 
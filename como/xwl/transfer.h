@@ -96,6 +96,10 @@ private:
 
 /**
  * Represents a transfer from a Wayland native source to an X window.
+ *
+ * Data is read from the source at most @c max_read_ahead bytes ahead of what the X window has
+ * received. Above that reading pauses until the requestor has taken the next chunk. So large
+ * payloads are streamed instead of being buffered fully in memory.
  */
 class COMO_EXPORT wl_to_x11_transfer : public transfer
 {
@@ -112,6 +116,9 @@ public:
     void start_transfer_from_source();
     bool handle_property_notify(xcb_property_notify_event_t* event) override;
 
+    /// Bytes read ahead from the Wayland source at most. Set before starting the transfer.
+    size_t max_read_ahead{4 * 1024 * 1024};
+
 Q_SIGNALS:
     void selection_notify(xcb_selection_request_event_t* event, bool success);
 
@@ -120,14 +127,21 @@ private:
     void read_wl_source();
     int flush_source_data();
     void handle_property_delete();
+    void update_source_notifier();
 
     xcb_selection_request_event_t* request = nullptr;
 
-    /* contains all received data portioned in chunks
-     * TODO(romangg): explain second std::pair component
+    /// Size of a single property set in the incremental transfer.
+    uint32_t const chunk_size;
+
+    /* contains all received data portioned in chunks, the second std::pair
+     * component is the number of bytes already read into the chunk
      */
     std::deque<std::pair<QByteArray, int>> chunks;
 
+    /// Bytes read from the source that the X window has not received yet.
+    size_t buffered{0};
+
     bool property_is_set = false;
     bool flush_property_on_delete = false;
 
@@ -22,6 +22,7 @@
 #include <QMatrix4x4>
 #include <QScreen> // for QGuiApplication
 #include <QTime>
+#include <algorithm>
 #include <cmath> // for ceil()
 #include <cstdlib>
 
@@ -33,6 +34,9 @@
 namespace como
 {
 
+// Each cached background holds a texture with the size of the first downsampled target.
+static constexpr size_t max_cached_windows{4};
+
 void update_function(BlurEffect& effect, como::effect::region_update const& update)
 {
     if (!update.base.window) {
@@ -63,6 +67,11 @@ BlurEffect::BlurEffect()
         handle_screen_added(screen);
     }
 
+    QObject::connect(
+        effects, &EffectsHandler::windowClosed, this, &BlurEffect::remove_window_cache);
+    QObject::connect(
+        effects, &EffectsHandler::windowDeleted, this, &BlurEffect::remove_window_cache);
+
     if (shader && shader->isValid() && render_targets_are_valid) {
         auto& blur_integration = effects->get_blur_integration();
         auto update = [this](auto&& data) { update_function(*this, data); };
@@ -79,6 +88,11 @@ void BlurEffect::reset()
     effects->doneOpenGLContextCurrent();
 }
 
+qulonglong BlurEffect::cache_hits() const
+{
+    return cache_hit_count;
+}
+
 static bool check_render_targets_are_valid(std::vector<blur_render_target> const& targets)
 {
     return !targets.empty() && std::all_of(targets.cbegin(), targets.cend(), [](auto&& target) {
@@ -98,6 +112,7 @@ void BlurEffect::update_texture()
 void BlurEffect::update_texture(blur_render_data& screen)
 {
     screen.targets.clear();
+    screen.window_caches.clear();
 
     /* Reserve memory for:
      *  - The original sized texture (1)
@@ -141,6 +156,14 @@ void BlurEffect::update_texture(blur_render_data& screen)
     // This last set is used as a temporary helper texture
     screen.targets.emplace_back(std::make_unique<GLTexture>(textureFormat, screen_size));
 
+    update_stack(screen);
+
+    // Invalidate noise texture
+    noise_texture = {};
+}
+
+void BlurEffect::update_stack(blur_render_data& screen)
+{
     screen.stack = {};
 
     // Upsample
@@ -155,9 +178,6 @@ void BlurEffect::update_texture(blur_render_data& screen)
 
     // Copysample (with the original sized target)
     screen.stack.push(screen.targets.front().fbo.get());
-
-    // Invalidate noise texture
-    noise_texture = {};
 }
 
 void BlurEffect::init_blur_strength_values()
@@ -278,8 +298,11 @@ void BlurEffect::handle_screen_added(EffectScreen const* screen)
 
 void BlurEffect::handle_screen_removed(EffectScreen const* screen)
 {
+    // Frees the render targets and cached backgrounds of the screen.
+    effects->makeOpenGLContextCurrent();
     render_screens.erase(screen);
     update_texture();
+    effects->doneOpenGLContextCurrent();
 }
 
 bool BlurEffect::deco_supports_blur_behind(EffectWindow const* win) const
@@ -402,6 +425,17 @@ void BlurEffect::prePaintScreen(effect::screen_prepaint_data& data)
     current_blur_area = {};
 
     current_screen = &data.screen;
+    if (auto it = render_screens.find(current_screen); it != render_screens.end()) {
+        auto& screen_data = it->second;
+        screen_data.frame++;
+
+        // Entries not checked in the previous frame are invalid anyway, for example because the
+        // window was hidden or moved to another screen. Their targets are freed.
+        std::erase_if(screen_data.window_caches, [&](auto const& entry) {
+            return entry.second.frame + 1 < screen_data.frame;
+        });
+    }
+
     effects->prePaintScreen(data);
 }
 
@@ -446,6 +480,8 @@ void BlurEffect::prePaintWindow(effect::window_prepaint_data& data)
     auto const blurArea = blur_region(&data.window).translated(data.window.pos()) & screen_geo;
     auto const expandedBlur = (data.window.isDock() ? blurArea : expand(blurArea)) & screen_geo;
 
+    update_window_cache(data, blurArea, expandedBlur);
+
     // if this window or a window underneath the blurred area is painted again we have to
     // blur everything
     if (painted_area.intersects(expandedBlur) || data.paint.region.intersects(blurArea)) {
@@ -463,6 +499,120 @@ void BlurEffect::prePaintWindow(effect::window_prepaint_data& data)
     painted_area |= data.paint.region;
 }
 
+void BlurEffect::remove_window_cache(EffectWindow const* win)
+{
+    for (auto& [screen, data] : render_screens) {
+        if (auto it = data.window_caches.find(win); it != data.window_caches.end()) {
+            effects->makeOpenGLContextCurrent();
+            data.window_caches.erase(it);
+        }
+    }
+}
+
+void BlurEffect::update_window_cache(effect::window_prepaint_data const& data,
+                                     QRegion const& blur_area,
+                                     QRegion const& expanded_blur)
+{
+    auto screen_it = render_screens.find(current_screen);
+    if (screen_it == render_screens.end()) {
+        return;
+    }
+
+    auto& screen_data = screen_it->second;
+    if (blur_area.isEmpty()) {
+        screen_data.window_caches.erase(&data.window);
+        return;
+    }
+
+    auto& cache = screen_data.window_caches[&data.window];
+
+    // The cached background stays valid only while it is checked in every frame and nothing
+    // underneath the blurred area is painted again. Changes of the window itself or of windows
+    // above it do not alter its background.
+    if (cache.frame + 1 != screen_data.frame || cache.blur_area != blur_area
+        || painted_area.intersects(expanded_blur)) {
+        cache.valid = false;
+    }
+
+    cache.blur_area = blur_area;
+    cache.frame = screen_data.frame;
+}
+
+blur_window_cache* BlurEffect::get_window_cache(blur_render_data& data,
+                                                effect::window_paint_data const& win_data)
+{
+    if (win_data.render.targets.size() != 1) {
+        // Painted into an offscreen target whose content is unrelated to the screen.
+        return nullptr;
+    }
+
+    auto const& geo = win_data.paint.geo;
+    if ((win_data.paint.mask & PAINT_WINDOW_TRANSFORMED) || geo.translation.x()
+        || geo.translation.y() || !qFuzzyCompare(geo.scale.x(), 1.f)
+        || !qFuzzyCompare(geo.scale.y(), 1.f)) {
+        return nullptr;
+    }
+
+    auto it = data.window_caches.find(&win_data.window);
+    if (it == data.window_caches.end() || it->second.frame != data.frame) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+GLTexture* BlurEffect::store_window_cache(blur_render_data& data,
+                                          blur_window_cache* cache,
+                                          QRegion const& shape,
+                                          bool is_dock)
+{
+    auto& result = data.targets.at(1);
+    if (!cache) {
+        return result.texture.get();
+    }
+
+    if (!cache->target) {
+        // Only the most recently drawn backgrounds keep a target. Targets drawn in this frame are
+        // not evicted, so that many blurred windows do not reallocate their targets every frame.
+        auto with_target = [](auto const& entry) { return entry.second.target != nullptr; };
+        if (std::count_if(data.window_caches.cbegin(), data.window_caches.cend(), with_target)
+            >= static_cast<std::ptrdiff_t>(max_cached_windows)) {
+            auto oldest = data.window_caches.end();
+            for (auto it = data.window_caches.begin(); it != data.window_caches.end(); it++) {
+                if (with_target(*it)
+                    && (oldest == data.window_caches.end()
+                        || it->second.last_use < oldest->second.last_use)) {
+                    oldest = it;
+                }
+            }
+            if (oldest->second.last_use == data.frame) {
+                return result.texture.get();
+            }
+            oldest->second.target.reset();
+            oldest->second.valid = false;
+        }
+
+        cache->target = std::make_unique<blur_render_target>(std::make_unique<GLTexture>(
+            result.texture->internalFormat(), result.texture->size()));
+        if (!cache->target->fbo->valid()) {
+            cache->target.reset();
+            return result.texture.get();
+        }
+    }
+
+    // Swap the result into the cache instead of copying it. The previously cached target is used
+    // for the next blur passes instead.
+    std::swap(result, *cache->target);
+    update_stack(data);
+
+    cache->shape = shape;
+    cache->is_dock = is_dock;
+    cache->last_use = data.frame;
+    cache->valid = true;
+
+    return cache->target->texture.get();
+}
+
 bool BlurEffect::should_blur(effect::window_paint_data const& data) const
 {
     if (!render_targets_are_valid || !shader || !shader->isValid()) {
@@ -585,7 +735,7 @@ void BlurEffect::do_blur(effect::window_paint_data& data, QRegion const& shape,
     auto const opacity = data.paint.opacity * data.window.opacity();
 
     assert(current_screen);
-    auto const& screen_data = render_screens.at(current_screen);
+    auto& screen_data = render_screens.at(current_screen);
     auto const screen_geo = current_screen->geometry();
     auto const expanded_blur_region = expand(shape) & expand(screen_geo);
     auto const use_srgb = screen_data.targets.front().texture->internalFormat() == GL_SRGB8_ALPHA8;
@@ -594,42 +744,62 @@ void BlurEffect::do_blur(effect::window_paint_data& data, QRegion const& shape,
         glEnable(GL_FRAMEBUFFER_SRGB);
     }
 
-    // Upload geometry for the down and upsample iterations
     auto vbo = GLVertexBuffer::streamingBuffer();
     vbo->reset();
 
-    upload_geometry(vbo, expanded_blur_region, shape);
-
-    auto const logicalSourceRect = expanded_blur_region.boundingRect() & screen_geo;
-    int blurRectCount = expanded_blur_region.rectCount() * 6;
-
-    /*
-     * If the window is a dock or panel we avoid the "extended blur" effect.
-     * Extended blur is when windows that are not under the blurred area affect
-     * the final blur result.
-     * We want to avoid this on panels, because it looks really weird and ugly
-     * when maximized windows or windows near the panel affect the dock blur.
-     */
-    if (isDock) {
-        screen_data.targets.back().fbo->blit_from_current_render_target(
-            data.render, logicalSourceRect, logicalSourceRect.translated(-screen_geo.topLeft()));
-        render::push_framebuffers(data.render, screen_data.stack);
+    auto cache = get_window_cache(screen_data, data);
+    GLTexture* blurred_texture{nullptr};
+    int blurRectCount{0};
 
+    if (cache && cache->valid && cache->is_dock == isDock && (shape - cache->shape).isEmpty()) {
+        // Nothing changed behind the window. Only the final pass to the screen is needed.
+        upload_geometry(vbo, QRegion(), shape);
         vbo->bindArrays();
-        copy_screen_sample_texture(
-            data.render, screen_data, vbo, blurRectCount, shape.boundingRect());
+        blurred_texture = cache->target->texture.get();
+        cache->last_use = screen_data.frame;
+        cache_hit_count++;
     } else {
-        screen_data.targets.front().fbo->blit_from_current_render_target(
-            data.render, logicalSourceRect, logicalSourceRect.translated(-screen_geo.topLeft()));
-        render::push_framebuffers(data.render, screen_data.stack);
+        // Upload geometry for the down and upsample iterations
+        upload_geometry(vbo, expanded_blur_region, shape);
+
+        auto const logicalSourceRect = expanded_blur_region.boundingRect() & screen_geo;
+        blurRectCount = expanded_blur_region.rectCount() * 6;
+
+        /*
+         * If the window is a dock or panel we avoid the "extended blur" effect.
+         * Extended blur is when windows that are not under the blurred area affect
+         * the final blur result.
+         * We want to avoid this on panels, because it looks really weird and ugly
+         * when maximized windows or windows near the panel affect the dock blur.
+         */
+        if (isDock) {
+            screen_data.targets.back().fbo->blit_from_current_render_target(
+                data.render,
+                logicalSourceRect,
+                logicalSourceRect.translated(-screen_geo.topLeft()));
+            render::push_framebuffers(data.render, screen_data.stack);
+
+            vbo->bindArrays();
+            copy_screen_sample_texture(
+                data.render, screen_data, vbo, blurRectCount, shape.boundingRect());
+        } else {
+            screen_data.targets.front().fbo->blit_from_current_render_target(
+                data.render,
+                logicalSourceRect,
+                logicalSourceRect.translated(-screen_geo.topLeft()));
+            render::push_framebuffers(data.render, screen_data.stack);
+
+            // Remove the screen_data.targets.front() from the top of the stack that we will not
+            // use.
+            render::pop_framebuffer(data.render);
+        }
 
-        // Remove the screen_data.targets.front() from the top of the stack that we will not use.
-        render::pop_framebuffer(data.render);
-    }
+        vbo->bindArrays();
+        downsample_texture(data.render, screen_data, vbo, blurRectCount);
+        upsample_texture(data.render, screen_data, vbo, blurRectCount);
 
-    vbo->bindArrays();
-    downsample_texture(data.render, screen_data, vbo, blurRectCount);
-    upsample_texture(data.render, screen_data, vbo, blurRectCount);
+        blurred_texture = store_window_cache(screen_data, cache, shape, isDock);
+    }
 
     // Modulate the blurred texture with the window opacity if the window isn't opaque
     if (opacity < 1.0) {
@@ -645,7 +815,8 @@ void BlurEffect::do_blur(effect::window_paint_data& data, QRegion const& shape,
         glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
     }
 
-    upsample_to_screen(screen_data, data, vbo, blurRectCount, shape.rectCount() * 6);
+    upsample_to_screen(
+        blurred_texture, screen_data, data, vbo, blurRectCount, shape.rectCount() * 6);
 
     if (use_srgb) {
         glDisable(GL_FRAMEBUFFER_SRGB);
@@ -679,14 +850,14 @@ void BlurEffect::do_blur(effect::window_paint_data& data, QRegion const& shape,
     vbo->unbindArrays();
 }
 
-void BlurEffect::upsample_to_screen(blur_render_data const& data,
+void BlurEffect::upsample_to_screen(GLTexture* texture,
+                                    blur_render_data const& data,
                                     effect::window_paint_data const& win_data,
                                     GLVertexBuffer* vbo,
                                     int vboStart,
                                     int blurRectCount)
 {
-    auto const& tex = data.targets.at(1).texture;
-    tex->bind();
+    texture->bind();
 
     shader->bind(BlurShader::UpSampleType);
 
@@ -17,6 +17,7 @@
 #include <QVector>
 #include <span>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 namespace como
@@ -39,15 +40,38 @@ struct blur_render_target {
     std::unique_ptr<GLFramebuffer> fbo;
 };
 
+/**
+ * The blurred background behind a window. As long as nothing changes behind the window the cached
+ * result is drawn again instead of running the down- and upsample passes on every repaint.
+ */
+struct blur_window_cache {
+    // Holds the final upsample pass result with the same size as the first downsampled target.
+    std::unique_ptr<blur_render_target> target;
+    // The area that was blurred into the target.
+    QRegion shape;
+    // The blur area of the window when the cache was last checked.
+    QRegion blur_area;
+    uint64_t frame{0};
+    // The frame the target was last drawn in, for evicting the least recently used one.
+    uint64_t last_use{0};
+    bool is_dock{false};
+    bool valid{false};
+};
+
 struct blur_render_data {
     EffectScreen const& screen;
     std::vector<blur_render_target> targets;
     std::stack<GLFramebuffer*> stack;
+
+    std::unordered_map<EffectWindow const*, blur_window_cache> window_caches;
+    uint64_t frame{0};
 };
 
 class BlurEffect : public como::Effect
 {
     Q_OBJECT
+    /// Number of blurred backgrounds drawn from the cache. For debugging.
+    Q_PROPERTY(qulonglong cacheHits READ cache_hits)
 
 public:
     BlurEffect();
@@ -71,6 +95,7 @@ public:
     }
 
     void reset();
+    qulonglong cache_hits() const;
 
     QMap<EffectWindow const*, QRegion> blur_regions;
 
@@ -82,6 +107,17 @@ private:
     void init_blur_strength_values();
     void update_texture();
     void update_texture(blur_render_data& data);
+    void update_stack(blur_render_data& data);
+    void remove_window_cache(EffectWindow const* win);
+    void update_window_cache(effect::window_prepaint_data const& data,
+                             QRegion const& blur_area,
+                             QRegion const& expanded_blur);
+    blur_window_cache* get_window_cache(blur_render_data& data,
+                                        effect::window_paint_data const& win_data);
+    GLTexture* store_window_cache(blur_render_data& data,
+                                  blur_window_cache* cache,
+                                  QRegion const& shape,
+                                  bool is_dock);
     QRegion blur_region(EffectWindow const* win) const;
     QRegion deco_blur_region(EffectWindow const* win) const;
     bool deco_supports_blur_behind(EffectWindow const* win) const;
@@ -93,7 +129,8 @@ private:
                          QRegion const& blur_region);
     void generate_noise_texture();
 
-    void upsample_to_screen(blur_render_data const& data,
+    void upsample_to_screen(GLTexture* texture,
+                            blur_render_data const& data,
                             effect::window_paint_data const& win_data,
                             GLVertexBuffer* vbo,
                             int vboStart,
@@ -123,6 +160,7 @@ private:
     bool render_targets_are_valid{false};
 
     EffectScreen const* current_screen{nullptr};
+    qulonglong cache_hit_count{0};
 
     GLTexture noise_texture;
 
@@ -56,6 +56,11 @@ public:
     void windowInputMouseEvent(QEvent* e) override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override
     {
         return 50;
@@ -35,6 +35,11 @@ public:
     void paintWindow(effect::window_paint_data& data) override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override
     {
         return 50;
@@ -39,6 +39,11 @@ public:
     int requestedEffectChainPosition() const override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int dimStrength() const;
     bool dimPanels() const;
     bool dimDesktop() const;
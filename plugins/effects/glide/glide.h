@@ -48,6 +48,12 @@ public:
     void postPaintScreen() override;
 
     bool isActive() const override;
+
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override;
 
     static bool supported();
@@ -29,6 +29,12 @@ public:
 
     void drawWindow(effect::window_paint_data& data) override;
     bool isActive() const override;
+
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     bool provides(Feature) override;
 
     int requestedEffectChainPosition() const override;
@@ -30,6 +30,11 @@ public:
     void reconfigure(ReconfigureFlags flags) override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override
     {
         return 99;
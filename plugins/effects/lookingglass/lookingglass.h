@@ -36,6 +36,11 @@ public:
     void paintScreen(effect::screen_paint_data& data) override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     static bool supported();
 
     // for properties
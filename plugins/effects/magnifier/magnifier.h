@@ -30,6 +30,12 @@ public:
     void paintScreen(effect::screen_paint_data& data) override;
     void postPaintScreen() override;
     bool isActive() const override;
+
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     static bool supported();
 
     // for properties
@@ -87,6 +87,11 @@ public:
     void postPaintScreen() override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     // for properties
     QColor color1() const;
     QColor color2() const;
@@ -32,6 +32,11 @@ public:
     void paintScreen(effect::screen_paint_data& data) override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override
     {
         return 10;
@@ -7,6 +7,8 @@
 */
 #include "screenshot.h"
 #include "screenshotdbusinterface2.h"
+#include "screenshotreadback.h"
+#include "screenshotstream.h"
 
 #include <como/render/effect/interface/effect_window.h>
 #include <como/render/effect/interface/effects_handler.h>
@@ -14,6 +16,7 @@
 #include <como/render/gl/interface/texture.h>
 
 #include <QPainter>
+#include <QPointer>
 
 Q_LOGGING_CATEGORY(KWIN_SCREENSHOT, "kwin_effect_screenshot", QtWarningMsg)
 
@@ -40,6 +43,69 @@ struct ScreenShotScreenData {
     EffectScreen* screen = nullptr;
 };
 
+struct ScreenShotCursor {
+    QImage image;
+    QPoint position;
+};
+
+struct ScreenShotReadbackData {
+    QPromise<QImage> promise;
+    std::unique_ptr<ScreenShotReadback> readback;
+    qreal devicePixelRatio = 1.;
+
+    // Grabbed together with the pixels so it matches them.
+    std::optional<ScreenShotCursor> cursor;
+};
+
+struct ScreenShotStreamData {
+    QPointer<ScreenShotStream> stream;
+    ScreenShotFlags flags;
+    EffectScreen* screen = nullptr;
+    EffectWindow* window = nullptr;
+
+    // The captured area in logical coordinates. Follows the window for window streams.
+    QRect area;
+    // Pixels of the frames per logical pixel.
+    qreal scale = 1.;
+    // Repainted since it was last captured.
+    QRegion damage;
+};
+
+static QRect scaledRect(QRect const& rect, qreal scale)
+{
+    return QRectF(QPointF(rect.topLeft()) * scale, QSizeF(rect.size()) * scale).toAlignedRect();
+}
+
+static QRegion scaledRegion(QRegion const& region, qreal scale)
+{
+    QRegion scaled;
+    for (auto const& rect : region) {
+        scaled |= scaledRect(rect, scale);
+    }
+    return scaled;
+}
+
+static QRect windowScreenShotGeometry(EffectWindow* window, ScreenShotFlags flags)
+{
+    if (window->hasDecoration() && !(flags & ScreenShotIncludeDecoration)) {
+        return window->clientGeometry();
+    }
+    if (!(flags & ScreenShotIncludeShadow)) {
+        return window->frameGeometry();
+    }
+    return window->expandedGeometry();
+}
+
+static qreal windowScreenShotDevicePixelRatio(EffectWindow* window, ScreenShotFlags flags)
+{
+    if (flags & ScreenShotNativeResolution) {
+        if (auto const screen = window->screen()) {
+            return screen->devicePixelRatio();
+        }
+    }
+    return 1.;
+}
+
 static void
 convertFromGLImage(QImage& img, int w, int h, QMatrix4x4 const& renderTargetTransformation)
 {
@@ -88,6 +154,9 @@ ScreenShotEffect::ScreenShotEffect()
     connect(effects, &EffectsHandler::screenAdded, this, &ScreenShotEffect::handleScreenAdded);
     connect(effects, &EffectsHandler::screenRemoved, this, &ScreenShotEffect::handleScreenRemoved);
     connect(effects, &EffectsHandler::windowClosed, this, &ScreenShotEffect::handleWindowClosed);
+
+    m_readbackTimer.setInterval(4);
+    connect(&m_readbackTimer, &QTimer::timeout, this, &ScreenShotEffect::finishReadbacks);
 }
 
 ScreenShotEffect::~ScreenShotEffect()
@@ -95,6 +164,7 @@ ScreenShotEffect::~ScreenShotEffect()
     cancelWindowScreenShots();
     cancelAreaScreenShots();
     cancelScreenScreenShots();
+    cancelReadbacks();
 }
 
 QFuture<QImage> ScreenShotEffect::scheduleScreenShot(EffectScreen* screen, ScreenShotFlags flags)
@@ -180,6 +250,130 @@ QFuture<QImage> ScreenShotEffect::scheduleScreenShot(EffectWindow* window, Scree
     return future;
 }
 
+ScreenShotStream* ScreenShotEffect::streamScreenShots(EffectScreen* screen,
+                                                     ScreenShotFlags flags,
+                                                     uint rate,
+                                                     uint slotCount)
+{
+    // The image is in native pixels of the render target, plus the device pixel ratio on request.
+    auto devicePixelRatio = screen->devicePixelRatio();
+    if (flags & ScreenShotNativeResolution) {
+        devicePixelRatio *= screen->devicePixelRatio();
+    }
+
+    ScreenShotStreamData data;
+    data.flags = flags;
+    data.screen = screen;
+    data.area = screen->geometry();
+    data.scale = devicePixelRatio;
+
+    return startStream(
+        std::move(data), screen->geometry().size() * devicePixelRatio, rate, slotCount);
+}
+
+ScreenShotStream* ScreenShotEffect::streamScreenShots(const QRect& area,
+                                                     ScreenShotFlags flags,
+                                                     uint rate,
+                                                     uint slotCount)
+{
+    auto devicePixelRatio = 1.;
+    if (flags & ScreenShotNativeResolution) {
+        for (auto const screen : effects->screens()) {
+            if (screen->geometry().intersects(area)) {
+                devicePixelRatio = std::max(devicePixelRatio, screen->devicePixelRatio());
+            }
+        }
+    }
+
+    ScreenShotStreamData data;
+    data.flags = flags;
+    data.area = area;
+    data.scale = devicePixelRatio;
+
+    return startStream(std::move(data), area.size() * devicePixelRatio, rate, slotCount);
+}
+
+ScreenShotStream* ScreenShotEffect::streamScreenShots(EffectWindow* window,
+                                                     ScreenShotFlags flags,
+                                                     uint rate,
+                                                     uint slotCount)
+{
+    auto devicePixelRatio = 1.;
+    if (flags & ScreenShotNativeResolution) {
+        for (auto const screen : effects->screens()) {
+            devicePixelRatio = std::max(devicePixelRatio, screen->devicePixelRatio());
+        }
+    }
+
+    // The window may be resized while it is captured. It is not expected to be larger than the
+    // workspace though.
+    auto const maxSize = window->expandedGeometry().size().expandedTo(effects->virtualScreenSize());
+
+    ScreenShotStreamData data;
+    data.flags = flags;
+    data.window = window;
+    data.area = windowScreenShotGeometry(window, flags);
+
+    return startStream(std::move(data), maxSize * devicePixelRatio, rate, slotCount);
+}
+
+ScreenShotStream* ScreenShotEffect::startStream(ScreenShotStreamData&& data,
+                                                QSize const& maxSize,
+                                                uint rate,
+                                                uint slotCount)
+{
+    auto stream = new ScreenShotStream(maxSize, rate, slotCount, this);
+    if (!stream->isValid()) {
+        delete stream;
+        return nullptr;
+    }
+
+    // The cursor is not part of the damage and would remain in frames which are only updated in
+    // parts.
+    data.flags.setFlag(ScreenShotIncludeCursor, false);
+    data.stream = stream;
+
+    // The first frame is complete.
+    data.damage = data.area;
+    if (data.window) {
+        data.window->addRepaintFull();
+    } else {
+        effects->addRepaint(data.area);
+    }
+
+    connect(stream, &ScreenShotStream::captureDue, this, [this, stream] {
+        for (auto const& data : m_streams) {
+            if (data.stream == stream && !data.damage.isEmpty()) {
+                effects->addRepaint(data.damage);
+            }
+        }
+    });
+    connect(stream, &ScreenShotStream::stopped, this, [this, stream] {
+        std::erase_if(m_streams, [stream](auto const& data) { return data.stream == stream; });
+    });
+
+    m_streams.push_back(std::move(data));
+    return stream;
+}
+
+void ScreenShotEffect::stopStreams(
+    std::function<bool(ScreenShotStreamData const&)> const& predicate)
+{
+    // Stopping a stream removes it from the list, so collect them first.
+    QList<QPointer<ScreenShotStream>> streams;
+    for (auto const& data : m_streams) {
+        if (predicate(data)) {
+            streams.append(data.stream);
+        }
+    }
+
+    for (auto const& stream : std::as_const(streams)) {
+        if (stream) {
+            stream->stop();
+        }
+    }
+}
+
 void ScreenShotEffect::cancelWindowScreenShots()
 {
     m_windowScreenShots.clear();
@@ -195,11 +389,77 @@ void ScreenShotEffect::cancelScreenScreenShots()
     m_screenScreenShots.clear();
 }
 
+void ScreenShotEffect::cancelReadbacks()
+{
+    if (m_readbacks.empty()) {
+        return;
+    }
+
+    m_readbackTimer.stop();
+    effects->makeOpenGLContextCurrent();
+    m_readbacks.clear();
+}
+
+void ScreenShotEffect::startReadback(QPromise<QImage>&& promise,
+                                     QSize const& size,
+                                     bool fromGL,
+                                     qreal devicePixelRatio,
+                                     std::optional<ScreenShotCursor> cursor)
+{
+    using conversion = ScreenShotReadback::Conversion;
+
+    m_readbacks.push_back({
+        .promise = std::move(promise),
+        .readback = std::make_unique<ScreenShotReadback>(
+            size, fromGL ? conversion::FromGL : conversion::None),
+        .devicePixelRatio = devicePixelRatio,
+        .cursor = std::move(cursor),
+    });
+
+    if (!m_readbackTimer.isActive()) {
+        m_readbackTimer.start();
+    }
+}
+
+void ScreenShotEffect::finishReadbacks()
+{
+    effects->makeOpenGLContextCurrent();
+
+    for (auto it = m_readbacks.begin(); it != m_readbacks.end();) {
+        if (!it->readback->isReady()) {
+            ++it;
+            continue;
+        }
+
+        auto image = it->readback->take();
+        image.setDevicePixelRatio(it->devicePixelRatio);
+
+        if (it->cursor && !image.isNull()) {
+            QPainter painter(&image);
+            painter.setRenderHint(QPainter::SmoothPixmapTransform);
+            painter.drawImage(it->cursor->position, it->cursor->image);
+        }
+
+        it->promise.addResult(image);
+        it->promise.finish();
+        it = m_readbacks.erase(it);
+    }
+
+    if (m_readbacks.empty()) {
+        m_readbackTimer.stop();
+    }
+}
+
 void ScreenShotEffect::paintScreen(effect::screen_paint_data& data)
 {
     m_paintedScreen = data.screen;
+    auto const painted = data.paint.region;
     effects->paintScreen(data);
 
+    if (!m_streams.empty()) {
+        captureStreams(data.render, painted);
+    }
+
     for (auto& win_data : m_windowScreenShots) {
         takeScreenShot(data.render, &win_data);
     }
@@ -218,24 +478,91 @@ void ScreenShotEffect::paintScreen(effect::screen_paint_data& data)
     }
 }
 
-void ScreenShotEffect::takeScreenShot(effect::render_data& data, ScreenShotWindowData* screenshot)
+void ScreenShotEffect::captureStreams(effect::render_data& render_data, QRegion const& painted)
 {
-    auto window = screenshot->window;
-    auto geometry = window->expandedGeometry();
-    auto devicePixelRatio = 1.;
+    for (auto& data : m_streams) {
+        if (!data.stream) {
+            continue;
+        }
 
-    if (window->hasDecoration() && !(screenshot->flags & ScreenShotIncludeDecoration)) {
-        geometry = window->clientGeometry();
-    } else if (!(screenshot->flags & ScreenShotIncludeShadow)) {
-        geometry = window->frameGeometry();
-    }
+        if (data.window) {
+            data.area = windowScreenShotGeometry(data.window, data.flags);
+        } else if (data.screen && m_paintedScreen && data.screen != m_paintedScreen) {
+            continue;
+        }
 
-    if (screenshot->flags & ScreenShotNativeResolution) {
-        if (auto const screen = window->screen()) {
-            devicePixelRatio = screen->devicePixelRatio();
+        data.damage |= painted & data.area;
+
+        // Windows are rendered as a whole, screens can only be read back where they were painted.
+        auto const available = data.window || !m_paintedScreen
+            ? data.area
+            : data.area & m_paintedScreen->geometry();
+        auto const damage = data.damage & available;
+
+        if (damage.isEmpty()) {
+            continue;
+        }
+        if (!data.stream->isDue()) {
+            data.stream->scheduleCapture();
+            continue;
         }
+
+        data.damage -= available;
+
+        if (data.window) {
+            auto const scale = windowScreenShotDevicePixelRatio(data.window, data.flags);
+            auto const frameDamage = scaledRegion(damage.translated(-data.area.topLeft()), scale);
+
+            ScreenShotWindowData screenshot;
+            screenshot.window = data.window;
+            screenshot.flags = data.flags;
+            screenshot.promise.start();
+
+            auto const future = screenshot.promise.future();
+            takeScreenShot(render_data, &screenshot);
+            data.stream->submit(future, {}, frameDamage);
+            continue;
+        }
+
+        auto const geometry = damage.boundingRect();
+        auto const target = scaledRect(geometry.translated(-data.area.topLeft()), data.scale);
+
+        data.stream->submit(readbackArea(render_data, geometry, target.size()),
+                            target,
+                            scaledRegion(damage.translated(-data.area.topLeft()), data.scale));
+    }
+}
+
+QFuture<QImage> ScreenShotEffect::readbackArea(effect::render_data& render_data,
+                                               QRect const& geometry,
+                                               QSize const& size)
+{
+    QPromise<QImage> promise;
+    promise.start();
+    auto future = promise.future();
+
+    if (ScreenShotReadback::supported() && GLFramebuffer::blitSupported()) {
+        GLTexture texture(GL_RGBA8, size.width(), size.height());
+        GLFramebuffer target(&texture);
+        target.blit_from_current_render_target(render_data, geometry, QRect({}, size));
+
+        render::push_framebuffer(render_data, &target);
+        startReadback(std::move(promise), size, false, 1., {});
+        render::pop_framebuffer(render_data);
+        return future;
     }
 
+    promise.addResult(blitScreenshot(render_data, geometry));
+    promise.finish();
+    return future;
+}
+
+void ScreenShotEffect::takeScreenShot(effect::render_data& data, ScreenShotWindowData* screenshot)
+{
+    auto window = screenshot->window;
+    auto const geometry = windowScreenShotGeometry(window, screenshot->flags);
+    auto const devicePixelRatio = windowScreenShotDevicePixelRatio(window, screenshot->flags);
+
     auto validTarget = true;
     std::unique_ptr<GLTexture> offscreenTexture;
     std::unique_ptr<GLFramebuffer> fbo;
@@ -277,6 +604,23 @@ void ScreenShotEffect::takeScreenShot(effect::render_data& data, ScreenShotWindo
 
         effects->drawWindow(win_data);
 
+        if (ScreenShotReadback::supported()) {
+            std::optional<ScreenShotCursor> cursor;
+            if (screenshot->flags & ScreenShotIncludeCursor) {
+                cursor = grabCursor(geometry.x(), geometry.y());
+            }
+
+            // The offscreen texture and framebuffer are released by the driver once the copy
+            // completed.
+            startReadback(std::move(screenshot->promise),
+                          offscreenTexture->size(),
+                          true,
+                          devicePixelRatio,
+                          std::move(cursor));
+            render::pop_framebuffer(data);
+            return;
+        }
+
         // copy content from framebuffer into image
         img = QImage(offscreenTexture->size(), QImage::Format_ARGB32);
         img.setDevicePixelRatio(devicePixelRatio);
@@ -361,7 +705,33 @@ bool ScreenShotEffect::takeScreenShot(effect::render_data& render_data,
         devicePixelRatio = screenshot->screen->devicePixelRatio();
     }
 
-    auto snapshot = blitScreenshot(render_data, screenshot->screen->geometry(), devicePixelRatio);
+    auto const geometry = screenshot->screen->geometry();
+
+    if (ScreenShotReadback::supported() && GLFramebuffer::blitSupported()) {
+        // Same as blitScreenshot but the pixels are read back asynchronously.
+        auto const nativeSize
+            = effect::map_to_viewport(render_data, geometry).size() * devicePixelRatio;
+
+        GLTexture texture(GL_RGBA8, nativeSize.width(), nativeSize.height());
+        GLFramebuffer target(&texture);
+        target.blit_from_current_render_target(render_data, geometry, QRect({}, geometry.size()));
+
+        std::optional<ScreenShotCursor> cursor;
+        if (screenshot->flags & ScreenShotIncludeCursor) {
+            cursor = grabCursor(geometry.x(), geometry.y());
+        }
+
+        render::push_framebuffer(render_data, &target);
+        startReadback(std::move(screenshot->promise),
+                      nativeSize,
+                      false,
+                      devicePixelRatio,
+                      std::move(cursor));
+        render::pop_framebuffer(render_data);
+        return true;
+    }
+
+    auto snapshot = blitScreenshot(render_data, geometry, devicePixelRatio);
     if (screenshot->flags & ScreenShotIncludeCursor) {
         const int xOffset = screenshot->screen->geometry().x();
         const int yOffset = screenshot->screen->geometry().y();
@@ -381,27 +751,39 @@ QImage ScreenShotEffect::blitScreenshot(effect::render_data& render_data,
     return effects->blit_from_framebuffer(render_data, geometry, devicePixelRatio);
 }
 
-void ScreenShotEffect::grabPointerImage(QImage& snapshot, int xOffset, int yOffset) const
+std::optional<ScreenShotCursor> ScreenShotEffect::grabCursor(int xOffset, int yOffset) const
 {
     if (effects->isCursorHidden()) {
-        return;
+        return {};
     }
 
     auto const cursor = effects->cursorImage();
     if (cursor.image.isNull()) {
+        return {};
+    }
+
+    return ScreenShotCursor{
+        .image = cursor.image,
+        .position = effects->cursorPos() - cursor.hot_spot - QPoint(xOffset, yOffset),
+    };
+}
+
+void ScreenShotEffect::grabPointerImage(QImage& snapshot, int xOffset, int yOffset) const
+{
+    auto const cursor = grabCursor(xOffset, yOffset);
+    if (!cursor) {
         return;
     }
 
     QPainter painter(&snapshot);
     painter.setRenderHint(QPainter::SmoothPixmapTransform);
-    painter.drawImage(effects->cursorPos() - cursor.hot_spot - QPoint(xOffset, yOffset),
-                      cursor.image);
+    painter.drawImage(cursor->position, cursor->image);
 }
 
 bool ScreenShotEffect::isActive() const
 {
     return (!m_windowScreenShots.empty() || !m_areaScreenShots.empty()
-            || !m_screenScreenShots.empty())
+            || !m_screenScreenShots.empty() || !m_streams.empty())
         && !effects->isScreenLocked();
 }
 
@@ -413,11 +795,15 @@ int ScreenShotEffect::requestedEffectChainPosition() const
 void ScreenShotEffect::handleScreenAdded()
 {
     cancelAreaScreenShots();
+    stopStreams([](auto const& data) { return !data.screen && !data.window; });
 }
 
 void ScreenShotEffect::handleScreenRemoved(EffectScreen* screen)
 {
     cancelAreaScreenShots();
+    stopStreams([screen](auto const& data) {
+        return data.screen == screen || (!data.screen && !data.window);
+    });
 
     std::erase_if(m_screenScreenShots,
                   [screen](const auto& screenshot) { return screenshot.screen == screen; });
@@ -425,6 +811,7 @@ void ScreenShotEffect::handleScreenRemoved(EffectScreen* screen)
 
 void ScreenShotEffect::handleWindowClosed(EffectWindow* window)
 {
+    stopStreams([window](auto const& data) { return data.window == window; });
     std::erase_if(m_windowScreenShots,
                   [window](const auto& screenshot) { return screenshot.window == window; });
 }
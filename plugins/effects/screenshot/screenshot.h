@@ -14,6 +14,10 @@
 #include <QImage>
 #include <QLoggingCategory>
 #include <QObject>
+#include <QPromise>
+#include <QTimer>
+#include <functional>
+#include <optional>
 
 Q_DECLARE_LOGGING_CATEGORY(KWIN_SCREENSHOT)
 
@@ -32,9 +36,13 @@ enum ScreenShotFlag {
 Q_DECLARE_FLAGS(ScreenShotFlags, ScreenShotFlag)
 
 class ScreenShotDBusInterface2;
+class ScreenShotStream;
 struct ScreenShotWindowData;
 struct ScreenShotAreaData;
 struct ScreenShotScreenData;
+struct ScreenShotReadbackData;
+struct ScreenShotStreamData;
+struct ScreenShotCursor;
 
 /**
  * The ScreenShotEffect provides a convenient way to capture the contents of a given window,
@@ -72,8 +80,36 @@ public:
      */
     QFuture<QImage> scheduleScreenShot(EffectWindow* window, ScreenShotFlags flags = {});
 
+    /**
+     * Captures the given @a screen continuously with at most @a rate frames per second. The
+     * frames are written into a ring buffer of @a slotCount frames in shared memory. Only what the
+     * compositor repainted is read back. The cursor is never included. The stream is owned by the
+     * effect. It stops when the screen is removed.
+     */
+    ScreenShotStream*
+    streamScreenShots(EffectScreen* screen, ScreenShotFlags flags, uint rate, uint slotCount = 3);
+
+    /**
+     * Captures the given @a area continuously. It stops when a screen is added or removed.
+     */
+    ScreenShotStream*
+    streamScreenShots(const QRect& area, ScreenShotFlags flags, uint rate, uint slotCount = 3);
+
+    /**
+     * Captures the given @a window continuously. The window is captured as a whole whenever a
+     * part of it was repainted. It stops when the window is closed.
+     */
+    ScreenShotStream*
+    streamScreenShots(EffectWindow* window, ScreenShotFlags flags, uint rate, uint slotCount = 3);
+
     void paintScreen(effect::screen_paint_data& data) override;
     bool isActive() const override;
+
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override;
 
     static bool supported();
@@ -91,8 +127,26 @@ private:
     void cancelWindowScreenShots();
     void cancelAreaScreenShots();
     void cancelScreenScreenShots();
+    void cancelReadbacks();
 
+    void startReadback(QPromise<QImage>&& promise,
+                       QSize const& size,
+                       bool fromGL,
+                       qreal devicePixelRatio,
+                       std::optional<ScreenShotCursor> cursor);
+    void finishReadbacks();
+
+    std::optional<ScreenShotCursor> grabCursor(int xOffset, int yOffset) const;
     void grabPointerImage(QImage& snapshot, int xOffset, int yOffset) const;
+    ScreenShotStream* startStream(ScreenShotStreamData&& data,
+                                  QSize const& maxSize,
+                                  uint rate,
+                                  uint slotCount);
+    void captureStreams(effect::render_data& render_data, QRegion const& painted);
+    QFuture<QImage> readbackArea(effect::render_data& render_data,
+                                 QRect const& geometry,
+                                 QSize const& size);
+    void stopStreams(std::function<bool(ScreenShotStreamData const&)> const& predicate);
     QImage blitScreenshot(effect::render_data& viewport,
                           const QRect& geometry,
                           qreal devicePixelRatio = 1.0) const;
@@ -101,6 +155,12 @@ private:
     std::vector<ScreenShotAreaData> m_areaScreenShots;
     std::vector<ScreenShotScreenData> m_screenScreenShots;
 
+    // Captures whose pixels are still being copied by the GPU. Polled until their fences signal.
+    std::vector<ScreenShotReadbackData> m_readbacks;
+    QTimer m_readbackTimer;
+
+    std::vector<ScreenShotStreamData> m_streams;
+
     QScopedPointer<ScreenShotDBusInterface2> m_dbusInterface2;
     EffectScreen const* m_paintedScreen{nullptr};
 };
@@ -11,7 +11,9 @@
 
 #include <QDBusContext>
 #include <QDBusUnixFileDescriptor>
+#include <QHash>
 #include <QObject>
+#include <QPointer>
 #include <QVariantMap>
 
 namespace como
@@ -20,6 +22,8 @@ namespace como
 class ScreenShotEffect;
 class ScreenShotSinkPipe2;
 class ScreenShotSource2;
+class ScreenShotStream;
+class QDBusServiceWatcher;
 
 /**
  * The ScreenshotDBusInterface2 class provides a d-bus api to take screenshots. This implements
@@ -56,6 +60,11 @@ public Q_SLOTS:
     CaptureInteractive(uint kind, const QVariantMap& options, QDBusUnixFileDescriptor pipe);
     QVariantMap CaptureWorkspace(const QVariantMap& options, QDBusUnixFileDescriptor pipe);
 
+    QVariantMap StreamScreen(const QString& name, const QVariantMap& options);
+    QVariantMap StreamArea(int x, int y, int width, int height, const QVariantMap& options);
+    QVariantMap StreamWindow(const QString& handle, const QVariantMap& options);
+    void StopStream(uint stream);
+
 private:
     void takeScreenShot(EffectScreen* screen, ScreenShotFlags flags, ScreenShotSinkPipe2* sink);
     void takeScreenShot(const QRect& area, ScreenShotFlags flags, ScreenShotSinkPipe2* sink);
@@ -64,7 +73,20 @@ private:
     void bind(ScreenShotSinkPipe2* sink, ScreenShotSource2* source);
     bool checkPermissions() const;
 
+    QVariantMap registerStream(ScreenShotStream* stream);
+    void unregisterStream(uint id);
+    void stopStreams(const QString& service);
+
+    struct Stream {
+        QPointer<ScreenShotStream> stream;
+        QString service;
+    };
+
     ScreenShotEffect* m_effect;
+
+    QHash<uint, Stream> m_streams;
+    uint m_lastStreamId{0};
+    QDBusServiceWatcher* m_streamWatcher;
 };
 
 }
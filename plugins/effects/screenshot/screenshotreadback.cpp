@@ -0,0 +1,165 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "screenshotreadback.h"
+
+#include "screenshot.h"
+
+#include <como/render/gl/interface/platform.h>
+#include <como/render/gl/interface/utils.h>
+
+#include <QSysInfo>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace como
+{
+
+namespace
+{
+
+// OpenGL gives ABGR (i.e. RGBA backwards); Qt wants ARGB. Only needed on OpenGL ES, where we can't
+// let the driver pack the pixels in the order of QImage.
+void swizzle_row(uint32_t const* src, uint32_t* dst, int width)
+{
+    int x = 0;
+
+    if constexpr (QSysInfo::ByteOrder == QSysInfo::LittleEndian) {
+#if defined(__SSE2__)
+        auto const red_blue = _mm_set1_epi32(0x00ff00ff);
+        auto const alpha_green = _mm_set1_epi32(static_cast<int>(0xff00ff00));
+
+        for (; x + 4 <= width; x += 4) {
+            auto const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + x));
+            auto const rb = _mm_and_si128(pixels, red_blue);
+            auto const br = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                             _mm_or_si128(_mm_and_si128(br, red_blue),
+                                          _mm_and_si128(pixels, alpha_green)));
+        }
+#endif
+        for (; x < width; x++) {
+            auto const pixel = src[x];
+            dst[x] = ((pixel << 16) & 0xff0000) | ((pixel >> 16) & 0xff) | (pixel & 0xff00ff00);
+        }
+    } else {
+        // OpenGL gives RGBA; Qt wants ARGB
+        for (; x < width; x++) {
+            dst[x] = (src[x] >> 8) | (src[x] << 24);
+        }
+    }
+}
+
+}
+
+ScreenShotReadback::ScreenShotReadback(QSize const& size, Conversion conversion)
+    : m_size(size)
+    , m_conversion(conversion)
+{
+    if (conversion == Conversion::FromGL && !GLPlatform::instance()->isGLES()) {
+        // Packs the pixels as native 32-bit ARGB values like QImage::Format_ARGB32 expects.
+        m_format = GL_BGRA;
+        m_type = GL_UNSIGNED_INT_8_8_8_8_REV;
+    } else if (conversion == Conversion::None && GLPlatform::instance()->isGLES()) {
+        // Same as the synchronous readback in effects_handler_wrap::blit_from_framebuffer.
+        m_imageFormat = QImage::Format_RGBA8888;
+    }
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER,
+                 static_cast<GLsizeiptr>(size.width()) * size.height() * 4,
+                 nullptr,
+                 GL_STREAM_READ);
+    glReadPixels(0, 0, size.width(), size.height(), m_format, m_type, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // Otherwise the fence might never be signaled when nothing else gets submitted.
+    glFlush();
+}
+
+ScreenShotReadback::~ScreenShotReadback()
+{
+    if (m_fence) {
+        glDeleteSync(m_fence);
+    }
+    glDeleteBuffers(1, &m_buffer);
+}
+
+bool ScreenShotReadback::supported()
+{
+    if (GLPlatform::instance()->isGLES()) {
+        return hasGLVersion(3, 0);
+    }
+    return hasGLVersion(3, 2) || hasGLExtension(QByteArrayLiteral("GL_ARB_sync"));
+}
+
+bool ScreenShotReadback::isReady()
+{
+    if (!m_fence) {
+        return true;
+    }
+
+    auto const status = glClientWaitSync(m_fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+
+    if (status == GL_WAIT_FAILED) {
+        // The fence would never be signaled. Wait for the copy instead so the request finishes.
+        qCWarning(KWIN_SCREENSHOT) << "Failed to wait on the screenshot fence";
+        glFinish();
+    }
+
+    glDeleteSync(m_fence);
+    m_fence = nullptr;
+    return true;
+}
+
+QImage ScreenShotReadback::take()
+{
+    auto const width = m_size.width();
+    auto const height = m_size.height();
+    auto const stride = static_cast<qsizetype>(width) * 4;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+    auto const data = static_cast<uchar const*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, stride * height, GL_MAP_READ_BIT));
+
+    if (!data) {
+        qCWarning(KWIN_SCREENSHOT) << "Failed to map the screenshot pixel buffer";
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return {};
+    }
+
+    // Flipping and swizzling happen in the single copy out of the mapped buffer.
+    QImage image(m_size, m_imageFormat);
+    auto const from_gl = m_conversion == Conversion::FromGL;
+    auto const swizzle = from_gl && m_format == GL_RGBA;
+
+    for (int y = 0; y < height; y++) {
+        auto const src = data + stride * (from_gl ? height - 1 - y : y);
+        auto const dst = image.scanLine(y);
+
+        if (swizzle) {
+            swizzle_row(
+                reinterpret_cast<uint32_t const*>(src), reinterpret_cast<uint32_t*>(dst), width);
+        } else {
+            std::memcpy(dst, src, stride);
+        }
+    }
+
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return image;
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <epoxy/gl.h>
+
+#include <QImage>
+#include <QSize>
+
+namespace como
+{
+
+/**
+ * Reads back the pixels of the current read framebuffer without stalling the compositor.
+ *
+ * On construction the GPU is instructed to copy the pixels into a pixel pack buffer and a fence is
+ * inserted after the copy. Once the fence is signaled, usually a frame later, the buffer can be
+ * mapped and turned into an image.
+ */
+class ScreenShotReadback
+{
+public:
+    enum class Conversion {
+        /// Copy the rows unchanged.
+        None,
+        /// OpenGL gives bottom-up RGBA rows. Turn them into an upright ARGB32 image.
+        FromGL,
+    };
+
+    ScreenShotReadback(QSize const& size, Conversion conversion);
+    ~ScreenShotReadback();
+
+    ScreenShotReadback(ScreenShotReadback const&) = delete;
+    ScreenShotReadback& operator=(ScreenShotReadback const&) = delete;
+
+    /// Whether pixel pack buffers and fences are available in the current context.
+    static bool supported();
+
+    /// When the fence can not be waited on, the readback falls back to a blocking wait.
+    bool isReady();
+
+    /// Maps the buffer and converts the pixels into a new image. Must only be called once ready.
+    QImage take();
+
+private:
+    QSize m_size;
+    Conversion m_conversion;
+    GLenum m_format{GL_RGBA};
+    GLenum m_type{GL_UNSIGNED_BYTE};
+    QImage::Format m_imageFormat{QImage::Format_ARGB32};
+    GLuint m_buffer{0};
+    GLsync m_fence{nullptr};
+};
+
+}
@@ -0,0 +1,313 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "screenshotstream.h"
+
+#include "screenshot.h"
+
+#include <QPainter>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <new>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace como
+{
+
+namespace
+{
+
+constexpr uint32_t align_up(size_t size)
+{
+    return static_cast<uint32_t>((size + 63) & ~size_t(63));
+}
+
+}
+
+ScreenShotStream::ScreenShotStream(QSize const& maxSize,
+                                   uint rate,
+                                   uint slotCount,
+                                   QObject* parent)
+    : QObject(parent)
+    , m_interval(1000 / std::clamp(rate, 1u, 120u))
+    , m_slotCount(std::clamp(slotCount, 2u, 8u))
+    , m_maxSize(maxSize)
+{
+    auto const pixelOffset = align_up(sizeof(ScreenShotStreamFrame));
+    auto const slotOffset = align_up(sizeof(ScreenShotStreamHeader));
+    m_slotSize
+        = align_up(pixelOffset + static_cast<size_t>(maxSize.width()) * maxSize.height() * 4);
+    m_mapSize = slotOffset + static_cast<size_t>(m_slotCount) * m_slotSize;
+
+    m_fd = file_descriptor(
+        memfd_create("como-screenshot-stream", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (!m_fd.is_valid()) {
+        qCWarning(KWIN_SCREENSHOT)
+            << "Failed to create screenshot stream memfd:" << strerror(errno);
+        return;
+    }
+
+    if (ftruncate(m_fd.fd, m_mapSize) == -1) {
+        qCWarning(KWIN_SCREENSHOT) << "Failed to size screenshot stream memfd:" << strerror(errno);
+        m_fd = {};
+        return;
+    }
+
+    m_map = mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd.fd, 0);
+    if (m_map == MAP_FAILED) {
+        qCWarning(KWIN_SCREENSHOT) << "Failed to map screenshot stream memfd:" << strerror(errno);
+        m_map = nullptr;
+        m_fd = {};
+        return;
+    }
+
+    // Consumers can map the memory without having to fear it shrinks under them.
+    fcntl(m_fd.fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+
+    auto header = new (m_map) ScreenShotStreamHeader;
+    header->magic = ScreenShotStreamHeader::magic_value;
+    header->version = 1;
+    header->slotOffset = slotOffset;
+    header->slotCount = m_slotCount;
+    header->slotSize = m_slotSize;
+    header->pixelOffset = pixelOffset;
+    header->maxWidth = maxSize.width();
+    header->maxHeight = maxSize.height();
+    header->sequence.store(0, std::memory_order_relaxed);
+
+    for (uint32_t i = 0; i < m_slotCount; i++) {
+        auto slot = new (static_cast<char*>(m_map) + slotOffset + i * m_slotSize)
+            ScreenShotStreamFrame{};
+        slot->sequence.store(0, std::memory_order_relaxed);
+    }
+
+    connect(&m_watcher, &QFutureWatcher<QImage>::finished, this, &ScreenShotStream::handleCaptured);
+    connect(&m_timer, &QTimer::timeout, this, &ScreenShotStream::captureDue);
+    m_timer.setSingleShot(true);
+}
+
+ScreenShotStream::~ScreenShotStream()
+{
+    if (m_map) {
+        munmap(m_map, m_mapSize);
+    }
+}
+
+bool ScreenShotStream::isValid() const
+{
+    return m_map;
+}
+
+uint64_t ScreenShotStream::sequence() const
+{
+    return m_sequence;
+}
+
+int ScreenShotStream::fileDescriptor() const
+{
+    return m_fd.fd;
+}
+
+file_descriptor ScreenShotStream::duplicateFileDescriptor() const
+{
+    return m_fd.duplicate();
+}
+
+void ScreenShotStream::stop()
+{
+    if (m_stopped) {
+        return;
+    }
+
+    m_stopped = true;
+    m_timer.stop();
+    Q_EMIT stopped();
+    deleteLater();
+}
+
+bool ScreenShotStream::isDue() const
+{
+    return !m_lastCapture.isValid() || m_lastCapture.hasExpired(m_interval);
+}
+
+void ScreenShotStream::submit(QFuture<QImage> const& capture,
+                              QRect const& target,
+                              QRegion const& damage)
+{
+    if (!isValid() || m_stopped) {
+        return;
+    }
+
+    m_lastCapture.start();
+    m_captures.push_back({capture, target, damage});
+
+    if (m_captures.size() == 1) {
+        m_watcher.setFuture(capture);
+    }
+}
+
+void ScreenShotStream::scheduleCapture()
+{
+    if (m_stopped || m_timer.isActive()) {
+        return;
+    }
+
+    auto const remaining = m_lastCapture.isValid() ? m_interval - m_lastCapture.elapsed() : 0;
+    m_timer.start(std::max<qint64>(remaining, 0));
+}
+
+void ScreenShotStream::handleCaptured()
+{
+    if (m_stopped || m_captures.empty()) {
+        return;
+    }
+
+    auto const capture = std::move(m_captures.front());
+    m_captures.pop_front();
+
+    if (!m_captures.empty()) {
+        m_watcher.setFuture(m_captures.front().future);
+    }
+
+    if (capture.future.isCanceled() || capture.future.resultCount() == 0) {
+        // The window or screen is gone.
+        stop();
+        return;
+    }
+
+    auto image = capture.future.result();
+    if (image.isNull()) {
+        return;
+    }
+
+    if (capture.target.isEmpty()) {
+        if (image.width() > m_maxSize.width() || image.height() > m_maxSize.height()) {
+            qCDebug(KWIN_SCREENSHOT) << "Screenshot stream source grew beyond" << m_maxSize;
+            stop();
+            return;
+        }
+
+        if (image.depth() != 32) {
+            image.convertTo(QImage::Format_ARGB32);
+        }
+
+        auto const damage = image.size() == m_frame.size() ? capture.damage : image.rect();
+        m_frame = image;
+        m_frame.setDevicePixelRatio(1);
+
+        if (!damage.isEmpty()) {
+            write(m_frame, damage);
+        }
+        return;
+    }
+
+    QRegion damage = capture.damage;
+    if (m_frame.isNull()) {
+        // Parts outside of the captured area stay transparent until they are damaged.
+        m_frame = QImage(m_maxSize, QImage::Format_ARGB32);
+        m_frame.fill(Qt::transparent);
+        damage = m_frame.rect();
+    }
+
+    image.setDevicePixelRatio(1);
+
+    QPainter painter(&m_frame);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(capture.target, image);
+    painter.end();
+
+    damage &= m_frame.rect();
+    if (!damage.isEmpty()) {
+        write(m_frame, damage);
+    }
+}
+
+void ScreenShotStream::write(QImage const& image, QRegion const& damage)
+{
+    m_sequence++;
+
+    auto slot = frame(m_sequence);
+    auto const stride = static_cast<size_t>(image.width()) * 4;
+    auto const pixels = reinterpret_cast<uchar*>(slot) + header()->pixelOffset;
+
+    // Only the content changed since this slot was written last needs to be copied.
+    auto copy_region = damage;
+    auto const slot_matches = slot->width == static_cast<uint32_t>(image.width())
+        && slot->height == static_cast<uint32_t>(image.height())
+        && slot->format == static_cast<uint32_t>(image.format());
+
+    if (slot_matches && m_damageHistory.size() + 1 >= m_slotCount) {
+        for (auto const& region : m_damageHistory) {
+            copy_region |= region;
+        }
+    } else {
+        copy_region = image.rect();
+    }
+
+    slot->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (auto const& rect : copy_region) {
+        auto const offset = static_cast<size_t>(rect.x()) * 4;
+        auto const size = static_cast<size_t>(rect.width()) * 4;
+        for (int y = rect.top(); y <= rect.bottom(); y++) {
+            std::memcpy(pixels + y * stride + offset, image.constScanLine(y) + offset, size);
+        }
+    }
+
+    auto const now = std::chrono::steady_clock::now().time_since_epoch();
+    slot->timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    slot->width = image.width();
+    slot->height = image.height();
+    slot->stride = stride;
+    slot->format = image.format();
+
+    if (damage == QRegion(image.rect())) {
+        slot->damageCount = 0;
+    } else {
+        auto const max_rects = ScreenShotStreamFrame::max_damage_rects;
+        auto const rects = damage.rectCount() > static_cast<int>(max_rects)
+            ? QList<QRect>{damage.boundingRect()}
+            : QList<QRect>(damage.begin(), damage.end());
+
+        slot->damageCount = rects.size();
+        for (int i = 0; i < rects.size(); i++) {
+            auto const& rect = rects.at(i);
+            slot->damage[i][0] = rect.x();
+            slot->damage[i][1] = rect.y();
+            slot->damage[i][2] = rect.width();
+            slot->damage[i][3] = rect.height();
+        }
+    }
+
+    slot->sequence.store(m_sequence, std::memory_order_release);
+    header()->sequence.store(m_sequence, std::memory_order_release);
+
+    m_damageHistory.push_back(damage);
+    while (m_damageHistory.size() >= m_slotCount) {
+        m_damageHistory.pop_front();
+    }
+
+    Q_EMIT frameReady(m_sequence);
+}
+
+ScreenShotStreamHeader* ScreenShotStream::header() const
+{
+    return static_cast<ScreenShotStreamHeader*>(m_map);
+}
+
+ScreenShotStreamFrame* ScreenShotStream::frame(uint64_t sequence) const
+{
+    auto const index = sequence % m_slotCount;
+    return reinterpret_cast<ScreenShotStreamFrame*>(static_cast<char*>(m_map)
+                                                    + header()->slotOffset + index * m_slotSize);
+}
+
+}
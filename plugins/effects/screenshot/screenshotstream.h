@@ -0,0 +1,146 @@
+/*
+    SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <como/utils/file_descriptor.h>
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QObject>
+#include <QRegion>
+#include <QTimer>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+
+namespace como
+{
+
+/**
+ * Layout of the shared memory of a screenshot stream. The memory starts with the header, followed
+ * at slotOffset by slotCount slots of slotSize bytes. Each slot starts with a frame header. The
+ * pixels follow at pixelOffset from the start of the slot, stride bytes per row.
+ *
+ * Frame n is written into slot n % slotCount. While a slot is written its sequence is 0.
+ * Afterwards it is set to the sequence of the frame and the sequence of the header is updated.
+ * Readers check that the slot sequence is unchanged after copying the pixels out.
+ */
+struct ScreenShotStreamHeader {
+    static constexpr uint32_t magic_value = 0x4b535331; // "KSS1"
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotOffset;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    uint32_t pixelOffset;
+    uint32_t maxWidth;
+    uint32_t maxHeight;
+
+    // Sequence of the latest complete frame, starting at 1.
+    std::atomic<uint64_t> sequence;
+};
+
+struct ScreenShotStreamFrame {
+    static constexpr uint32_t max_damage_rects = 16;
+
+    std::atomic<uint64_t> sequence;
+
+    // CLOCK_MONOTONIC
+    uint64_t timestampNs;
+
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    // As defined in QImage::Format.
+    uint32_t format;
+
+    // Damage relative to the previous frame as x, y, width, height. The whole frame is damaged
+    // when there are no rects.
+    uint32_t damageCount;
+    uint32_t padding;
+    int32_t damage[max_damage_rects][4];
+};
+
+/**
+ * Writes frames of a captured source into a ring buffer in a sealed memfd. The captures are
+ * driven by the damage of the compositor. Each capture either contains the pixels of a part of the
+ * frame or replaces the frame as a whole. Frames are written in the order their captures were
+ * submitted and at most at the rate of the stream.
+ */
+class ScreenShotStream : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScreenShotStream(QSize const& maxSize, uint rate, uint slotCount, QObject* parent = nullptr);
+    ~ScreenShotStream() override;
+
+    bool isValid() const;
+    uint64_t sequence() const;
+    int fileDescriptor() const;
+
+    /// Duplicate of the memfd for handing it to a consumer.
+    file_descriptor duplicateFileDescriptor() const;
+
+    /// Whether the interval of the stream rate passed since the last capture.
+    bool isDue() const;
+
+    /**
+     * Queues a capture of the pixels in @p target of the frame. An empty @p target replaces the
+     * whole frame by the captured image. The @p damage is in pixels of the frame and reported to
+     * consumers. The frame is written once this and all earlier captures finished.
+     */
+    void submit(QFuture<QImage> const& capture, QRect const& target, QRegion const& damage);
+
+    /// Emits captureDue once the stream is due again.
+    void scheduleCapture();
+
+public Q_SLOTS:
+    void stop();
+
+Q_SIGNALS:
+    void captureDue();
+    void frameReady(quint64 sequence);
+    void stopped();
+
+private:
+    struct Capture {
+        QFuture<QImage> future;
+        QRect target;
+        QRegion damage;
+    };
+
+    void handleCaptured();
+    void write(QImage const& image, QRegion const& damage);
+
+    ScreenShotStreamHeader* header() const;
+    ScreenShotStreamFrame* frame(uint64_t sequence) const;
+
+    std::deque<Capture> m_captures;
+    QFutureWatcher<QImage> m_watcher;
+    QElapsedTimer m_lastCapture;
+    QTimer m_timer;
+    int m_interval;
+
+    file_descriptor m_fd;
+    void* m_map{nullptr};
+    size_t m_mapSize{0};
+    uint32_t m_slotCount{0};
+    uint32_t m_slotSize{0};
+    QSize m_maxSize;
+
+    QImage m_frame;
+    uint64_t m_sequence{0};
+    bool m_stopped{false};
+
+    // Damage of the last frames. The pixels of a slot were last written slotCount frames ago.
+    std::deque<QRegion> m_damageHistory;
+};
+
+}
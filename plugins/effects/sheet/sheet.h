@@ -32,6 +32,12 @@ public:
     void postPaintWindow(EffectWindow* w) override;
 
     bool isActive() const override;
+
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override;
 
     static bool supported();
@@ -40,6 +40,11 @@ public:
     void paintWindow(effect::window_paint_data& data) override;
     void postPaintScreen() override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     static bool supported();
 
 Q_SIGNALS:
@@ -23,6 +23,11 @@ public:
 
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
 private Q_SLOTS:
     void toggle();
 
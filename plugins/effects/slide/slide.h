@@ -70,6 +70,12 @@ public:
     void paintWindow(effect::window_paint_data& data) override;
 
     bool isActive() const override;
+
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override;
 
     static bool supported();
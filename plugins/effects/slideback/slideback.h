@@ -27,6 +27,11 @@ public:
     void postPaintScreen() override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     int requestedEffectChainPosition() const override
     {
         return 50;
@@ -29,6 +29,11 @@ public:
 
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
 private Q_SLOTS:
     void slotWindowAdded(EffectWindow* w);
     void slotWindowClosed(EffectWindow* w);
@@ -53,6 +53,11 @@ public:
     }
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
 private Q_SLOTS:
     void toggleCurrentThumbnail();
     void slotWindowAdded(como::EffectWindow* w);
@@ -33,6 +33,11 @@ public:
     void reconfigure(ReconfigureFlags) override;
     bool isActive() const override;
 
+    bool blocksDirectScanout() const override
+    {
+        return true;
+    }
+
     // for properties
     Qt::KeyboardModifiers modifiers() const
     {
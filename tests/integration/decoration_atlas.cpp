@@ -0,0 +1,181 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "effects/screenshot_stream.h"
+#include "lib/setup.h"
+
+#include <como/render/gl/scene.h>
+
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
+#include <Wrapland/Client/xdgdecoration.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+struct client_window {
+    std::unique_ptr<Wrapland::Client::Surface> surface;
+    std::unique_ptr<Wrapland::Client::XdgShellToplevel> toplevel;
+    std::unique_ptr<Wrapland::Client::XdgDecoration> deco;
+    wayland_window* window{nullptr};
+};
+
+std::unique_ptr<test::setup> create_setup(std::string const& test_name, std::string const& library)
+{
+    qputenv("XDG_DATA_DIRS", QCoreApplication::applicationDirPath().toUtf8());
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("O2"));
+
+    auto setup = std::make_unique<test::setup>(test_name);
+
+    auto config = setup->base->config.main;
+    config->group(QStringLiteral("org.kde.kdecoration2"))
+        .writeEntry("library", QString::fromStdString(library));
+    config->sync();
+
+    setup->start();
+    setup_wayland_connection(global_selection::xdg_decoration);
+
+    REQUIRE(setup->base->mod.render->scene->isOpenGl());
+    return setup;
+}
+
+client_window create_window(QSize const& size)
+{
+    client_window client;
+    client.surface = create_surface();
+    client.toplevel = create_xdg_shell_toplevel(client.surface, CreationSetup::CreateOnly);
+    client.deco.reset(get_client().interfaces.xdg_decoration->getToplevelDecoration(
+        client.toplevel.get(), client.toplevel.get()));
+    client.deco->setMode(Wrapland::Client::XdgDecoration::Mode::ServerSide);
+    init_xdg_shell_toplevel(client.surface, client.toplevel);
+
+    client.window = render_and_wait_for_shown(client.surface, size, Qt::blue);
+    REQUIRE(client.window);
+    REQUIRE(win::decoration(client.window));
+    return client;
+}
+
+}
+
+TEST_CASE("decoration atlas", "[render]")
+{
+    auto const library = GENERATE(as<std::string>{}, "org.kde.breeze", "org.kde.kwin.aurorae");
+    auto setup = create_setup("decoration-atlas", library);
+
+    using render_t = std::remove_reference_t<decltype(*setup->base->mod.render)>;
+    using scene_t = render::gl::scene<render_t>;
+
+    auto& scene = static_cast<scene_t&>(*setup->base->mod.render->scene);
+
+    auto deco_texture = [](auto window) {
+        auto renderer = static_cast<render::gl::deco_renderer<scene_t>*>(
+            window->control->deco.client->renderer()->injector.get());
+        return renderer->texture();
+    };
+
+    SECTION("shared texture")
+    {
+        std::vector<client_window> windows;
+        for (int i = 0; i < 20; i++) {
+            windows.push_back(create_window(QSize(200 + i * 20, 100)));
+            win::move(windows.back().window, QPoint(i * 20, i * 20));
+        }
+
+        // Decorations are rendered on the next frame.
+        QSignalSpy frame_spy(windows.back().surface.get(),
+                             &Wrapland::Client::Surface::frameRendered);
+        QVERIFY(frame_spy.isValid());
+        render(windows.back().surface, QSize(580, 100), Qt::red);
+        QVERIFY(frame_spy.wait());
+
+        REQUIRE(scene.decoration_atlas.texture());
+        for (auto const& client : windows) {
+            REQUIRE(deco_texture(client.window) == scene.decoration_atlas.texture());
+        }
+    }
+
+    SECTION("pixels after resize")
+    {
+        REQUIRE(setup->base->mod.render->effects->loadEffect(QStringLiteral("screenshot")));
+
+        auto resized = create_window(QSize(300, 200));
+        win::move(resized.window, QPoint(0, 0));
+
+        // Created last, so it stays active while the other window is resized.
+        auto still = create_window(QSize(300, 200));
+        win::move(still.window, QPoint(600, 400));
+
+        auto const screen = setup->base->mod.render->effects->screens().constFirst();
+        screen_stream stream(screen->name(), 60);
+        stream_map map(stream.fd.fileDescriptor());
+
+        auto latest_image = [&](QRect const& rect) {
+            auto const sequence = map.header()->sequence.load(std::memory_order_acquire);
+            if (sequence == 0) {
+                return QImage();
+            }
+            return map.image(sequence).copy(rect);
+        };
+
+        auto const resized_geo = resized.window->geo.frame;
+        auto const still_geo = still.window->geo.frame;
+
+        QImage resized_image;
+        QTRY_VERIFY(!(resized_image = latest_image(resized_geo)).isNull());
+        auto const still_image = latest_image(still_geo);
+
+        // The decoration gets a new rect in the atlas when it grows beyond the old one and again
+        // when it shrinks to less than half of it.
+        QSignalSpy frame_spy(resized.surface.get(), &Wrapland::Client::Surface::frameRendered);
+        QVERIFY(frame_spy.isValid());
+
+        render(resized.surface, QSize(700, 200), Qt::blue);
+        QVERIFY(frame_spy.wait());
+        REQUIRE(resized.window->geo.frame.width() > resized_geo.width());
+
+        render(resized.surface, QSize(300, 200), Qt::blue);
+        QVERIFY(frame_spy.wait());
+        REQUIRE(resized.window->geo.frame == resized_geo);
+
+        // Both decorations look the same as before.
+        QTRY_VERIFY(latest_image(resized_geo) == resized_image);
+        QVERIFY(latest_image(still_geo) == still_image);
+
+        REQUIRE(stream.stop());
+    }
+}
+
+TEST_CASE("decoration atlas benchmark", "[render],[.benchmark]")
+{
+    auto const library = GENERATE(as<std::string>{}, "org.kde.breeze", "org.kde.kwin.aurorae");
+    auto setup = create_setup("decoration-atlas-benchmark", library);
+
+    std::vector<client_window> windows;
+    for (int i = 0; i < 30; i++) {
+        windows.push_back(create_window(QSize(300, 200)));
+        win::move(windows.back().window, QPoint((i * 37) % 900, (i * 23) % 500));
+    }
+
+    auto& resized = windows.back();
+    QSignalSpy frame_spy(resized.surface.get(), &Wrapland::Client::Surface::frameRendered);
+    REQUIRE(frame_spy.isValid());
+
+    // Like an interactive resize the window grows and shrinks step by step, and its decoration is
+    // updated every frame.
+    int step{0};
+    BENCHMARK("resize drag with " + library)
+    {
+        auto const width = 300 + std::abs(step++ % 80 - 40) * 10;
+        render(resized.surface, QSize(width, 200), Qt::red);
+        return frame_spy.wait();
+    };
+}
+
+}
@@ -0,0 +1,132 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <como/render/wayland/scanout.h>
+
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
+#include <Wrapland/Server/output.h>
+
+namespace como::detail::test
+{
+
+TEST_CASE("direct scanout", "[render]")
+{
+    test::setup setup("direct-scanout", base::operation_mode::wayland);
+    setup.start();
+    setup_wayland_connection();
+
+    auto& output = *setup.base->outputs.at(0)->render;
+
+    auto get_candidate = [&] {
+        return render::wayland::get_scanout_candidate(
+            output, win::render_stack(setup.base->mod.space->stacking.order));
+    };
+
+    auto surface = create_surface();
+    auto toplevel = create_xdg_shell_toplevel(surface, CreationSetup::CreateOnly);
+    QSignalSpy configure_spy(toplevel.get(), &Wrapland::Client::XdgShellToplevel::configured);
+    REQUIRE(configure_spy.isValid());
+
+    toplevel->setFullscreen(true);
+    surface->commit(Wrapland::Client::Surface::CommitFlag::None);
+    REQUIRE(configure_spy.wait());
+
+    auto const size = toplevel->get_configure_data().size;
+    REQUIRE(size == get_output(0)->geometry().size());
+    toplevel->ackConfigure(configure_spy.back().front().toUInt());
+
+    SECTION("shm window is composited")
+    {
+        auto window = render_and_wait_for_shown(surface, size, Qt::blue, QImage::Format_RGB32);
+        REQUIRE(window);
+        REQUIRE(window->control->fullscreen);
+        REQUIRE(!win::has_alpha(*window));
+
+        // The window covers the output but its buffer is in shared memory.
+        REQUIRE(!render::wayland::is_scanout_capable(output, window));
+        REQUIRE(!get_candidate());
+
+        auto const scanout_frames = output.timings.scanout_frames.load();
+        auto const paints = output.timings.paint.total();
+
+        QSignalSpy frame_spy(surface.get(), &Wrapland::Client::Surface::frameRendered);
+        REQUIRE(frame_spy.isValid());
+
+        render(surface, size, Qt::red, QImage::Format_RGB32);
+        REQUIRE(frame_spy.wait());
+
+        REQUIRE(output.timings.scanout_frames.load() == scanout_frames);
+        REQUIRE(output.timings.paint.total() > paints);
+    }
+
+    SECTION("window with alpha is composited")
+    {
+        auto window = render_and_wait_for_shown(surface, size, QColor(0, 0, 255, 128));
+        REQUIRE(window);
+        REQUIRE(win::has_alpha(*window));
+        REQUIRE(!render::wayland::is_scanout_capable(output, window));
+        REQUIRE(!get_candidate());
+    }
+
+    SECTION("rotated output")
+    {
+        auto& base_output = *setup.base->outputs.at(0);
+        auto const geometry = base_output.geometry();
+        auto const mode_size = base_output.mode_size();
+        REQUIRE(render::wayland::is_scanout_output(output));
+
+        auto set_transform = [&](Wrapland::Server::output_transform transform) {
+            auto state = base_output.wrapland_output()->get_state();
+            state.transform = transform;
+            REQUIRE(base_output.apply_state(state));
+        };
+
+        // Geometry and mode size still match a buffer, but it would be shown upside down or
+        // mirrored.
+        for (auto transform : {Wrapland::Server::output_transform::rotated_180,
+                               Wrapland::Server::output_transform::flipped,
+                               Wrapland::Server::output_transform::flipped_180}) {
+            set_transform(transform);
+            REQUIRE(base_output.geometry() == geometry);
+            REQUIRE(base_output.mode_size() == mode_size);
+            REQUIRE(!render::wayland::is_scanout_output(output));
+            REQUIRE(!get_candidate());
+        }
+
+        set_transform(Wrapland::Server::output_transform::normal);
+        REQUIRE(render::wayland::is_scanout_output(output));
+    }
+
+    SECTION("effects")
+    {
+        auto& effects = *setup.base->mod.render->effects;
+
+        // Effects only block scanout when they opt in.
+        Effect plain;
+        REQUIRE(plain.isActive());
+        REQUIRE(!plain.blocksDirectScanout());
+
+        REQUIRE(effects.loadEffect(QStringLiteral("showpaint")));
+        auto effect = effects.findEffect(QStringLiteral("showpaint"));
+        REQUIRE(effect);
+        REQUIRE(effect->blocksDirectScanout());
+        REQUIRE(!effect->isActive());
+        REQUIRE(!effects.blocks_direct_scanout());
+
+        // Painting over windows blocks scanout only while the effect is active.
+        REQUIRE(QMetaObject::invokeMethod(effect, "toggle"));
+        REQUIRE(effect->isActive());
+        REQUIRE(effects.blocks_direct_scanout());
+
+        REQUIRE(QMetaObject::invokeMethod(effect, "toggle"));
+        REQUIRE(!effect->isActive());
+        REQUIRE(!effects.blocks_direct_scanout());
+    }
+}
+
+}
@@ -0,0 +1,198 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "generic_scene_opengl.h"
+#include "lib/setup.h"
+#include "screenshot_stream.h"
+
+#include <QPainter>
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+struct client_window {
+    std::unique_ptr<Wrapland::Client::Surface> surface;
+    std::unique_ptr<Wrapland::Client::XdgShellToplevel> toplevel;
+    std::unique_ptr<Wrapland::Client::Blur> blur;
+    wayland_window* window{nullptr};
+};
+
+std::unique_ptr<setup> create_setup(std::string const& test_name)
+{
+    qRegisterMetaType<como::Effect*>();
+
+    auto setup = generic_scene_opengl_get_setup(test_name, "O2");
+
+    auto& effects = setup->base->mod.render->effects;
+    QSignalSpy effect_loaded_spy(effects->loader.get(), &render::basic_effect_loader::effectLoaded);
+    REQUIRE(effect_loaded_spy.isValid());
+
+    REQUIRE(effects->loadEffect(QStringLiteral("blur")));
+    REQUIRE(effects->loadEffect(QStringLiteral("screenshot")));
+    REQUIRE(effect_loaded_spy.count() == 2);
+
+    // The blur protocol is announced once the effect is loaded.
+    setup_wayland_connection(global_selection::blur);
+    return setup;
+}
+
+client_window create_window(QRect const& geo, QColor const& color, bool blurred)
+{
+    client_window client;
+    client.surface = create_surface();
+    client.toplevel = create_xdg_shell_toplevel(client.surface);
+
+    if (blurred) {
+        auto region = get_client().interfaces.compositor->createRegion(
+            QRegion(QRect(QPoint(), geo.size())));
+        client.blur.reset(get_client().interfaces.blur_manager->createBlur(client.surface.get()));
+        client.blur->setRegion(region.get());
+        client.blur->commit();
+    }
+
+    client.window = render_and_wait_for_shown(client.surface, geo.size(), color);
+    REQUIRE(client.window);
+    win::move(client.window, geo.topLeft());
+    return client;
+}
+
+QColor latest_pixel(stream_map& map, QPoint const& pos)
+{
+    auto const sequence = map.header()->sequence.load(std::memory_order_acquire);
+    if (sequence == 0) {
+        return QColor();
+    }
+    return QColor(map.image(sequence).pixel(pos));
+}
+
+bool is_close(QColor const& color, QColor const& expected)
+{
+    // The blur effect adds some noise.
+    return std::abs(color.red() - expected.red()) < 32
+        && std::abs(color.green() - expected.green()) < 32
+        && std::abs(color.blue() - expected.blue()) < 32;
+}
+
+}
+
+TEST_CASE("blur", "[effect]")
+{
+    auto setup = create_setup("blur");
+
+    auto& effects = setup->base->mod.render->effects;
+    auto const screen = effects->screens().constFirst();
+    REQUIRE(screen);
+    auto const screen_geo = screen->geometry();
+
+    // The wallpaper is at the bottom and covers the whole screen.
+    auto wallpaper = create_window(screen_geo, Qt::red, false);
+
+    screen_stream stream(screen->name(), 60);
+    stream_map map(stream.fd.fileDescriptor());
+
+    QRect const blurred_geo(100, 100, 200, 200);
+    auto blurred = create_window(blurred_geo, Qt::transparent, true);
+    auto const center = blurred_geo.center();
+
+    QTRY_VERIFY(is_close(latest_pixel(map, center), Qt::red));
+
+    SECTION("background change")
+    {
+        // The window itself changes. Its blurred background stays the same.
+        render(blurred.surface, blurred_geo.size(), Qt::transparent);
+        flush_wayland_connection();
+        QTRY_VERIFY(is_close(latest_pixel(map, center), Qt::red));
+
+        // The wallpaper changes behind the window. The blurred background follows.
+        render(wallpaper.surface, screen_geo.size(), Qt::blue);
+        flush_wayland_connection();
+        QTRY_VERIFY(is_close(latest_pixel(map, center), Qt::blue));
+
+        // After the window moved its background is blurred again.
+        QImage image(screen_geo.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::blue);
+        QPainter(&image).fillRect(QRect(600, 100, 200, 200), Qt::green);
+        render(wallpaper.surface, image);
+        flush_wayland_connection();
+        QTRY_VERIFY(is_close(latest_pixel(map, center), Qt::blue));
+
+        win::move(blurred.window, QPoint(600, 100));
+        QTRY_VERIFY(is_close(latest_pixel(map, QPoint(700, 200)), Qt::green));
+    }
+
+    SECTION("cache hit")
+    {
+        auto blur = effects->findEffect(QStringLiteral("blur"));
+        REQUIRE(blur);
+        auto cache_hits = [&] { return blur->property("cacheHits").toULongLong(); };
+
+        QRect const other_geo(600, 100, 200, 200);
+        auto other = create_window(other_geo, Qt::green, false);
+        QTRY_VERIFY(is_close(latest_pixel(map, other_geo.center()), Qt::green));
+
+        auto const hits = cache_hits();
+
+        // An unrelated window and the blurred window itself change. Nothing behind the blurred
+        // window is painted again, so its background is drawn from the cache.
+        render(other.surface, other_geo.size(), Qt::yellow);
+        render(blurred.surface, blurred_geo.size(), Qt::transparent);
+        flush_wayland_connection();
+
+        QTRY_VERIFY(is_close(latest_pixel(map, other_geo.center()), Qt::yellow));
+        QTRY_VERIFY(cache_hits() > hits);
+        QVERIFY(is_close(latest_pixel(map, center), Qt::red));
+    }
+
+    REQUIRE(stream.stop());
+}
+
+TEST_CASE("blur benchmark", "[effect],[.benchmark]")
+{
+    auto setup = create_setup("blur-benchmark");
+
+    auto const screen_geo = setup->base->mod.render->effects->screens().constFirst()->geometry();
+    auto wallpaper = create_window(screen_geo, Qt::red, false);
+
+    auto const window_count = GENERATE(1, 5, 10);
+
+    std::vector<client_window> windows;
+    for (int i = 0; i < window_count; i++) {
+        QRect const geo(20 + (i % 4) * 220, 20 + (i / 4) * 170, 200, 150);
+        windows.push_back(create_window(geo, QColor(255, 255, 255, 64), true));
+    }
+
+    // Only a corner of the wallpaper away from the blurred windows is animated.
+    QRect const animated_rect(screen_geo.width() - 100, screen_geo.height() - 100, 100, 100);
+
+    std::array<QImage, 2> frames;
+    for (size_t i = 0; i < frames.size(); i++) {
+        frames.at(i) = QImage(screen_geo.size(), QImage::Format_ARGB32_Premultiplied);
+        frames.at(i).fill(Qt::red);
+        QPainter(&frames.at(i)).fillRect(animated_rect, i ? Qt::green : Qt::blue);
+    }
+
+    QSignalSpy frame_spy(wallpaper.surface.get(), &Wrapland::Client::Surface::frameRendered);
+    REQUIRE(frame_spy.isValid());
+
+    size_t frame{0};
+    BENCHMARK("animated wallpaper with " + std::to_string(window_count) + " blurred windows")
+    {
+        auto shm = get_client().interfaces.shm.get();
+        wallpaper.surface->attachBuffer(shm->createBuffer(frames.at(frame++ % 2)));
+        wallpaper.surface->damage(animated_rect);
+        wallpaper.surface->commit(Wrapland::Client::Surface::CommitFlag::FrameCallback);
+        flush_wayland_connection();
+        return frame_spy.wait();
+    };
+}
+
+}
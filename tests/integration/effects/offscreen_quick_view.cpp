@@ -0,0 +1,191 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "generic_scene_opengl.h"
+#include "lib/setup.h"
+
+#include <como/render/effect/interface/offscreen_quick_view.h>
+
+#include <QQmlComponent>
+#include <QQuickItem>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+// A grid of tiles similar to the window grid of the overview effect. Hovered tiles and the one
+// selected through the highlight property are drawn in a different color.
+auto const grid_qml = QByteArrayLiteral(R"(
+import QtQuick
+
+Item {
+    id: root
+    property int highlight: -1
+
+    Grid {
+        columns: 4
+
+        Repeater {
+            model: 16
+
+            Rectangle {
+                objectName: "tile" + index
+                width: 320
+                height: 256
+                color: hover.hovered || index === root.highlight ? "red" : "blue"
+                border.width: 2
+                radius: 8
+
+                HoverHandler {
+                    id: hover
+                }
+            }
+        }
+    }
+}
+)");
+
+QRect tile_rect(int index)
+{
+    return QRect((index % 4) * 320, (index / 4) * 256, 320, 256);
+}
+
+std::unique_ptr<QQuickItem> create_grid(test::setup& setup, OffscreenQuickView& view)
+{
+    QQmlComponent component(setup.base->mod.render->effects->qmlEngine());
+    component.setData(grid_qml, QUrl());
+    std::unique_ptr<QQuickItem> root(qobject_cast<QQuickItem*>(component.create()));
+    REQUIRE(root);
+    root->setParentItem(view.contentItem());
+    root->setSize(view.contentItem()->size());
+    return root;
+}
+
+void hover(OffscreenQuickView& view, int index)
+{
+    auto const pos = tile_rect(index).center();
+    QMouseEvent event(QEvent::MouseMove, pos, pos, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+    view.forwardMouseEvent(&event);
+    view.update();
+}
+
+}
+
+TEST_CASE("offscreen quick view", "[effect]")
+{
+    auto setup = generic_scene_opengl_get_setup("offscreen-quick-view", "O2");
+
+    auto const export_mode = GENERATE(OffscreenQuickView::ExportMode::Texture,
+                                      OffscreenQuickView::ExportMode::Image);
+
+    OffscreenQuickView view(export_mode);
+    view.setAutomaticRepaint(false);
+    QRect const view_rect(0, 0, 1280, 1024);
+    view.setGeometry(view_rect);
+
+    auto root = create_grid(*setup, view);
+
+    QSignalSpy repaint_spy(&view, &OffscreenQuickView::repaintNeeded);
+    QVERIFY(repaint_spy.isValid());
+
+    // The first update renders the whole view.
+    view.update();
+    QCOMPARE(repaint_spy.count(), 1);
+    REQUIRE(view.damage() == QRegion(view_rect));
+
+    SECTION("unchanged scene")
+    {
+        view.update();
+        QCOMPARE(repaint_spy.count(), 1);
+    }
+
+    SECTION("changed item")
+    {
+        root->setProperty("highlight", 5);
+        view.update();
+        QCOMPARE(repaint_spy.count(), 2);
+
+        auto const damage = view.damage();
+        REQUIRE(!damage.isEmpty());
+        REQUIRE(tile_rect(5).adjusted(-1, -1, 1, 1).contains(damage.boundingRect()));
+
+        if (export_mode == OffscreenQuickView::ExportMode::Image) {
+            // Only the changed part was read back. The remaining image is still complete.
+            auto const image = view.bufferAsImage();
+            REQUIRE(image.size() == QSize(1280, 1024));
+            REQUIRE(QColor(image.pixel(tile_rect(5).center())) == Qt::red);
+            REQUIRE(QColor(image.pixel(tile_rect(6).center())) == Qt::blue);
+        }
+    }
+
+    SECTION("moved item")
+    {
+        auto tile = root->findChild<QQuickItem*>(QStringLiteral("tile0"));
+        REQUIRE(tile);
+
+        // Leave the grid positioner to move the tile freely.
+        tile->setParentItem(root.get());
+        view.update();
+
+        tile->setPosition(QPointF(700, 600));
+        view.update();
+
+        auto const damage = view.damage();
+        REQUIRE(damage.intersects(tile_rect(0)));
+        REQUIRE(damage.intersects(QRect(700, 600, 320, 256)));
+        REQUIRE(!damage.intersects(tile_rect(3)));
+    }
+
+    SECTION("removed item")
+    {
+        auto tile = root->findChild<QQuickItem*>(QStringLiteral("tile0"));
+        REQUIRE(tile);
+
+        tile->setParentItem(root.get());
+        view.update();
+
+        tile->setParentItem(nullptr);
+        view.update();
+
+        REQUIRE(tile_rect(0).adjusted(-1, -1, 1, 1).contains(view.damage().boundingRect()));
+    }
+
+    SECTION("hover")
+    {
+        // Moving the pointer over the grid only damages the tiles that changed their hover state.
+        hover(view, 0);
+        hover(view, 1);
+        REQUIRE(view.damage().boundingRect()
+                == ((tile_rect(0) | tile_rect(1)).adjusted(-1, -1, 1, 1) & view_rect));
+    }
+}
+
+TEST_CASE("offscreen quick view benchmark", "[effect],[.benchmark]")
+{
+    auto setup = generic_scene_opengl_get_setup("offscreen-quick-view-benchmark", "O2");
+
+    auto const export_mode = GENERATE(OffscreenQuickView::ExportMode::Texture,
+                                      OffscreenQuickView::ExportMode::Image);
+
+    OffscreenQuickView view(export_mode);
+    view.setAutomaticRepaint(false);
+    view.setGeometry(QRect(0, 0, 1280, 1024));
+
+    auto root = create_grid(*setup, view);
+    view.update();
+
+    int index{0};
+    BENCHMARK("hover over overview grid")
+    {
+        hover(view, index++ % 16);
+        return view.damage().rectCount();
+    };
+}
+
+}
@@ -0,0 +1,202 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "generic_scene_opengl.h"
+#include "lib/setup.h"
+#include "screenshot_stream.h"
+
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
+
+#include <QElapsedTimer>
+
+namespace como::detail::test
+{
+
+TEST_CASE("screenshot stream", "[effect]")
+{
+    qRegisterMetaType<como::Effect*>();
+
+    auto setup = generic_scene_opengl_get_setup("screenshot-stream", "O2");
+    setup_wayland_connection();
+
+    auto& effects = setup->base->mod.render->effects;
+    QSignalSpy effect_loaded_spy(effects->loader.get(), &render::basic_effect_loader::effectLoaded);
+    QVERIFY(effect_loaded_spy.isValid());
+
+    REQUIRE(effects->loadEffect(QStringLiteral("screenshot")));
+    REQUIRE(effect_loaded_spy.count() == 1);
+
+    auto const screen = effects->screens().constFirst();
+    REQUIRE(screen);
+
+    screen_stream stream(screen->name(), 60);
+    stream_map map(stream.fd.fileDescriptor());
+    REQUIRE(map.header()->magic == 0x4b535331);
+    REQUIRE(map.header()->version == 1);
+    REQUIRE(map.header()->slot_count == 3);
+
+    auto latest_sequence
+        = [&] { return map.header()->sequence.load(std::memory_order_acquire); };
+
+    // The first frame contains the whole screen.
+    QTRY_VERIFY(latest_sequence() >= 1);
+
+    auto first_frame = map.frame(1);
+    REQUIRE(first_frame->sequence.load(std::memory_order_acquire) == 1);
+    REQUIRE(first_frame->width == static_cast<uint32_t>(screen->geometry().width()));
+    REQUIRE(first_frame->height == static_cast<uint32_t>(screen->geometry().height()));
+    REQUIRE(first_frame->damage_count == 0);
+    REQUIRE(first_frame->timestamp_ns > 0);
+
+    SECTION("damage only")
+    {
+        // A window appears in a part of the screen. Only that part is reported as damaged.
+        auto surface = create_surface();
+        auto toplevel = create_xdg_shell_toplevel(surface);
+        auto window = render_and_wait_for_shown(surface, QSize(100, 50), Qt::red);
+        REQUIRE(window);
+        win::move(window, QPoint(10, 10));
+
+        auto latest_pixel
+            = [&](QPoint const& pos) { return QColor(map.image(latest_sequence()).pixel(pos)); };
+        QTRY_VERIFY(latest_pixel(QPoint(50, 30)) == Qt::red);
+
+        auto const sequence = latest_sequence();
+        REQUIRE(sequence > 1);
+
+        auto frame = map.frame(sequence);
+        REQUIRE(frame->sequence.load(std::memory_order_acquire) == sequence);
+        REQUIRE(frame->damage_count > 0);
+        REQUIRE(frame->timestamp_ns >= first_frame->timestamp_ns);
+
+        QRegion damage;
+        for (uint32_t i = 0; i < frame->damage_count; i++) {
+            damage |= QRect(
+                frame->damage[i][0], frame->damage[i][1], frame->damage[i][2], frame->damage[i][3]);
+        }
+        REQUIRE(damage.intersects(QRect(10, 10, 100, 50)));
+        REQUIRE(damage.boundingRect() != screen->geometry());
+
+        // The frame is complete, not only its damaged parts.
+        auto const image = map.image(sequence);
+        REQUIRE(image.size() == screen->geometry().size());
+        REQUIRE(QColor(image.pixel(50, 30)) == Qt::red);
+
+        // Only the repainted window is read back, the rest of the frame is kept.
+        auto const background = image.pixel(500, 500);
+        render(surface, QSize(100, 50), Qt::blue);
+        flush_wayland_connection();
+        QTRY_VERIFY(latest_pixel(QPoint(50, 30)) == Qt::blue);
+        REQUIRE(latest_sequence() > sequence);
+        REQUIRE(map.image(latest_sequence()).pixel(500, 500) == background);
+    }
+
+    SECTION("area")
+    {
+        auto surface = create_surface();
+        auto toplevel = create_xdg_shell_toplevel(surface);
+        auto window = render_and_wait_for_shown(surface, QSize(100, 50), Qt::red);
+        REQUIRE(window);
+        win::move(window, QPoint(10, 10));
+
+        screenshot_stream area(QStringLiteral("StreamArea"), {50, 20, 200u, 100u, QVariantMap()});
+        stream_map area_map(area.fd.fileDescriptor());
+        auto area_sequence
+            = [&] { return area_map.header()->sequence.load(std::memory_order_acquire); };
+        QTRY_VERIFY(area_sequence() >= 1);
+
+        // Frames have the size of the area and its upper left corner at the origin.
+        auto const image = area_map.image(area_sequence());
+        REQUIRE(image.size() == QSize(200, 100));
+        REQUIRE(QColor(image.pixel(0, 0)) == Qt::red);
+        REQUIRE(QColor(image.pixel(59, 39)) == Qt::red);
+        REQUIRE(QColor(image.pixel(60, 40)) != Qt::red);
+
+        REQUIRE(area.stop());
+    }
+
+    SECTION("window")
+    {
+        auto surface = create_surface();
+        auto toplevel = create_xdg_shell_toplevel(surface);
+        auto window = render_and_wait_for_shown(surface, QSize(100, 50), Qt::red);
+        REQUIRE(window);
+
+        screenshot_stream window_stream(
+            QStringLiteral("StreamWindow"),
+            {window->meta.internal_id.toString(), QVariantMap()});
+        stream_map window_map(window_stream.fd.fileDescriptor());
+        auto window_sequence
+            = [&] { return window_map.header()->sequence.load(std::memory_order_acquire); };
+        QTRY_VERIFY(window_sequence() >= 1);
+
+        auto const image = window_map.image(window_sequence());
+        REQUIRE(image.size() == QSize(100, 50));
+        REQUIRE(QColor(image.pixel(50, 25)) == Qt::red);
+
+        // The stream follows the window when it moves.
+        win::move(window, QPoint(200, 200));
+        render(surface, QSize(100, 50), Qt::blue);
+        flush_wayland_connection();
+        QTRY_VERIFY(QColor(window_map.image(window_sequence()).pixel(50, 25)) == Qt::blue);
+
+        // The stream stops with the window.
+        toplevel.reset();
+        surface.reset();
+        QTRY_VERIFY(!window_stream.stop());
+    }
+
+    SECTION("throttling")
+    {
+        auto surface = create_surface();
+        auto toplevel = create_xdg_shell_toplevel(surface);
+        auto window = render_and_wait_for_shown(surface, QSize(100, 50), Qt::red);
+        REQUIRE(window);
+        win::move(window, QPoint(10, 10));
+
+        screenshot_stream area(QStringLiteral("StreamArea"),
+                               {0, 0, 200u, 100u, QVariantMap{{QStringLiteral("rate"), 5u}}});
+        stream_map area_map(area.fd.fileDescriptor());
+        auto area_sequence
+            = [&] { return area_map.header()->sequence.load(std::memory_order_acquire); };
+        QTRY_VERIFY(area_sequence() >= 1);
+
+        // The window is repainted about 50 times in a second.
+        auto const start_sequence = area_sequence();
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; timer.elapsed() < 1000; i++) {
+            render(surface, QSize(100, 50), i % 2 ? Qt::green : Qt::blue);
+            flush_wayland_connection();
+            QTest::qWait(20);
+        }
+
+        // At 5 frames per second six frames fit into the second, one more may still be pending.
+        auto const frames = area_sequence() - start_sequence;
+        REQUIRE(frames >= 3);
+        REQUIRE(frames <= 7);
+
+        // The last repaint is captured once the stream is due again.
+        render(surface, QSize(100, 50), Qt::yellow);
+        flush_wayland_connection();
+        QTRY_VERIFY(QColor(area_map.image(area_sequence()).pixel(50, 30)) == Qt::yellow);
+
+        REQUIRE(area.stop());
+    }
+
+    SECTION("stop")
+    {
+        REQUIRE(stream.stop());
+
+        // The stream is gone.
+        REQUIRE(!stream.stop());
+
+        // The consumer keeps its mapping and can still read the last frame.
+        REQUIRE(latest_sequence() >= 1);
+    }
+}
+
+}
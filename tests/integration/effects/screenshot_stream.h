@@ -0,0 +1,133 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "lib/setup.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusReply>
+#include <QDBusUnixFileDescriptor>
+#include <QImage>
+#include <atomic>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace como::detail::test
+{
+
+// The shared memory layout as seen by a consumer of the stream.
+struct stream_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_offset;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    uint32_t pixel_offset;
+    uint32_t max_width;
+    uint32_t max_height;
+    std::atomic<uint64_t> sequence;
+};
+
+struct stream_frame {
+    std::atomic<uint64_t> sequence;
+    uint64_t timestamp_ns;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t format;
+    uint32_t damage_count;
+    uint32_t padding;
+    int32_t damage[16][4];
+};
+
+inline QDBusMessage screenshot_stream_call(QString const& method, QVariantList const& arguments)
+{
+    auto msg = QDBusMessage::createMethodCall(QStringLiteral("org.kde.KWin.ScreenShot2"),
+                                              QStringLiteral("/org/kde/KWin/ScreenShot2"),
+                                              QStringLiteral("org.kde.KWin.ScreenShot2"),
+                                              method);
+    msg.setArguments(arguments);
+    return QDBusConnection::sessionBus().call(msg);
+}
+
+// A stream started through the D-Bus interface of the screenshot effect.
+struct screenshot_stream {
+    screenshot_stream(QString const& method, QVariantList const& arguments)
+    {
+        // The test binary has no desktop file listing the restricted interface.
+        qputenv("KWIN_SCREENSHOT_NO_PERMISSION_CHECKS", "1");
+
+        QDBusReply<QVariantMap> reply = screenshot_stream_call(method, arguments);
+        REQUIRE(reply.isValid());
+
+        id = reply.value().value(QStringLiteral("stream")).toUInt();
+        fd = qdbus_cast<QDBusUnixFileDescriptor>(reply.value().value(QStringLiteral("fd")));
+        REQUIRE(fd.isValid());
+    }
+
+    bool stop() const
+    {
+        return screenshot_stream_call(QStringLiteral("StopStream"), {id}).type()
+            == QDBusMessage::ReplyMessage;
+    }
+
+    uint id{0};
+    QDBusUnixFileDescriptor fd;
+};
+
+struct screen_stream : screenshot_stream {
+    screen_stream(QString const& screen_name, uint rate)
+        : screenshot_stream(QStringLiteral("StreamScreen"),
+                            {screen_name, QVariantMap{{QStringLiteral("rate"), rate}}})
+    {
+    }
+};
+
+struct stream_map {
+    explicit stream_map(int fd)
+    {
+        struct stat info;
+        REQUIRE(fstat(fd, &info) == 0);
+        size = info.st_size;
+        data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        REQUIRE(data != MAP_FAILED);
+    }
+
+    ~stream_map()
+    {
+        munmap(data, size);
+    }
+
+    stream_header const* header() const
+    {
+        return static_cast<stream_header const*>(data);
+    }
+
+    stream_frame const* frame(uint64_t sequence) const
+    {
+        auto const index = sequence % header()->slot_count;
+        return reinterpret_cast<stream_frame const*>(
+            static_cast<char const*>(data) + header()->slot_offset + index * header()->slot_size);
+    }
+
+    QImage image(uint64_t sequence) const
+    {
+        auto const frame = this->frame(sequence);
+        auto const pixels = reinterpret_cast<uchar const*>(frame) + header()->pixel_offset;
+        return QImage(pixels,
+                      frame->width,
+                      frame->height,
+                      frame->stride,
+                      static_cast<QImage::Format>(frame->format))
+            .copy();
+    }
+
+    void* data;
+    size_t size;
+};
+
+}
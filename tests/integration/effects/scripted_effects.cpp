@@ -6,6 +6,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "lib/setup.h"
 
+#include "como/base/config-como.h"
 #include "como/render/effect/interface/anidata_p.h"
 
 #include <KConfigGroup>
@@ -185,6 +186,13 @@ TEST_CASE("scripted effects", "[effect]")
         QCOMPARE(effectOutputSpy[1].first(), "100");
         QCOMPARE(effectOutputSpy[2].first(), "2");
         QCOMPARE(effectOutputSpy[3].first(), "0");
+
+        REQUIRE(effect->loadTime() >= 0);
+#if HAVE_SCRIPT_HEAP_SIZE
+        REQUIRE(effect->heapSize() > 0);
+#else
+        REQUIRE(effect->heapSize() == -1);
+#endif
     }
 
     SECTION("shortcuts")
@@ -102,6 +102,13 @@ client::client(global_selection globals)
         QVERIFY(interfaces.shadow_manager->isValid());
     }
 
+    if (flags(globals & global_selection::blur)) {
+        interfaces.blur_manager.reset(
+            registry->createBlurManager(registry->interface(Clt::Registry::Interface::Blur).name,
+                                        registry->interface(Clt::Registry::Interface::Blur).version));
+        QVERIFY(interfaces.blur_manager->isValid());
+    }
+
     if (flags(globals & global_selection::plasma_shell)) {
         interfaces.plasma_shell.reset(registry->createPlasmaShell(
             registry->interface(Clt::Registry::Interface::PlasmaShell).name,
@@ -10,6 +10,7 @@
 #include <como_export.h>
 
 #include <Wrapland/Client/appmenu.h>
+#include <Wrapland/Client/blur.h>
 #include <Wrapland/Client/compositor.h>
 #include <Wrapland/Client/event_queue.h>
 #include <Wrapland/Client/idle_notify_v1.h>
@@ -52,6 +53,7 @@ public:
         std::unique_ptr<Wrapland::Client::LayerShellV1> layer_shell;
         std::unique_ptr<Wrapland::Client::SubCompositor> subcompositor;
         std::unique_ptr<Wrapland::Client::ShadowManager> shadow_manager;
+        std::unique_ptr<Wrapland::Client::BlurManager> blur_manager;
         std::unique_ptr<Wrapland::Client::XdgShell> xdg_shell;
         std::unique_ptr<Wrapland::Client::ShmPool> shm;
         std::unique_ptr<Wrapland::Client::Seat> seat;
@@ -478,6 +478,9 @@ void pointer_motion_absolute(QPointF const& position, uint32_t time)
 
     wlr_signal_emit_safe(&test_app->pointer->events.motion_absolute, &event);
     wlr_signal_emit_safe(&test_app->pointer->events.frame, test_app->pointer);
+
+    // Motions are queued until the event loop is reached. Process it right away instead.
+    test_app->base->mod.space->input->pointer->flush_motions();
 }
 
 void pointer_button_impl(uint32_t button, uint32_t time, wl_pointer_button_state state)
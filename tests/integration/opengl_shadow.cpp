@@ -6,6 +6,10 @@ SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "lib/setup.h"
 
+#include <como/render/gl/scene.h>
+#include <como/render/gl/shadow.h>
+#include <como/render/gl/shadow_texture_cache.h>
+
 #include <KDecoration2/Decoration>
 #include <KDecoration2/DecorationShadow>
 #include <QByteArray>
@@ -14,10 +18,12 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <Wrapland/Client/shadow.h>
 #include <Wrapland/Client/shm_pool.h>
 #include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
 #include <Wrapland/Client/xdgdecoration.h>
 #include <Wrapland/Server/shadow.h>
 #include <Wrapland/Server/surface.h>
 #include <algorithm>
+#include <set>
 #include <catch2/generators/catch_generators.hpp>
 
 namespace como::detail::test::opengl_shadow
@@ -730,6 +736,93 @@ TEST_CASE("opengl shadow", "[render]")
             }
         }
     }
+
+    SECTION("shared textures")
+    {
+        // Windows with the same shadow content share a texture.
+        setup_wayland_connection(global_selection::shadow);
+
+        auto& cache = render::gl::shadow_texture_cache::instance();
+        auto const initial = cache.get_report();
+
+        // Colored, so the texture is not converted to an alpha-only format.
+        QImage tile(64, 64, QImage::Format_ARGB32_Premultiplied);
+        tile.fill(QColor(64, 0, 0, 128));
+
+        struct client_window {
+            std::unique_ptr<Wrapland::Client::Surface> surface;
+            std::unique_ptr<Wrapland::Client::XdgShellToplevel> toplevel;
+            std::unique_ptr<Wrapland::Client::Shadow> shadow;
+        };
+        std::vector<client_window> windows;
+        std::vector<wayland_window*> shadow_windows;
+
+        using render_t = std::remove_reference_t<decltype(*setup.base->mod.render)>;
+        using scene_t = render::gl::scene<render_t>;
+        using shadow_t = render::gl::shadow<typename scene_t::window_t, scene_t>;
+
+        constexpr size_t count{200};
+        auto shm = get_client().interfaces.shm.get();
+
+        for (size_t i = 0; i < count; i++) {
+            client_window client;
+            client.surface = create_surface();
+            client.toplevel = create_xdg_shell_toplevel(client.surface);
+
+            auto window = render_and_wait_for_shown(client.surface, QSize(100, 100), Qt::blue);
+            QVERIFY(window);
+
+            client.shadow.reset(
+                get_client().interfaces.shadow_manager->createShadow(client.surface.get()));
+            client.shadow->attachTopLeft(shm->createBuffer(tile));
+            client.shadow->attachTop(shm->createBuffer(tile));
+            client.shadow->attachTopRight(shm->createBuffer(tile));
+            client.shadow->attachRight(shm->createBuffer(tile));
+            client.shadow->attachBottomRight(shm->createBuffer(tile));
+            client.shadow->attachBottom(shm->createBuffer(tile));
+            client.shadow->attachBottomLeft(shm->createBuffer(tile));
+            client.shadow->attachLeft(shm->createBuffer(tile));
+            client.shadow->setOffsets(QMarginsF(64, 64, 64, 64));
+
+            QSignalSpy commit_spy(window->surface, &Wrapland::Server::Surface::committed);
+            QVERIFY(commit_spy.isValid());
+            client.shadow->commit();
+            client.surface->commit(Wrapland::Client::Surface::CommitFlag::None);
+            QVERIFY(commit_spy.wait());
+            QVERIFY(window->render->shadow());
+
+            windows.push_back(std::move(client));
+            shadow_windows.push_back(window);
+        }
+
+        // All windows draw their shadow with the same texture object.
+        std::set<GLTexture*> textures;
+        for (auto window : shadow_windows) {
+            textures.insert(static_cast<shadow_t*>(window->render->shadow())->shadowTexture());
+        }
+        REQUIRE(textures.size() == 1);
+        REQUIRE(*textures.begin());
+        REQUIRE((*textures.begin())->size() == QSize(3 * 64, 3 * 64));
+
+        // The cache report is only bookkeeping of the cache. It must agree with the above.
+        auto const report = cache.get_report();
+        REQUIRE(report.textures == initial.textures + 1);
+        REQUIRE(report.users == initial.users + count);
+
+        // One texture of 3x3 tiles instead of one per window.
+        auto const texture_bytes = size_t(3 * 64) * (3 * 64) * 4;
+        REQUIRE(report.bytes - initial.bytes == texture_bytes);
+        REQUIRE(report.saved_bytes - initial.saved_bytes == (count - 1) * texture_bytes);
+
+        UNSCOPED_INFO("Shadow texture memory with " << count << " windows: " << report.bytes
+                                                    << " bytes, saved: " << report.saved_bytes
+                                                    << " bytes");
+
+        // The texture is released with the last window using it.
+        shadow_windows.clear();
+        windows.clear();
+        QTRY_COMPARE(cache.get_report().textures, initial.textures);
+    }
 }
 
 }
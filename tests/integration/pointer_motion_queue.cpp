@@ -0,0 +1,117 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <linux/input.h>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+void move(input::pointer* device, uint32_t time, QPointF const& delta)
+{
+    Q_EMIT device->motion({delta, delta, {device, time}});
+    Q_EMIT device->frame();
+}
+
+}
+
+TEST_CASE("pointer motion queue", "[input]")
+{
+    test::setup setup("pointer-motion-queue");
+    setup.start();
+    cursor()->set_pos(QPoint(100, 100));
+
+    auto& redirect = *setup.base->mod.space->input;
+    REQUIRE(!setup.base->mod.input->pointers.empty());
+    auto device = setup.base->mod.input->pointers.front();
+
+    QSignalSpy pos_spy(redirect.qobject.get(), &input::redirect_qobject::globalPointerChanged);
+    QVERIFY(pos_spy.isValid());
+
+    uint32_t time{0};
+
+    SECTION("coalesce")
+    {
+        for (int i = 0; i < 10; i++) {
+            move(device, ++time, QPointF(2, 1));
+        }
+
+        // Nothing is processed until the event loop is reached.
+        QCOMPARE(cursor()->pos(), QPoint(100, 100));
+        QVERIFY(pos_spy.isEmpty());
+
+        // All motions are processed at once.
+        QVERIFY(pos_spy.wait());
+        QCOMPARE(pos_spy.count(), 1);
+        QCOMPARE(cursor()->pos(), QPoint(120, 110));
+    }
+
+    SECTION("order")
+    {
+        // Queued motions are processed before any other event.
+        move(device, ++time, QPointF(10, 0));
+        pointer_button_pressed(BTN_LEFT, ++time);
+        QCOMPARE(pos_spy.count(), 1);
+        QCOMPARE(cursor()->pos(), QPoint(110, 100));
+
+        move(device, ++time, QPointF(0, 10));
+        keyboard_key_pressed(KEY_A, ++time);
+        QCOMPARE(cursor()->pos(), QPoint(110, 110));
+
+        keyboard_key_released(KEY_A, ++time);
+        pointer_button_released(BTN_LEFT, ++time);
+    }
+}
+
+TEST_CASE("pointer motion queue benchmark", "[input],[.benchmark]")
+{
+    test::setup setup("pointer-motion-queue-benchmark");
+    setup.start();
+    cursor()->set_pos(QPoint(100, 100));
+
+    auto& redirect = *setup.base->mod.space->input;
+    REQUIRE(!setup.base->mod.input->pointers.empty());
+    auto device = setup.base->mod.input->pointers.front();
+
+    // Paints are stalled like under heavy load. Motions arriving meanwhile pile up in the queue of
+    // the device and are processed at once when control returns to the event loop.
+    auto& render = *setup.base->mod.render;
+    render.lock();
+
+    uint32_t time{0};
+    int iteration{0};
+
+    BENCHMARK("burst of 50 motions queued during a stalled paint")
+    {
+        auto const delta = QPointF(iteration++ % 2 ? -1. : 1., 0);
+        for (int i = 0; i < 50; i++) {
+            move(device, ++time, delta);
+        }
+
+        redirect.pointer->flush_motions();
+        return cursor()->pos();
+    };
+
+    // For comparison the same burst processed without the queue.
+    BENCHMARK("burst of 50 motions processed one by one during a stalled paint")
+    {
+        auto const delta = QPointF(iteration++ % 2 ? -1. : 1., 0);
+        for (int i = 0; i < 50; i++) {
+            redirect.pointer->process_motion({delta, delta, {device, ++time}});
+            redirect.pointer->process_frame();
+        }
+
+        return cursor()->pos();
+    };
+
+    render.unlock();
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "generic_scene_opengl.h"
+#include "lib/setup.h"
+
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace como::detail::test
+{
+
+TEST_CASE("render batch benchmark", "[render],[.benchmark]")
+{
+    auto setup = generic_scene_opengl_get_setup("render-batch", "O2");
+    setup_wayland_connection();
+
+    auto const window_count = GENERATE(10, 30, 60);
+
+    struct client_window {
+        std::unique_ptr<Wrapland::Client::Surface> surface;
+        std::unique_ptr<Wrapland::Client::XdgShellToplevel> toplevel;
+    };
+    std::vector<client_window> windows;
+
+    for (int i = 0; i < window_count; i++) {
+        client_window client;
+        client.surface = create_surface();
+        client.toplevel = create_xdg_shell_toplevel(client.surface);
+
+        // Every fourth window is translucent so not everything below gets culled.
+        auto const color = i % 4 == 3 ? QColor(0, 0, 255, 128) : QColor(Qt::blue);
+        auto window = render_and_wait_for_shown(client.surface, QSize(400, 300), color);
+        REQUIRE(window);
+
+        win::move(window, QPoint((i * 37) % 900, (i * 23) % 500));
+        windows.push_back(std::move(client));
+    }
+
+    auto& top = windows.back();
+    QSignalSpy frame_spy(top.surface.get(), &Wrapland::Client::Surface::frameRendered);
+    REQUIRE(frame_spy.isValid());
+
+    // Every frame repaints the full screen, so the draws of all windows are submitted.
+    BENCHMARK("full repaint with " + std::to_string(window_count) + " windows")
+    {
+        render(top.surface, QSize(400, 300), Qt::red);
+        render::full_repaint(*setup->base->mod.render);
+        return frame_spy.wait();
+    };
+}
+
+}
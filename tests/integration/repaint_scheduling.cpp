@@ -0,0 +1,100 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <como/render/wayland/repaint_policy.h>
+
+using namespace std::chrono_literals;
+
+namespace como::detail::test
+{
+
+TEST_CASE("repaint scheduling", "[render]")
+{
+    test::setup setup("repaint-scheduling", base::operation_mode::wayland);
+    setup.start();
+
+    auto& output = *setup.base->outputs.at(0)->render;
+    auto const refresh = std::chrono::nanoseconds(16'666'666);
+
+    auto fill_timings = [&](std::chrono::nanoseconds paint, std::chrono::nanoseconds render) {
+        // Overwrite all samples recorded so far.
+        for (size_t i = 0; i < output.timings.paint.capacity; i++) {
+            output.timings.paint.add(paint);
+            output.timings.render.add(render);
+        }
+    };
+
+    SECTION("percentile policy ignores outliers")
+    {
+        fill_timings(2ms, 1ms);
+        output.timings.paint.add(12ms);
+
+        output.set_repaint_policy(render::wayland::repaint_policy_type::max);
+        auto const max_margin = output.policy->margin(refresh, output.timings);
+        REQUIRE(max_margin == refresh / 10 + 12ms + 1ms);
+
+        output.set_repaint_policy(render::wayland::repaint_policy_type::percentile);
+        auto const percentile_margin = output.policy->margin(refresh, output.timings);
+        REQUIRE(percentile_margin == refresh / 20 + 2ms + 1ms);
+        REQUIRE(percentile_margin < max_margin);
+    }
+
+    SECTION("missed vblanks adapt margin")
+    {
+        fill_timings(2ms, 1ms);
+        output.set_repaint_policy(QStringLiteral("percentile"));
+        REQUIRE(output.get_repaint_policy_name() == QStringLiteral("percentile"));
+
+        auto const base_margin = output.policy->margin(refresh, output.timings);
+        auto const hit_count = output.timings.hit_frames.load();
+        auto const miss_count = output.timings.missed_frames.load();
+
+        auto vblank = std::chrono::steady_clock::now().time_since_epoch();
+        uint32_t seq{0};
+
+        // Synthetic presentation feedback for a frame targeting the next vblank.
+        auto present = [&](bool miss) {
+            vblank += refresh;
+            output.present_target = vblank;
+            if (miss) {
+                vblank += refresh;
+            }
+            output.presented(render::wayland::presentation_data{
+                seq, vblank, seq, refresh, render::wayland::presentation_kind::vsync});
+            seq++;
+        };
+
+        present(false);
+        REQUIRE(output.timings.hit_frames.load() == hit_count + 1);
+        REQUIRE(output.policy->margin(refresh, output.timings) == base_margin);
+
+        present(true);
+        REQUIRE(output.timings.missed_frames.load() == miss_count + 1);
+
+        auto const missed_margin = output.policy->margin(refresh, output.timings);
+        REQUIRE(missed_margin > base_margin);
+
+        present(true);
+        REQUIRE(output.policy->margin(refresh, output.timings) > missed_margin);
+
+        // Without further misses we approach the vblank again.
+        for (int i = 0; i < 1000; i++) {
+            present(false);
+        }
+        REQUIRE(output.timings.hit_frames.load() == hit_count + 1001);
+        REQUIRE(output.policy->margin(refresh, output.timings) == base_margin);
+    }
+
+    SECTION("unknown policy is rejected")
+    {
+        output.set_repaint_policy(render::wayland::repaint_policy_type::max);
+        REQUIRE(!output.set_repaint_policy(QStringLiteral("foo")));
+        REQUIRE(output.get_repaint_policy_name() == QStringLiteral("max"));
+    }
+}
+
+}
@@ -6,6 +6,7 @@ SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "lib/setup.h"
 
+#include "como/base/config-como.h"
 #include "como/base/wayland/server.h"
 #include "como/script/platform.h"
 #include "como/script/script.h"
@@ -69,6 +70,14 @@ TEST_CASE("minimize all", "[script]")
     script->run();
     QTRY_COMPARE(runningChangedSpy.count(), 1);
 
+    // Load costs are reported.
+    REQUIRE(script->property("loadTime").toLongLong() >= 0);
+#if HAVE_SCRIPT_HEAP_SIZE
+    REQUIRE(script->property("heapSize").toLongLong() > 0);
+#else
+    REQUIRE(script->property("heapSize").toLongLong() == -1);
+#endif
+
     // Create a couple of test clients.
     auto surface1 = create_surface();
     QVERIFY(surface1);
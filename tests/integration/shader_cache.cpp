@@ -0,0 +1,194 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "generic_scene_opengl.h"
+#include "lib/setup.h"
+
+#include <como/render/gl/interface/shader.h>
+#include <como/render/gl/interface/shader_cache.h>
+#include <como/render/gl/interface/shader_manager.h>
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+// Restores the cache directory of the shader manager also when a check fails.
+struct cache_directory_guard {
+    explicit cache_directory_guard(QString const& directory)
+        : previous{ShaderManager::instance()->cacheDirectory()}
+    {
+        ShaderManager::instance()->setCacheDirectory(directory);
+    }
+
+    ~cache_directory_guard()
+    {
+        ShaderManager::instance()->setCacheDirectory(previous);
+    }
+
+    QString previous;
+};
+
+}
+
+TEST_CASE("shader cache", "[render]")
+{
+    auto setup = generic_scene_opengl_get_setup("shader-cache", "O2");
+    REQUIRE(setup->base->mod.render->scene->makeOpenGLContextCurrent());
+
+    if (!ShaderCache::isSupported()) {
+        SKIP("Program binaries are not supported by the driver");
+    }
+
+    QTemporaryDir cache_dir;
+    REQUIRE(cache_dir.isValid());
+
+    auto manager = ShaderManager::instance();
+    cache_directory_guard guard(cache_dir.path());
+
+    // Programs are stored in a single subdirectory for the current driver.
+    auto cache_files = [&] {
+        QStringList files;
+        QDirIterator it(cache_dir.path(), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            files.append(it.next());
+        }
+        return files;
+    };
+    ShaderTraits const traits = ShaderTrait::MapTexture | ShaderTrait::Modulate;
+
+    SECTION("cached program")
+    {
+        auto shader = manager->generateCustomShader(traits);
+        REQUIRE(shader->isValid());
+        REQUIRE(cache_files().size() == 1);
+
+        // Loaded from the cache the program is still usable.
+        auto cached = manager->generateCustomShader(traits);
+        REQUIRE(cached->isValid());
+        REQUIRE(cached->uniformLocation("modulation") != -1);
+        REQUIRE(cache_files().size() == 1);
+    }
+
+    SECTION("custom program")
+    {
+        auto const vertex = QByteArrayLiteral(R"(#version 140
+in vec4 vertex;
+uniform mat4 modelViewProjectionMatrix;
+void main() {
+    gl_Position = modelViewProjectionMatrix * vertex;
+}
+)");
+        auto const fragment = QByteArrayLiteral(R"(#version 140
+uniform vec4 modulation;
+out vec4 fragColor;
+void main() {
+    fragColor = modulation;
+}
+)");
+
+        REQUIRE(manager->loadShaderFromCode(vertex, fragment)->isValid());
+        REQUIRE(cache_files().size() == 1);
+        REQUIRE(manager->loadShaderFromCode(vertex, fragment)->isValid());
+        REQUIRE(cache_files().size() == 1);
+
+        // Generic shaders with the same sources bind other attributes and are cached separately.
+        REQUIRE(manager->generateCustomShader(traits, vertex, fragment)->isValid());
+        REQUIRE(cache_files().size() == 2);
+    }
+
+    SECTION("invalid cache file")
+    {
+        REQUIRE(manager->generateCustomShader(traits)->isValid());
+        REQUIRE(cache_files().size() == 1);
+
+        QFile file(cache_files().constFirst());
+        REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("garbage");
+        file.close();
+
+        // The program is compiled again and the cache file replaced.
+        REQUIRE(manager->generateCustomShader(traits)->isValid());
+        REQUIRE(QFileInfo(file).size() > 7);
+    }
+
+    SECTION("disabled cache")
+    {
+        manager->setCacheDirectory({});
+        REQUIRE(manager->generateCustomShader(traits)->isValid());
+        REQUIRE(cache_files().isEmpty());
+    }
+
+    SECTION("stale entries")
+    {
+        REQUIRE(manager->generateCustomShader(traits)->isValid());
+        auto const current = QFileInfo(cache_files().constFirst()).dir().dirName();
+        REQUIRE(current.startsWith(QStringLiteral("programs-")));
+
+        auto create_file = [&](QString const& path) {
+            REQUIRE(QDir(cache_dir.path()).mkpath(QFileInfo(cache_dir.filePath(path)).path()));
+            QFile file(cache_dir.filePath(path));
+            REQUIRE(file.open(QIODevice::WriteOnly));
+        };
+
+        // Left behind by another driver.
+        create_file(QStringLiteral("programs-stale/program"));
+
+        // Not created by the cache.
+        create_file(QStringLiteral("other/file"));
+        create_file(QStringLiteral("file"));
+
+        // The cache is set up again. Only the entry of the other driver is removed.
+        manager->setCacheDirectory(cache_dir.path());
+        REQUIRE(manager->generateCustomShader(traits)->isValid());
+
+        auto entries
+            = QDir(cache_dir.path()).entryList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
+        entries.sort();
+        REQUIRE(entries == QStringList{QStringLiteral("file"), QStringLiteral("other"), current});
+        REQUIRE(cache_files().size() == 3);
+    }
+}
+
+TEST_CASE("shader cache benchmark", "[render],[.benchmark]")
+{
+    auto setup = generic_scene_opengl_get_setup("shader-cache-benchmark", "O2");
+    REQUIRE(setup->base->mod.render->scene->makeOpenGLContextCurrent());
+
+    if (!ShaderCache::isSupported()) {
+        SKIP("Program binaries are not supported by the driver");
+    }
+
+    QTemporaryDir cache_dir;
+    REQUIRE(cache_dir.isValid());
+
+    auto manager = ShaderManager::instance();
+    cache_directory_guard guard({});
+
+    ShaderTraits const all_traits
+        = ShaderTrait::MapTexture | ShaderTrait::Modulate | ShaderTrait::AdjustSaturation;
+
+    BENCHMARK("compile shader program")
+    {
+        return manager->generateCustomShader(all_traits)->isValid();
+    };
+
+    manager->setCacheDirectory(cache_dir.path());
+    REQUIRE(manager->generateCustomShader(all_traits)->isValid());
+
+    BENCHMARK("load cached shader program")
+    {
+        return manager->generateCustomShader(all_traits)->isValid();
+    };
+}
+
+}
@@ -0,0 +1,161 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "generic_scene_opengl.h"
+#include "lib/setup.h"
+
+#include <como/render/backend/wlroots/shm_upload.h>
+#include <como/render/backend/wlroots/texture_update.h>
+
+#include <Wrapland/Client/shm_pool.h>
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace como::detail::test
+{
+
+TEST_CASE("shm upload", "[render]")
+{
+    using render::backend::wlroots::coalesce_damage;
+
+    SECTION("damage coalescing")
+    {
+        auto const bounds = QRect(0, 0, 100, 100);
+
+        // Damage is clipped to the buffer.
+        REQUIRE(coalesce_damage(QRegion(90, 90, 20, 20), bounds) == QRegion(90, 90, 10, 10));
+
+        // Distant rects are uploaded separately.
+        auto const distant = QRegion(0, 0, 10, 10).united(QRect(90, 90, 10, 10));
+        REQUIRE(coalesce_damage(distant, bounds) == distant);
+
+        // Close rects are merged.
+        auto const close = QRegion(0, 0, 10, 10).united(QRect(12, 0, 10, 10));
+        REQUIRE(coalesce_damage(close, bounds) == QRegion(0, 0, 22, 10));
+
+        // Many rects are merged in any case.
+        QRegion many;
+        for (int i = 0; i < 20; i++) {
+            many += QRect(i * 5, i * 5, 1, 1);
+        }
+        REQUIRE(coalesce_damage(many, bounds) == QRegion(0, 0, 96, 96));
+    }
+}
+
+TEST_CASE("shm upload benchmark", "[render],[.benchmark]")
+{
+    auto setup = generic_scene_opengl_get_setup("shm-upload", "O2");
+    setup_wayland_connection();
+
+    struct damage_pattern {
+        std::string name;
+        QRegion region;
+    };
+
+    auto const size = QSize(1024, 768);
+
+    QRegion glyphs;
+    for (int i = 0; i < 32; i++) {
+        glyphs += QRect((i * 97) % 1016, (i * 61) % 752, 8, 16);
+    }
+
+    auto const pattern = GENERATE_COPY(damage_pattern{"full", QRegion(QRect({}, size))},
+                                       damage_pattern{"line", QRegion(0, 320, 1024, 16)},
+                                       damage_pattern{"glyphs", glyphs});
+
+    auto surface = create_surface();
+    auto toplevel = create_xdg_shell_toplevel(surface);
+    auto window = render_and_wait_for_shown(surface, size, Qt::blue);
+    REQUIRE(window);
+
+    QSignalSpy frame_spy(surface.get(), &Wrapland::Client::Surface::frameRendered);
+    REQUIRE(frame_spy.isValid());
+
+    QImage img(size, QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::red);
+
+    int64_t damaged_bytes{0};
+    for (auto const& rect : pattern.region) {
+        damaged_bytes += static_cast<int64_t>(rect.width()) * rect.height() * 4;
+    }
+
+    BENCHMARK("upload " + pattern.name + " damage (" + std::to_string(damaged_bytes / 1024)
+              + " KiB per frame)")
+    {
+        surface->attachBuffer(get_client().interfaces.shm->createBuffer(img));
+        surface->damage(pattern.region);
+        surface->commit();
+        return frame_spy.wait();
+    };
+}
+
+TEST_CASE("internal image conversion", "[render]")
+{
+    using render::backend::wlroots::get_converted_image;
+
+    // Size of a typical task switcher.
+    auto const size = QSize(800, 300);
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::blue);
+
+    // Damage of a moving highlight.
+    auto const damage = QRegion(200, 100, 160, 120);
+
+    SECTION("direct upload")
+    {
+        QImage cache;
+        auto const& upload = get_converted_image(image, image.format(), damage, cache);
+        REQUIRE(upload.constBits() == image.constBits());
+        REQUIRE(cache.isNull());
+    }
+
+    SECTION("damage conversion")
+    {
+        QImage cache;
+        auto const format = QImage::Format_RGBA8888_Premultiplied;
+
+        get_converted_image(image, format, damage, cache);
+        REQUIRE(cache.format() == format);
+        REQUIRE(cache.pixelColor(210, 110) == QColor(Qt::blue));
+        auto const bits = cache.constBits();
+
+        image.fill(Qt::red);
+        auto const& upload = get_converted_image(image, format, damage, cache);
+
+        // Only the damage got converted into the same buffer.
+        REQUIRE(upload.constBits() == bits);
+        REQUIRE(upload.pixelColor(210, 110) == QColor(Qt::red));
+        REQUIRE(upload.pixelColor(10, 10) == QColor(Qt::blue));
+    }
+}
+
+TEST_CASE("internal image conversion benchmark", "[render],[.benchmark]")
+{
+    using render::backend::wlroots::get_converted_image;
+
+    auto const size = QSize(800, 300);
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::blue);
+
+    auto const damage = QRegion(200, 100, 160, 120);
+    auto const format = QImage::Format_RGBA8888_Premultiplied;
+
+    QImage cache;
+    get_converted_image(image, format, damage, cache);
+
+    BENCHMARK("full conversion")
+    {
+        return image.convertToFormat(format);
+    };
+
+    BENCHMARK("damage conversion")
+    {
+        return get_converted_image(image, format, damage, cache).constBits();
+    };
+}
+
+}
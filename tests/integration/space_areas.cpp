@@ -0,0 +1,154 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <Wrapland/Client/plasmashell.h>
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_shell.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+using PSS = Wrapland::Client::PlasmaShellSurface;
+
+struct client_window {
+    std::unique_ptr<Wrapland::Client::Surface> surface;
+    std::unique_ptr<Wrapland::Client::XdgShellToplevel> toplevel;
+    std::unique_ptr<PSS> plasma_surface;
+    wayland_window* window{nullptr};
+};
+
+std::unique_ptr<test::setup> create_setup(std::string const& test_name)
+{
+    auto setup = std::make_unique<test::setup>(test_name);
+    setup->start();
+    setup_wayland_connection(global_selection::plasma_shell);
+    cursor()->set_pos(QPoint(640, 512));
+
+    auto& space = *setup->base->mod.space;
+    win::subspace_manager_set_count(*space.subspace_manager, 20);
+    REQUIRE(space.subspace_manager->subspaces.size() == 20);
+    return setup;
+}
+
+// The panel is only on the first subspace, so only its areas change with the strut.
+client_window create_panel()
+{
+    client_window panel;
+    panel.surface = create_surface();
+    panel.toplevel = create_xdg_shell_toplevel(panel.surface);
+    panel.plasma_surface.reset(
+        get_client().interfaces.plasma_shell->createSurface(panel.surface.get()));
+    panel.plasma_surface->setRole(PSS::Role::Panel);
+    panel.plasma_surface->setPosition(QPoint(0, 0));
+    panel.plasma_surface->setPanelBehavior(PSS::PanelBehavior::AutoHide);
+
+    panel.window = render_and_wait_for_shown(panel.surface, QSize(1280, 50), Qt::blue);
+    REQUIRE(panel.window);
+    REQUIRE(!panel.window->hasStrut());
+    win::set_subspace(*panel.window, 1);
+    return panel;
+}
+
+bool toggle_strut(client_window& panel, bool strut)
+{
+    panel.plasma_surface->setPanelBehavior(strut ? PSS::PanelBehavior::AlwaysVisible
+                                                 : PSS::PanelBehavior::AutoHide);
+    return QTest::qWaitFor([&] { return panel.window->hasStrut() == strut; });
+}
+
+client_window create_window(int subspace)
+{
+    client_window client;
+    client.surface = create_surface();
+    client.toplevel = create_xdg_shell_toplevel(client.surface);
+    client.window = render_and_wait_for_shown(client.surface, QSize(100, 50), Qt::red);
+    REQUIRE(client.window);
+    win::set_subspace(*client.window, subspace);
+    win::move(client.window, QPoint(100, 0));
+    return client;
+}
+
+}
+
+TEST_CASE("space areas", "[win]")
+{
+    auto setup = create_setup("space-areas");
+    auto& space = *setup->base->mod.space;
+    auto panel = create_panel();
+
+    auto max_area = [&](int subspace) {
+        return win::space_window_area(space, win::area_option::maximize, nullptr, subspace);
+    };
+
+    SECTION("changed subspaces")
+    {
+        auto affected = create_window(1);
+        auto unaffected = create_window(2);
+
+        // A re-check moves windows back on screen. So these stay off-screen only when they are
+        // not re-checked.
+        auto offscreen_affected = create_window(1);
+        auto offscreen_unaffected = create_window(2);
+        win::move(offscreen_affected.window, QPoint(100, 2000));
+        win::move(offscreen_unaffected.window, QPoint(100, 2000));
+
+        QSignalSpy unaffected_spy(offscreen_unaffected.window->qobject.get(),
+                                  &win::window_qobject::frame_geometry_changed);
+        REQUIRE(unaffected_spy.isValid());
+
+        REQUIRE(toggle_strut(panel, true));
+        REQUIRE(max_area(1) == QRect(0, 50, 1280, 974));
+        REQUIRE(max_area(2) == QRect(0, 0, 1280, 1024));
+
+        // Windows touching the screen edge keep touching the edge of the area.
+        REQUIRE(affected.window->geo.frame.topLeft() == QPoint(100, 50));
+        REQUIRE(unaffected.window->geo.frame.topLeft() == QPoint(100, 0));
+
+        // Only windows on the subspace with the changed area were re-checked.
+        REQUIRE(offscreen_affected.window->geo.frame.top() < 1024);
+        REQUIRE(offscreen_unaffected.window->geo.frame.topLeft() == QPoint(100, 2000));
+        REQUIRE(unaffected_spy.isEmpty());
+
+        REQUIRE(toggle_strut(panel, false));
+        REQUIRE(max_area(1) == QRect(0, 0, 1280, 1024));
+        REQUIRE(affected.window->geo.frame.topLeft() == QPoint(100, 0));
+        REQUIRE(unaffected.window->geo.frame.topLeft() == QPoint(100, 0));
+        REQUIRE(offscreen_unaffected.window->geo.frame.topLeft() == QPoint(100, 2000));
+        REQUIRE(unaffected_spy.isEmpty());
+    }
+}
+
+TEST_CASE("space areas benchmark", "[win],[.benchmark]")
+{
+    auto setup = create_setup("space-areas-benchmark");
+    auto& space = *setup->base->mod.space;
+    auto panel = create_panel();
+
+    std::vector<client_window> windows;
+    for (int i = 0; i < 300; i++) {
+        windows.push_back(create_window(i % 20 + 1));
+    }
+
+    REQUIRE(toggle_strut(panel, true));
+    auto const strut_areas = space.areas;
+    REQUIRE(toggle_strut(panel, false));
+
+    // Each run starts from the areas with the strut, so the update finds the first subspace
+    // changed and re-checks its windows.
+    BENCHMARK("update areas after a dock strut toggle with 300 windows on 20 subspaces")
+    {
+        space.areas = strut_areas;
+        win::update_space_areas_impl(space, false);
+        return space.areas.work.size();
+    };
+}
+
+}
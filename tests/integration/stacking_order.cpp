@@ -886,6 +886,31 @@ TEST_CASE("stacking order", "[win]")
                  (std::deque<space::window_t>{clientB, clientA}));
     }
 
+    SECTION("render stack")
+    {
+        // This test verifies that the cached render stack follows restacks.
+        auto& order = setup.base->mod.space->stacking.order;
+
+        auto clientASurface = create_surface();
+        auto clientAShellSurface = create_xdg_shell_toplevel(clientASurface);
+        auto clientA = render_and_wait_for_shown(clientASurface, QSize(128, 128), Qt::green);
+        QVERIFY(clientA);
+
+        auto clientBSurface = create_surface();
+        auto clientBShellSurface = create_xdg_shell_toplevel(clientBSurface);
+        auto clientB = render_and_wait_for_shown(clientBSurface, QSize(128, 128), Qt::green);
+        QVERIFY(clientB);
+
+        QCOMPARE(win::render_stack(order), (std::deque<space::window_t>{clientA, clientB}));
+
+        win::raise_window(*setup.base->mod.space, clientA);
+        QCOMPARE(order.stack, (std::deque<space::window_t>{clientB, clientA}));
+        QCOMPARE(win::render_stack(order), (std::deque<space::window_t>{clientB, clientA}));
+
+        win::lower_window(*setup.base->mod.space, clientA);
+        QCOMPARE(win::render_stack(order), (std::deque<space::window_t>{clientA, clientB}));
+    }
+
     destroy_wayland_connection();
     QTRY_VERIFY(setup.base->mod.space->stacking.order.stack.empty());
 }
@@ -0,0 +1,175 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <como/input/window_find.h>
+
+#include <Wrapland/Client/surface.h>
+#include <Wrapland/Client/xdg_decoration.h>
+#include <Wrapland/Client/xdg_shell.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace como::detail::test
+{
+
+TEST_CASE("window find", "[input]")
+{
+    test::setup setup("window-find", base::operation_mode::wayland);
+    setup.start();
+    setup_wayland_connection(global_selection::xdg_decoration);
+    cursor()->set_pos(QPoint(1270, 1014));
+
+    struct window_data {
+        std::unique_ptr<Wrapland::Client::Surface> surface;
+        std::unique_ptr<Wrapland::Client::XdgShellToplevel> toplevel;
+        wayland_window* window{nullptr};
+    };
+
+    auto create_windows = [](size_t count) {
+        std::vector<window_data> windows;
+        for (size_t i = 0; i < count; i++) {
+            window_data data;
+            data.surface = create_surface();
+            data.toplevel = create_xdg_shell_toplevel(data.surface);
+            data.window = render_and_wait_for_shown(data.surface, QSize(100, 50), Qt::blue);
+            REQUIRE(data.window);
+            windows.push_back(std::move(data));
+        }
+        return windows;
+    };
+
+    auto& redirect = *setup.base->mod.space->input;
+
+    SECTION("topmost window")
+    {
+        auto windows = create_windows(3);
+
+        win::move(windows.at(0).window, QPoint(0, 0));
+        win::move(windows.at(1).window, QPoint(50, 0));
+        win::move(windows.at(2).window, QPoint(600, 600));
+
+        auto found = input::find_window(redirect, QPoint(75, 25));
+        REQUIRE(found);
+        REQUIRE(*found == space::window_t(windows.at(1).window));
+
+        found = input::find_window(redirect, QPoint(25, 25));
+        REQUIRE(found);
+        REQUIRE(*found == space::window_t(windows.at(0).window));
+
+        REQUIRE(!input::find_window(redirect, QPoint(300, 300)));
+
+        // Moved windows are found at their new position.
+        win::move(windows.at(2).window, QPoint(280, 280));
+        found = input::find_window(redirect, QPoint(300, 300));
+        REQUIRE(found);
+        REQUIRE(*found == space::window_t(windows.at(2).window));
+        REQUIRE(!input::find_window(redirect, QPoint(610, 610)));
+
+        // Restacking changes the result.
+        win::raise_window(*setup.base->mod.space, windows.at(0).window);
+        found = input::find_window(redirect, QPoint(75, 25));
+        REQUIRE(found);
+        REQUIRE(*found == space::window_t(windows.at(0).window));
+
+        // Closed windows are not found anymore.
+        windows.at(0).toplevel.reset();
+        windows.at(0).surface.reset();
+        REQUIRE(wait_for_destroyed(windows.at(0).window));
+
+        found = input::find_window(redirect, QPoint(75, 25));
+        REQUIRE(found);
+        REQUIRE(*found == space::window_t(windows.at(1).window));
+        REQUIRE(!input::find_window(redirect, QPoint(25, 25)));
+    }
+
+    SECTION("decoration borders")
+    {
+        // Verifies that the index follows the resize only borders of the decoration.
+        auto& config = setup.base->config.main;
+        auto set_border_size = [&](QString const& size) {
+            config->group(QStringLiteral("org.kde.kdecoration2")).writeEntry("BorderSize", size);
+            config->sync();
+            win::space_reconfigure(*setup.base->mod.space);
+        };
+        set_border_size(QStringLiteral("Normal"));
+
+        window_data data;
+        data.surface = create_surface();
+        data.toplevel = create_xdg_shell_toplevel(data.surface, CreationSetup::CreateOnly);
+
+        std::unique_ptr<Wrapland::Client::XdgDecoration> deco(
+            get_client().interfaces.xdg_decoration->getToplevelDecoration(data.toplevel.get()));
+        deco->setMode(Wrapland::Client::XdgDecoration::Mode::ServerSide);
+        init_xdg_shell_toplevel(data.surface, data.toplevel);
+
+        data.window = render_and_wait_for_shown(data.surface, QSize(100, 50), Qt::blue);
+        REQUIRE(data.window);
+
+        auto win = data.window;
+        REQUIRE(win::decoration(win));
+        REQUIRE(win::decoration(win)->resizeOnlyBorders().left() == 0);
+
+        win::move(win, QPoint(400, 400));
+        auto const pos = win->geo.pos();
+        auto outside = [&] {
+            return QPoint(win->geo.frame.left() - 1, win->geo.frame.center().y());
+        };
+
+        // Fills the index with the current geometry.
+        REQUIRE(!input::find_window(redirect, outside()));
+
+        // Without side borders the decoration adds borders outside of the frame for resizing.
+        set_border_size(QStringLiteral("None"));
+        QTRY_VERIFY(win::decoration(win)->resizeOnlyBorders().left() > 0);
+        REQUIRE(win->geo.pos() == pos);
+
+        auto found = input::find_window(redirect, outside());
+        REQUIRE(found);
+        REQUIRE(*found == space::window_t(win));
+
+        set_border_size(QStringLiteral("Normal"));
+        QTRY_VERIFY(win::decoration(win)->resizeOnlyBorders().left() == 0);
+        REQUIRE(win->geo.pos() == pos);
+        REQUIRE(!input::find_window(redirect, outside()));
+    }
+}
+
+TEST_CASE("window find benchmark", "[input],[.benchmark]")
+{
+    test::setup setup("window-find-benchmark", base::operation_mode::wayland);
+    setup.start();
+    setup_wayland_connection();
+    cursor()->set_pos(QPoint(1270, 1014));
+
+    auto const count = GENERATE(10, 50, 200);
+
+    std::vector<std::unique_ptr<Wrapland::Client::Surface>> surfaces;
+    std::vector<std::unique_ptr<Wrapland::Client::XdgShellToplevel>> toplevels;
+
+    for (int i = 0; i < count; i++) {
+        surfaces.push_back(create_surface());
+        toplevels.push_back(create_xdg_shell_toplevel(surfaces.back()));
+        auto window = render_and_wait_for_shown(surfaces.back(), QSize(100, 50), Qt::blue);
+        REQUIRE(window);
+
+        // Tile the windows over the output with some overlap.
+        win::move(window, QPoint((i * 37) % 1180, (i * 53) % 970));
+    }
+
+    auto& redirect = *setup.base->mod.space->input;
+
+    BENCHMARK("find window on motion (" + std::to_string(count) + " windows)")
+    {
+        std::optional<space::window_t> found;
+        for (int x = 0; x < 1280; x += 8) {
+            found = input::find_window(redirect, QPoint(x, (x * 3) % 1024));
+        }
+        return found;
+    };
+}
+
+}
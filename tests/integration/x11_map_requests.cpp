@@ -0,0 +1,274 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <como/base/x11/xcb/helpers.h>
+#include <como/base/x11/xcb/wrapper.h>
+#include <como/win/x11/control_create.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <xcb/xcb_icccm.h>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+xcb_connection_t* counted_connection{nullptr};
+unsigned int counted_after_sequence{0};
+int round_trips{0};
+
+void count_round_trip(xcb_connection_t* con, unsigned int sequence)
+{
+    // Replies of requests sent before the marker are already received.
+    if (con == counted_connection && sequence > counted_after_sequence) {
+        round_trips++;
+    }
+}
+
+/**
+ * Waits for all replies of requests sent so far and only counts round trips for later requests.
+ */
+void reset_round_trips(xcb_connection_t* con)
+{
+    base::x11::xcb::sync(con);
+
+    auto const marker = xcb_get_input_focus(con);
+    xcb_discard_reply(con, marker.sequence);
+
+    counted_connection = con;
+    counted_after_sequence = marker.sequence;
+    round_trips = 0;
+}
+
+xcb_window_t create_named_window(test::setup& setup,
+                                 xcb_connection_t* c,
+                                 QRect const& geometry,
+                                 std::string const& name)
+{
+    auto const w = xcb_generate_id(c);
+    xcb_create_window(c,
+                      XCB_COPY_FROM_PARENT,
+                      w,
+                      setup.base->x11_data.root_window,
+                      geometry.x(),
+                      geometry.y(),
+                      geometry.width(),
+                      geometry.height(),
+                      0,
+                      XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                      XCB_COPY_FROM_PARENT,
+                      0,
+                      nullptr);
+
+    xcb_size_hints_t hints;
+    memset(&hints, 0, sizeof(hints));
+    xcb_icccm_size_hints_set_position(&hints, 1, geometry.x(), geometry.y());
+    xcb_icccm_size_hints_set_size(&hints, 1, geometry.width(), geometry.height());
+    xcb_icccm_set_wm_normal_hints(c, w, &hints);
+    xcb_icccm_set_wm_name(c, w, XCB_ATOM_STRING, 8, name.size(), name.c_str());
+    return w;
+}
+
+}
+
+TEST_CASE("x11 map requests", "[win]")
+{
+    test::setup setup("x11-map-requests", base::operation_mode::xwayland);
+    setup.start();
+
+    auto& space = *setup.base->mod.space;
+    auto c = xcb_connection_create();
+    QVERIFY(!xcb_connection_has_error(c.get()));
+
+    auto create_window = [&](QRect const& geometry, std::string const& name) {
+        return create_named_window(setup, c.get(), geometry, name);
+    };
+
+    auto get_window = [&](xcb_window_t w) -> space::x11_window* {
+        for (auto const& var_win : space.windows) {
+            if (auto win = std::get_if<space::x11_window*>(&var_win);
+                win && (*win)->control && (*win)->xcb_windows.client == w) {
+                return *win;
+            }
+        }
+        return nullptr;
+    };
+
+    SECTION("burst")
+    {
+        // All windows are mapped at once. They are managed with the correct data, also when it is
+        // only read after the data of the other windows was requested.
+        QSignalSpy window_added_spy(space.qobject.get(), &space::qobject_t::clientAdded);
+        QVERIFY(window_added_spy.isValid());
+
+        std::vector<xcb_window_t> windows;
+        for (int i = 0; i < 10; i++) {
+            windows.push_back(
+                create_window(QRect(i * 10, i * 10, 100, 100), "window " + std::to_string(i)));
+        }
+
+        // All other windows are dialogs of the first one.
+        for (size_t i = 1; i < windows.size(); i++) {
+            xcb_icccm_set_wm_transient_for(c.get(), windows.at(i), windows.front());
+        }
+
+        for (auto w : windows) {
+            xcb_map_window(c.get(), w);
+        }
+        xcb_flush(c.get());
+
+        QTRY_COMPARE(window_added_spy.count(), static_cast<int>(windows.size()));
+
+        auto lead = get_window(windows.front());
+        QVERIFY(lead);
+        QCOMPARE(win::caption(lead), QStringLiteral("window 0"));
+
+        for (size_t i = 1; i < windows.size(); i++) {
+            auto win = get_window(windows.at(i));
+            QVERIFY(win);
+            QCOMPARE(win::caption(win), QString::fromStdString("window " + std::to_string(i)));
+            QCOMPARE(win->transient->lead(), lead);
+        }
+
+        for (auto w : windows) {
+            xcb_destroy_window(c.get(), w);
+        }
+        xcb_flush(c.get());
+    }
+
+    SECTION("event after map request")
+    {
+        // An event following a map request is handled after the window was managed.
+        QSignalSpy window_added_spy(space.qobject.get(), &space::qobject_t::clientAdded);
+        QVERIFY(window_added_spy.isValid());
+
+        auto const w = create_window(QRect(0, 0, 100, 100), "before");
+        xcb_map_window(c.get(), w);
+        xcb_icccm_set_wm_name(c.get(), w, XCB_ATOM_STRING, 8, 5, "after");
+        xcb_flush(c.get());
+
+        QVERIFY(window_added_spy.wait());
+        auto win = get_window(w);
+        QVERIFY(win);
+        QTRY_COMPARE(win::caption(win), QStringLiteral("after"));
+
+        xcb_destroy_window(c.get(), w);
+        xcb_flush(c.get());
+    }
+
+    SECTION("property change after map request")
+    {
+        // Properties changed right after the map request are not lost, although the window is
+        // only managed later on.
+        QSignalSpy window_added_spy(space.qobject.get(), &space::qobject_t::clientAdded);
+        QVERIFY(window_added_spy.isValid());
+
+        auto const lead_id = create_window(QRect(0, 0, 100, 100), "lead");
+        xcb_map_window(c.get(), lead_id);
+        xcb_flush(c.get());
+        QVERIFY(window_added_spy.wait());
+
+        auto lead = get_window(lead_id);
+        QVERIFY(lead);
+
+        auto const w = create_window(QRect(0, 0, 100, 100), "dialog");
+        xcb_map_window(c.get(), w);
+        xcb_icccm_set_wm_transient_for(c.get(), w, lead_id);
+        xcb_flush(c.get());
+
+        QTRY_COMPARE(window_added_spy.count(), 2);
+        auto win = get_window(w);
+        QVERIFY(win);
+        QTRY_COMPARE(win->transient->lead(), lead);
+
+        xcb_destroy_window(c.get(), w);
+        xcb_destroy_window(c.get(), lead_id);
+        xcb_flush(c.get());
+    }
+
+    SECTION("round trips")
+    {
+        // The properties prefetched before managing a window are read without a round trip.
+        QSignalSpy window_removed_spy(space.qobject.get(), &space::qobject_t::clientRemoved);
+        QVERIFY(window_removed_spy.isValid());
+
+        auto const prefetched_id = create_window(QRect(0, 0, 100, 100), "prefetched");
+        auto const fetched_id = create_window(QRect(0, 0, 100, 100), "fetched");
+        base::x11::xcb::sync(c.get());
+
+        auto con = setup.base->x11_data.connection;
+        base::x11::xcb::reply_wait_hook = count_round_trip;
+
+        auto prefetch = win::x11::prefetch_window(space, prefetched_id);
+        reset_round_trips(con);
+        auto prefetched = win::x11::create_controlled_window(*prefetch, false, space);
+        QVERIFY(prefetched);
+        auto const prefetched_round_trips = round_trips;
+
+        reset_round_trips(con);
+        auto fetched = win::x11::create_controlled_window(fetched_id, false, space);
+        QVERIFY(fetched);
+        auto const fetched_round_trips = round_trips;
+
+        base::x11::xcb::reply_wait_hook = nullptr;
+
+        // Client leader, transient, skip close animation, screen edge, normal and motif hints.
+        QVERIFY(fetched_round_trips >= prefetched_round_trips + 6);
+        QCOMPARE(win::caption(prefetched), QStringLiteral("prefetched"));
+        QCOMPARE(win::caption(fetched), QStringLiteral("fetched"));
+
+        xcb_destroy_window(c.get(), prefetched_id);
+        xcb_destroy_window(c.get(), fetched_id);
+        xcb_flush(c.get());
+        QTRY_COMPARE(window_removed_spy.count(), 2);
+    }
+
+    c.reset();
+}
+
+TEST_CASE("x11 map requests benchmark", "[win],[.benchmark]")
+{
+    test::setup setup("x11-map-requests-benchmark", base::operation_mode::xwayland);
+    setup.start();
+
+    auto& space = *setup.base->mod.space;
+    auto c = xcb_connection_create();
+    QVERIFY(!xcb_connection_has_error(c.get()));
+
+    auto const window_count = GENERATE(1, 10, 50);
+
+    BENCHMARK("manage " + std::to_string(window_count) + " windows at once")
+    {
+        QSignalSpy window_added_spy(space.qobject.get(), &space::qobject_t::clientAdded);
+        QSignalSpy window_removed_spy(space.qobject.get(), &space::qobject_t::clientRemoved);
+
+        std::vector<xcb_window_t> windows;
+        for (int i = 0; i < window_count; i++) {
+            windows.push_back(
+                create_named_window(setup, c.get(), QRect(i * 10, i * 10, 100, 100), "window"));
+        }
+        for (auto w : windows) {
+            xcb_map_window(c.get(), w);
+        }
+        xcb_flush(c.get());
+
+        QTRY_COMPARE(window_added_spy.count(), window_count);
+
+        for (auto w : windows) {
+            xcb_destroy_window(c.get(), w);
+        }
+        xcb_flush(c.get());
+
+        QTRY_COMPARE(window_removed_spy.count(), window_count);
+    };
+
+    c.reset();
+}
+
+}
@@ -0,0 +1,251 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "lib/setup.h"
+
+#include <como/win/x11/unmanaged.h>
+#include <como/win/x11/window_find.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <xcb/xcb_icccm.h>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+using x11_window = space::x11_window;
+
+x11_window* create_x11_window(test::setup& setup, xcb_connection_t* c, QRect const& geometry)
+{
+    auto& space = *setup.base->mod.space;
+    auto const w = xcb_generate_id(c);
+    xcb_create_window(c,
+                      XCB_COPY_FROM_PARENT,
+                      w,
+                      setup.base->x11_data.root_window,
+                      geometry.x(),
+                      geometry.y(),
+                      geometry.width(),
+                      geometry.height(),
+                      0,
+                      XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                      XCB_COPY_FROM_PARENT,
+                      0,
+                      nullptr);
+
+    xcb_size_hints_t hints;
+    memset(&hints, 0, sizeof(hints));
+    xcb_icccm_size_hints_set_position(&hints, 1, geometry.x(), geometry.y());
+    xcb_icccm_size_hints_set_size(&hints, 1, geometry.width(), geometry.height());
+    xcb_icccm_set_wm_normal_hints(c, w, &hints);
+    xcb_map_window(c, w);
+    xcb_flush(c);
+
+    QSignalSpy window_added_spy(space.qobject.get(), &space::qobject_t::clientAdded);
+    if (!window_added_spy.wait()) {
+        return nullptr;
+    }
+    return get_x11_window(space.windows_map.at(window_added_spy.first().first().toUInt()));
+}
+
+// Every event is matched against the roles in the same order as when handling X events in the
+// space.
+x11_window* dispatch_event(space& space, xcb_window_t event_window)
+{
+    using win::x11::find_controlled_window;
+    using win::x11::predicate_match;
+
+    for (auto predicate : {predicate_match::window,
+                           predicate_match::wrapper_id,
+                           predicate_match::frame_id,
+                           predicate_match::input_id}) {
+        if (auto win = find_controlled_window<x11_window>(space, predicate, event_window)) {
+            return win;
+        }
+    }
+    return win::x11::find_unmanaged<x11_window>(space, event_window);
+}
+
+}
+
+TEST_CASE("x11 window find", "[win]")
+{
+    using win::x11::find_controlled_window;
+    using win::x11::find_unmanaged;
+    using win::x11::predicate_match;
+
+    test::setup setup("x11-window-find", base::operation_mode::xwayland);
+    setup.start();
+
+    auto& space = *setup.base->mod.space;
+    auto c = xcb_connection_create();
+    QVERIFY(!xcb_connection_has_error(c.get()));
+
+    auto create_window
+        = [&](QRect const& geometry) { return create_x11_window(setup, c.get(), geometry); };
+
+    SECTION("controlled window")
+    {
+        auto window = create_window(QRect(0, 0, 100, 200));
+        QVERIFY(window);
+        QVERIFY(window->control);
+
+        auto const client = window->xcb_windows.client;
+        auto const wrapper = window->xcb_windows.wrapper;
+        auto const frame = window->xcb_windows.outer;
+
+        QCOMPARE(find_controlled_window<x11_window>(space, predicate_match::window, client),
+                 window);
+        QCOMPARE(find_controlled_window<x11_window>(space, predicate_match::wrapper_id, wrapper),
+                 window);
+        QCOMPARE(find_controlled_window<x11_window>(space, predicate_match::frame_id, frame),
+                 window);
+
+        // The XIDs only match their own role.
+        QVERIFY(!find_controlled_window<x11_window>(space, predicate_match::window, frame));
+        QVERIFY(!find_controlled_window<x11_window>(space, predicate_match::frame_id, client));
+        QVERIFY(!find_unmanaged<x11_window>(space, client));
+
+        // After the window is closed its XIDs are not found anymore, also not via its remnant.
+        QSignalSpy closed_spy(window->qobject.get(), &win::window_qobject::closed);
+        QVERIFY(closed_spy.isValid());
+        xcb_unmap_window(c.get(), client);
+        xcb_flush(c.get());
+        QVERIFY(closed_spy.wait());
+
+        QVERIFY(!find_controlled_window<x11_window>(space, predicate_match::window, client));
+        QVERIFY(!find_controlled_window<x11_window>(space, predicate_match::wrapper_id, wrapper));
+        QVERIFY(!find_controlled_window<x11_window>(space, predicate_match::frame_id, frame));
+        QVERIFY(!find_unmanaged<x11_window>(space, client));
+
+        xcb_destroy_window(c.get(), client);
+        xcb_flush(c.get());
+    }
+
+    SECTION("unmanaged window")
+    {
+        uint32_t const values[] = {true};
+        base::x11::xcb::window window(c.get(),
+                                      setup.base->x11_data.root_window,
+                                      QRect(0, 0, 10, 10),
+                                      XCB_CW_OVERRIDE_REDIRECT,
+                                      values);
+
+        QSignalSpy unmanaged_added_spy(space.qobject.get(), &space::qobject_t::unmanagedAdded);
+        QVERIFY(unmanaged_added_spy.isValid());
+        window.map();
+        xcb_flush(c.get());
+        QVERIFY(unmanaged_added_spy.wait());
+
+        auto unmanaged
+            = get_x11_window(space.windows_map.at(unmanaged_added_spy.first().first().toUInt()));
+        QVERIFY(unmanaged);
+        QCOMPARE(find_unmanaged<x11_window>(space, window), unmanaged);
+        QVERIFY(!find_controlled_window<x11_window>(space, predicate_match::window, window));
+
+        QSignalSpy unmanaged_removed_spy(space.qobject.get(), &space::qobject_t::unmanagedRemoved);
+        QVERIFY(unmanaged_removed_spy.isValid());
+        window.unmap();
+        xcb_flush(c.get());
+        QVERIFY(unmanaged_removed_spy.wait());
+
+        QVERIFY(!find_unmanaged<x11_window>(space, window));
+    }
+
+    SECTION("event dispatch")
+    {
+        std::vector<x11_window*> windows;
+        for (int i = 0; i < 10; i++) {
+            auto window = create_window(QRect((i * 7) % 1000, (i * 5) % 800, 100, 100));
+            QVERIFY(window);
+            windows.push_back(window);
+        }
+
+        // Events for windows the compositor does not know about are frequent too.
+        for (auto win : windows) {
+            QCOMPARE(dispatch_event(space, win->xcb_windows.client), win);
+            QCOMPARE(dispatch_event(space, win->xcb_windows.outer), win);
+            QVERIFY(!dispatch_event(space, xcb_generate_id(c.get())));
+        }
+
+        for (auto win : windows) {
+            xcb_destroy_window(c.get(), win->xcb_windows.client);
+        }
+        xcb_flush(c.get());
+    }
+
+    c.reset();
+}
+
+
+TEST_CASE("x11 window find benchmark", "[win],[.benchmark]")
+{
+    test::setup setup("x11-window-find-benchmark", base::operation_mode::xwayland);
+    setup.start();
+
+    auto& space = *setup.base->mod.space;
+    auto c = xcb_connection_create();
+    QVERIFY(!xcb_connection_has_error(c.get()));
+
+    auto const window_count = GENERATE(10, 50, 200);
+
+    std::vector<x11_window*> windows;
+    for (int i = 0; i < window_count; i++) {
+        auto window
+            = create_x11_window(setup, c.get(), QRect((i * 7) % 1000, (i * 5) % 800, 100, 100));
+        QVERIFY(window);
+        windows.push_back(window);
+    }
+
+    std::vector<xcb_window_t> event_windows;
+    for (auto win : windows) {
+        event_windows.push_back(win->xcb_windows.client);
+        event_windows.push_back(win->xcb_windows.outer);
+        event_windows.push_back(xcb_generate_id(c.get()));
+    }
+
+    BENCHMARK("dispatch 1000 events to " + std::to_string(window_count) + " windows")
+    {
+        size_t found{0};
+        for (size_t i = 0; i < 1000; i++) {
+            found += dispatch_event(space, event_windows.at(i % event_windows.size())) != nullptr;
+        }
+        return found;
+    };
+
+    // Property changes on all windows are processed through the full event path.
+    int round{0};
+    BENCHMARK("property notify flood on " + std::to_string(window_count) + " windows")
+    {
+        auto const name = QByteArray("window ") + QByteArray::number(++round);
+
+        QSignalSpy caption_spy(windows.back()->qobject.get(), &win::window_qobject::captionChanged);
+
+        for (auto win : windows) {
+            xcb_change_property(c.get(),
+                                XCB_PROP_MODE_REPLACE,
+                                win->xcb_windows.client,
+                                XCB_ATOM_WM_NAME,
+                                XCB_ATOM_STRING,
+                                8,
+                                name.size(),
+                                name.constData());
+        }
+        xcb_flush(c.get());
+
+        return caption_spy.wait();
+    };
+
+    for (auto win : windows) {
+        xcb_destroy_window(c.get(), win->xcb_windows.client);
+    }
+    xcb_flush(c.get());
+    c.reset();
+}
+
+}
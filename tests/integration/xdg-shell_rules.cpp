@@ -7,13 +7,52 @@ SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "lib/setup.h"
 
+#include <como/win/rules/find.h>
+
 #include <Wrapland/Client/surface.h>
 #include <Wrapland/Client/xdg_shell.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <linux/input.h>
 
 namespace como::detail::test
 {
 
+/// Rules for many different applications. Only few of them apply to a single window.
+void write_many_rules(KSharedConfigPtr const& config, int count)
+{
+    for (int i = 0; i < count; i++) {
+        auto group = config->group(QString::number(i + 1));
+        group.deleteGroup();
+
+        auto const app = QStringLiteral("org.kde.app%1").arg(i);
+        group.writeEntry("above", true);
+        group.writeEntry("aboverule", enum_index(win::rules::action::force));
+
+        switch (i % 4) {
+        case 0:
+            group.writeEntry("wmclass", app);
+            group.writeEntry("wmclassmatch", enum_index(win::rules::name_match::exact));
+            break;
+        case 1:
+            group.writeEntry("wmclass", app + QStringLiteral(" ") + app);
+            group.writeEntry("wmclasscomplete", true);
+            group.writeEntry("wmclassmatch", enum_index(win::rules::name_match::exact));
+            break;
+        case 2:
+            group.writeEntry("wmclass", QStringLiteral("^org\\.kde\\.app%1$").arg(i));
+            group.writeEntry("wmclassmatch", enum_index(win::rules::name_match::regex));
+            break;
+        case 3:
+            group.writeEntry("title", QStringLiteral("^Document %1 - .*$").arg(i));
+            group.writeEntry("titlematch", enum_index(win::rules::name_match::regex));
+            break;
+        }
+    }
+
+    config->group(QStringLiteral("General")).writeEntry("count", count);
+    config->sync();
+}
+
 TEST_CASE("xdg-shell rules", "[win]")
 {
     test::setup setup("xdg-shell-rules");
@@ -4147,6 +4186,59 @@ TEST_CASE("xdg-shell rules", "[win]")
         QVERIFY(desktopFileNameSpy.wait());
         QCOMPARE(c->control->keep_above, true);
     }
+
+    SECTION("many rules")
+    {
+        auto config = setup.base->config.main;
+        int const count = 500;
+
+        write_many_rules(config, count);
+
+        setup.base->mod.space->rule_book->settings->setSharedConfig(config);
+        win::space_reconfigure(*setup.base->mod.space);
+        REQUIRE(setup.base->mod.space->rule_book->m_rules.size() == count);
+
+        auto [client, surface, shellSurface] = createWindow(QByteArrayLiteral("org.kde.app8"));
+        QVERIFY(client);
+        QCOMPARE(client->control->keep_above, true);
+
+        auto& book = *setup.base->mod.space->rule_book;
+        REQUIRE(win::rules::find_window(book, *client).contains(book.m_rules.at(8)));
+        REQUIRE(!win::rules::find_window(book, *client).contains(book.m_rules.at(4)));
+
+        shellSurface.reset();
+        surface.reset();
+        QVERIFY(wait_for_destroyed(client));
+    }
+}
+
+TEST_CASE("xdg-shell rules benchmark", "[win],[.benchmark]")
+{
+    test::setup setup("xdg-shell-rules-benchmark");
+    setup.start();
+    setup_wayland_connection();
+
+    auto config = setup.base->config.main;
+    int const count = 500;
+    write_many_rules(config, count);
+
+    auto& book = *setup.base->mod.space->rule_book;
+    book.settings->setSharedConfig(config);
+    win::space_reconfigure(*setup.base->mod.space);
+    REQUIRE(book.m_rules.size() == count);
+
+    auto surface = create_surface();
+    auto toplevel = create_xdg_shell_toplevel(surface, CreationSetup::CreateOnly);
+    toplevel->setAppId(QByteArrayLiteral("org.kde.app8"));
+    init_xdg_shell_toplevel(surface, toplevel);
+
+    auto client = render_and_wait_for_shown(surface, QSize(100, 50), Qt::blue);
+    REQUIRE(client);
+
+    BENCHMARK("find rules of window (" + std::to_string(count) + " rules)")
+    {
+        return win::rules::find_window(book, *client);
+    };
 }
 
 }
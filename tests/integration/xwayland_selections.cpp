@@ -6,9 +6,14 @@ SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "lib/setup.h"
 
+#include <como/xwl/transfer.h>
+
+#include <QElapsedTimer>
 #include <QProcess>
 #include <QProcessEnvironment>
 #include <catch2/generators/catch_generators.hpp>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace como::detail::test
 {
@@ -167,6 +172,177 @@ TEST_CASE("xwayland selections", "[win],[xwl]")
             paste_process = nullptr;
         }
     }
+
+    SECTION("wayland to x11 transfer above read ahead")
+    {
+        // Verifies that reading from the Wayland source pauses while the X requestor lags behind
+        // and that all data arrives once it takes the chunks.
+        auto con = xcb_connection_create();
+        auto const& atoms = *setup.base->mod.space->atoms;
+
+        auto const requestor = xcb_generate_id(con.get());
+        xcb_create_window(con.get(),
+                          XCB_COPY_FROM_PARENT,
+                          requestor,
+                          setup.base->x11_data.root_window,
+                          0,
+                          0,
+                          10,
+                          10,
+                          0,
+                          XCB_WINDOW_CLASS_INPUT_OUTPUT,
+                          XCB_COPY_FROM_PARENT,
+                          0,
+                          nullptr);
+
+        auto const property_name = QByteArrayLiteral("COMO_TEST_TRANSFER");
+        auto atom_reply = xcb_intern_atom_reply(
+            con.get(),
+            xcb_intern_atom(con.get(), false, property_name.size(), property_name.constData()),
+            nullptr);
+        REQUIRE(atom_reply);
+        auto const property = atom_reply->atom;
+        free(atom_reply);
+
+        auto request = new xcb_selection_request_event_t{};
+        request->requestor = requestor;
+        request->selection = atoms.clipboard;
+        request->target = XCB_ATOM_STRING;
+        request->property = property;
+        request->time = XCB_CURRENT_TIME;
+
+        int fds[2];
+        REQUIRE(pipe2(fds, O_CLOEXEC) == 0);
+        REQUIRE(fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+        auto const pipe_capacity = fcntl(fds[1], F_GETPIPE_SZ);
+        REQUIRE(pipe_capacity > 0);
+
+        xwl::x11_runtime x11;
+        x11.connection = con.get();
+        x11.screen = xcb_setup_roots_iterator(xcb_get_setup(con.get())).data;
+        x11.atoms = setup.base->mod.space->atoms.get();
+
+        auto transfer
+            = std::make_unique<xwl::wl_to_x11_transfer>(atoms.clipboard, request, fds[0], x11);
+        QSignalSpy finished_spy(transfer.get(), &xwl::transfer::finished);
+        QVERIFY(finished_spy.isValid());
+
+        auto const max_read_ahead = transfer->max_read_ahead;
+        QByteArray payload(static_cast<qsizetype>(3 * max_read_ahead), Qt::Uninitialized);
+        for (int i = 0; i < payload.size(); i++) {
+            payload[i] = static_cast<char>(i % 251);
+        }
+
+        size_t written{0};
+        auto write_source = [&] {
+            while (written < static_cast<size_t>(payload.size())) {
+                auto const len
+                    = write(fds[1], payload.constData() + written, payload.size() - written);
+                if (len <= 0) {
+                    return;
+                }
+                written += len;
+            }
+            if (fds[1] >= 0) {
+                close(fds[1]);
+                fds[1] = -1;
+            }
+        };
+
+        auto drain_events = [&] {
+            while (auto event = xcb_poll_for_event(con.get())) {
+                free(event);
+            }
+        };
+
+        // Takes the property from the requestor like an X client does.
+        auto take_property = [&](xcb_atom_t& type) {
+            auto reply = xcb_get_property_reply(
+                con.get(),
+                xcb_get_property(
+                    con.get(), true, requestor, property, XCB_GET_PROPERTY_TYPE_ANY, 0, 0x1fffffff),
+                nullptr);
+            REQUIRE(reply);
+            type = reply->type;
+            auto data = QByteArray(static_cast<char const*>(xcb_get_property_value(reply)),
+                                   xcb_get_property_value_length(reply));
+            free(reply);
+            return data;
+        };
+
+        auto notify_delete = [&] {
+            xcb_property_notify_event_t event{};
+            event.response_type = XCB_PROPERTY_NOTIFY;
+            event.window = requestor;
+            event.atom = property;
+            event.state = XCB_PROPERTY_DELETE;
+            REQUIRE(transfer->handle_property_notify(&event));
+        };
+
+        transfer->start_transfer_from_source();
+
+        auto spin = [&] {
+            for (int i = 0; i < 20; i++) {
+                write_source();
+                QCoreApplication::processEvents();
+                QTest::qWait(5);
+            }
+        };
+
+        // The requestor does not take anything yet. Reading pauses at the read ahead limit.
+        spin();
+        auto const paused_at = written;
+        REQUIRE(paused_at > max_read_ahead);
+        REQUIRE(paused_at <= max_read_ahead + 1024 * 1024 + pipe_capacity);
+
+        spin();
+        REQUIRE(written == paused_at);
+
+        // The first property announces the incremental transfer.
+        xcb_atom_t type{XCB_ATOM_NONE};
+        take_property(type);
+        REQUIRE(type == atoms.incr);
+        notify_delete();
+
+        QByteArray received;
+        bool done{false};
+
+        QElapsedTimer timer;
+        timer.start();
+
+        while (!done) {
+            REQUIRE(timer.elapsed() < 10000);
+            write_source();
+            QCoreApplication::processEvents();
+            drain_events();
+
+            auto data = take_property(type);
+            if (type == XCB_ATOM_NONE) {
+                // The next chunk is not yet read from the source.
+                QTest::qWait(1);
+                continue;
+            }
+
+            REQUIRE(type == XCB_ATOM_STRING);
+            if (data.isEmpty()) {
+                // A property without data completes the transfer.
+                done = true;
+                continue;
+            }
+
+            received += data;
+            notify_delete();
+        }
+
+        REQUIRE(written == static_cast<size_t>(payload.size()));
+        REQUIRE(received.size() == payload.size());
+        REQUIRE(received == payload);
+        QTRY_COMPARE(finished_spy.count(), 1);
+
+        transfer.reset();
+        xcb_destroy_window(con.get(), requestor);
+        xcb_flush(con.get());
+    }
 }
 
 }
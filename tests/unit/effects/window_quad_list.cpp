@@ -8,7 +8,11 @@ SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "como/render/effect/interface/window_quad.h"
 
+#include <QMatrix4x4>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <cstring>
+#include <vector>
 
 namespace como::detail::test
 {
@@ -27,6 +31,42 @@ WindowQuad makeQuad(QRectF const& r)
     return quad;
 }
 
+// From the OpenGL headers, which we don't include here.
+constexpr unsigned int gl_triangles = 0x0004;
+constexpr unsigned int gl_quads = 0x0007;
+
+/// Computes the vertices like the scalar code path does.
+std::vector<GLVertex2D>
+get_reference_vertices(WindowQuadList const& quads, bool triangles, QMatrix4x4 const& matrix)
+{
+    QVector2D const coeff(matrix(0, 0), matrix(1, 1));
+    QVector2D const offset(matrix(0, 3), matrix(1, 3));
+
+    std::vector<GLVertex2D> vertices;
+    for (auto const& quad : quads) {
+        GLVertex2D v[4];
+        for (int j = 0; j < 4; j++) {
+            v[j].position = QVector2D(quad[j].x(), quad[j].y());
+            v[j].texcoord = QVector2D(quad[j].u(), quad[j].v()) * coeff + offset;
+        }
+
+        if (triangles) {
+            for (auto j : {1, 0, 3, 3, 2, 1}) {
+                vertices.push_back(v[j]);
+            }
+        } else {
+            vertices.insert(vertices.end(), v, v + 4);
+        }
+    }
+    return vertices;
+}
+
+bool same_vertices(std::vector<GLVertex2D> const& first, std::vector<GLVertex2D> const& second)
+{
+    return first.size() == second.size()
+        && std::memcmp(first.data(), second.data(), first.size() * sizeof(GLVertex2D)) == 0;
+}
+
 }
 
 TEST_CASE("window quad list", "[effect],[unit]")
@@ -202,6 +242,84 @@ TEST_CASE("window quad list", "[effect],[unit]")
             REQUIRE(found);
         }
     }
+
+    SECTION("interleaved arrays")
+    {
+        WindowQuadList quads;
+        quads.append(makeQuad(QRectF(0, 0, 10, 20)));
+        quads.append(makeQuad(QRectF(10, 0, 30, 20)));
+        quads.append(makeQuad(QRectF(0, 20, 40, 5.5)));
+
+        QMatrix4x4 matrix;
+        matrix.translate(0.5, 0.25);
+        matrix.scale(1. / 64, 1. / 32);
+
+        auto get_texcoord = [](WindowVertex const& vertex) {
+            return QVector2D(vertex.u() / 64 + 0.5, vertex.v() / 32 + 0.25);
+        };
+
+        std::vector<GLVertex2D> vertices(quads.size() * 4);
+        quads.makeInterleavedArrays(gl_quads, vertices, matrix);
+
+        for (int i = 0; i < quads.size(); i++) {
+            for (int j = 0; j < 4; j++) {
+                auto const& vertex = vertices.at(i * 4 + j);
+                REQUIRE(vertex.position == QVector2D(quads[i][j].x(), quads[i][j].y()));
+                REQUIRE(vertex.texcoord == get_texcoord(quads[i][j]));
+            }
+        }
+
+        std::vector<GLVertex2D> triangles(quads.size() * 6);
+        quads.makeInterleavedArrays(gl_triangles, triangles, matrix);
+
+        // Two triangles per quad starting at the top-right vertex.
+        for (int i = 0; i < quads.size(); i++) {
+            auto const order = {1, 0, 3, 3, 2, 1};
+            int index = i * 6;
+            for (auto j : order) {
+                REQUIRE(triangles.at(index++).position
+                        == QVector2D(quads[i][j].x(), quads[i][j].y()));
+            }
+        }
+
+        // The code path selected for the CPU produces the same floats as the scalar one.
+        auto const type = GENERATE(gl_quads, gl_triangles);
+
+        quads = quads.makeGrid(3);
+        auto const reference = get_reference_vertices(quads, type == gl_triangles, matrix);
+        std::vector<GLVertex2D> result(reference.size());
+        quads.makeInterleavedArrays(type, result, matrix);
+        REQUIRE(same_vertices(reference, result));
+    }
+}
+
+TEST_CASE("window quad list benchmark", "[effect],[unit],[.benchmark]")
+{
+    // A maximized window with wobbly windows or magic lamp.
+    WindowQuadList quads;
+    quads.append(makeQuad(QRectF(0, 0, 1920, 1080)));
+
+    QMatrix4x4 matrix;
+    matrix.scale(1. / 1920, 1. / 1080);
+
+    BENCHMARK("make grid")
+    {
+        return quads.makeGrid(16).size();
+    };
+
+    BENCHMARK("make regular grid")
+    {
+        return quads.makeRegularGrid(120, 68).size();
+    };
+
+    auto const grid = quads.makeGrid(16);
+    std::vector<GLVertex2D> vertices(grid.size() * 6);
+
+    BENCHMARK("interleaved arrays (" + std::to_string(grid.size()) + " quads)")
+    {
+        grid.makeInterleavedArrays(gl_triangles, vertices, matrix);
+        return vertices.back().position.x();
+    };
 }
 
 }
@@ -0,0 +1,107 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/input/event_queue.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <thread>
+
+namespace como::detail::test
+{
+
+TEST_CASE("event queue", "[input],[unit]")
+{
+    SECTION("order")
+    {
+        input::event_queue<int, 4> queue;
+        REQUIRE(queue.empty());
+        REQUIRE(!queue.pop());
+
+        REQUIRE(queue.push(1));
+        REQUIRE(queue.push(2));
+        REQUIRE(!queue.empty());
+        REQUIRE(queue.pop() == 1);
+
+        REQUIRE(queue.push(3));
+        REQUIRE(queue.push(4));
+        REQUIRE(queue.push(5));
+
+        // The queue is full now.
+        REQUIRE(!queue.push(6));
+
+        REQUIRE(queue.pop() == 2);
+        REQUIRE(queue.pop() == 3);
+        REQUIRE(queue.pop() == 4);
+        REQUIRE(queue.pop() == 5);
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("wrap around")
+    {
+        // Events stay in order while the ring buffer wraps around many times.
+        input::event_queue<uint32_t, 4> queue;
+        uint32_t expected{0};
+
+        for (uint32_t i = 0; i < 100; i++) {
+            REQUIRE(queue.push(3 * i));
+            REQUIRE(queue.push(3 * i + 1));
+            REQUIRE(queue.push(3 * i + 2));
+            REQUIRE(*queue.front() == expected);
+            REQUIRE(queue.pop() == expected++);
+            REQUIRE(queue.pop() == expected++);
+            REQUIRE(queue.pop() == expected++);
+        }
+
+        REQUIRE(queue.empty());
+        REQUIRE(!queue.front());
+    }
+
+    SECTION("producer thread")
+    {
+        // All events pushed from another thread arrive once and in order.
+        constexpr uint32_t count{100000};
+        input::event_queue<uint32_t, 64> queue;
+
+        std::thread producer([&] {
+            for (uint32_t i = 0; i < count; i++) {
+                while (!queue.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint32_t expected{0};
+        while (expected < count) {
+            if (auto event = queue.pop()) {
+                REQUIRE(*event == expected);
+                expected++;
+            }
+        }
+
+        producer.join();
+        REQUIRE(queue.empty());
+    }
+}
+
+TEST_CASE("event queue benchmark", "[input],[unit],[.benchmark]")
+{
+    input::event_queue<uint64_t, 256> queue;
+
+    BENCHMARK("push and pop 256 events")
+    {
+        for (uint64_t i = 0; i < 256; i++) {
+            queue.push(i);
+        }
+        uint64_t sum{0};
+        while (auto event = queue.pop()) {
+            sum += *event;
+        }
+        return sum;
+    };
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/render/frame_timing.h"
+
+using namespace std::chrono_literals;
+
+namespace como::detail::test
+{
+
+TEST_CASE("frame timing", "[render],[unit]")
+{
+    SECTION("empty ring")
+    {
+        render::duration_ring<8> ring;
+        REQUIRE(ring.size() == 0);
+        REQUIRE(ring.max() == 0ns);
+        REQUIRE(ring.percentile(95) == 0ns);
+        REQUIRE(get_duration_stats(ring).count == 0);
+    }
+
+    SECTION("wrap around")
+    {
+        render::duration_ring<8> ring;
+        for (int i = 1; i <= 20; i++) {
+            ring.add(std::chrono::milliseconds(i));
+        }
+
+        REQUIRE(ring.size() == 8);
+        REQUIRE(ring.total() == 20);
+
+        auto const values = ring.snapshot();
+        REQUIRE(values.size() == 8);
+        REQUIRE(values.front() == 13ms);
+        REQUIRE(values.back() == 20ms);
+        REQUIRE(ring.max() == 20ms);
+    }
+
+    SECTION("single outlier is dropped")
+    {
+        render::duration_ring<8> ring;
+        ring.add(50ms);
+        REQUIRE(ring.max() == 50ms);
+
+        for (int i = 0; i < 8; i++) {
+            ring.add(2ms);
+        }
+        REQUIRE(ring.max() == 2ms);
+    }
+
+    SECTION("percentiles")
+    {
+        render::duration_ring<128> ring;
+        for (int i = 1; i <= 100; i++) {
+            ring.add(std::chrono::microseconds(i));
+        }
+
+        REQUIRE(ring.percentile(0) == 1us);
+        REQUIRE(ring.percentile(100) == 100us);
+        REQUIRE(ring.percentile(50) == 51us);
+
+        auto const stats = get_duration_stats(ring);
+        REQUIRE(stats.count == 100);
+        REQUIRE(stats.min == 1us);
+        REQUIRE(stats.max == 100us);
+        REQUIRE(stats.p50 == ring.percentile(50));
+        REQUIRE(stats.p95 == ring.percentile(95));
+        REQUIRE(stats.p99 == ring.percentile(99));
+        REQUIRE(stats.mean == 50500ns);
+    }
+}
+
+}
@@ -0,0 +1,137 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/input/wayland/motion_queue.h"
+
+#include <array>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+struct motion_recorder {
+    void process_motion(input::motion_event const& event)
+    {
+        motions.push_back({event.base.dev, event.delta});
+    }
+
+    void process_motion_absolute(input::motion_absolute_event const& event)
+    {
+        motions.push_back({event.base.dev, event.pos});
+    }
+
+    std::vector<std::pair<input::pointer*, QPointF>> motions;
+};
+
+}
+
+TEST_CASE("motion queue", "[input],[unit]")
+{
+    // The devices are only compared, never dereferenced.
+    std::array<char, 3> storage;
+    auto dev1 = reinterpret_cast<input::pointer*>(&storage[0]);
+    auto dev2 = reinterpret_cast<input::pointer*>(&storage[1]);
+    auto unknown = reinterpret_cast<input::pointer*>(&storage[2]);
+
+    motion_recorder recorder;
+    input::wayland::motion_queue<motion_recorder> queue(recorder);
+    queue.add_device(dev1);
+    queue.add_device(dev2);
+
+    auto move = [&](input::pointer* dev, QPointF const& delta) {
+        queue.push(input::motion_event{delta, delta, {dev, 0}});
+    };
+
+    SECTION("coalesce")
+    {
+        move(dev1, QPointF(1, 2));
+        move(dev1, QPointF(3, 4));
+        queue.push(input::motion_absolute_event{QPointF(10, 10), {dev1, 0}});
+        queue.push(input::motion_absolute_event{QPointF(20, 20), {dev1, 0}});
+        REQUIRE(!queue.empty());
+        REQUIRE(recorder.motions.empty());
+
+        queue.flush();
+        REQUIRE(queue.empty());
+        REQUIRE(recorder.motions.size() == 2);
+        REQUIRE(recorder.motions.at(0) == std::pair{dev1, QPointF(4, 6)});
+        REQUIRE(recorder.motions.at(1) == std::pair{dev1, QPointF(20, 20)});
+    }
+
+    SECTION("order across devices")
+    {
+        // Each device has its own queue. The motions are still processed in the order they came in.
+        move(dev1, QPointF(1, 0));
+        move(dev2, QPointF(2, 0));
+        move(dev2, QPointF(3, 0));
+        move(dev1, QPointF(4, 0));
+
+        queue.flush();
+        REQUIRE(recorder.motions.size() == 3);
+        REQUIRE(recorder.motions.at(0) == std::pair{dev1, QPointF(1, 0)});
+        REQUIRE(recorder.motions.at(1) == std::pair{dev2, QPointF(5, 0)});
+        REQUIRE(recorder.motions.at(2) == std::pair{dev1, QPointF(4, 0)});
+    }
+
+    SECTION("unknown device")
+    {
+        // Queued motions are processed first and the motion of the unknown device right away.
+        move(dev1, QPointF(1, 0));
+        move(unknown, QPointF(2, 0));
+        REQUIRE(queue.empty());
+        REQUIRE(recorder.motions.size() == 2);
+        REQUIRE(recorder.motions.at(1) == std::pair{unknown, QPointF(2, 0)});
+    }
+
+    SECTION("removed device")
+    {
+        move(dev1, QPointF(1, 0));
+        move(dev2, QPointF(2, 0));
+        queue.remove_device(dev2);
+
+        queue.flush();
+        REQUIRE(recorder.motions.size() == 1);
+        REQUIRE(recorder.motions.at(0) == std::pair{dev1, QPointF(1, 0)});
+    }
+
+    SECTION("producer thread")
+    {
+        // Motions pushed from another thread are processed once while the queue is flushed.
+        constexpr int count{200};
+
+        std::thread producer([&] {
+            for (int i = 0; i < count; i++) {
+                move(dev1, QPointF(1, 0));
+            }
+        });
+
+        QPointF sum;
+        auto add_processed = [&] {
+            for (auto const& motion : recorder.motions) {
+                sum += motion.second;
+            }
+            recorder.motions.clear();
+        };
+
+        while (sum.x() < count) {
+            queue.flush();
+            add_processed();
+        }
+
+        producer.join();
+        queue.flush();
+        add_processed();
+        REQUIRE(sum == QPointF(count, 0));
+    }
+}
+
+}
@@ -0,0 +1,280 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/render/region.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random>
+#include <vector>
+
+namespace como::detail::test
+{
+
+namespace
+{
+
+bool same_pixels(render::region const& reg, QRegion const& qregion)
+{
+    return reg.to_qregion().xored(qregion).isEmpty();
+}
+
+QRegion get_random_region(std::mt19937& gen, int rect_count)
+{
+    std::uniform_int_distribution<int> pos(0, 200);
+    std::uniform_int_distribution<int> size(1, 60);
+
+    QRegion ret;
+    for (int i = 0; i < rect_count; i++) {
+        ret += QRect(pos(gen), pos(gen), size(gen), size(gen));
+    }
+    return ret;
+}
+
+// A window of a frame as seen by the occlusion culling.
+struct trace_window {
+    QRegion damage;
+    QRegion clip;
+    bool translucent;
+};
+
+// Rounded corners of opaque windows split their clips into many rects.
+QRegion get_rounded_rect(QRect const& rect, int radius)
+{
+    QRegion ret(rect.adjusted(0, radius, 0, -radius));
+    for (int i = 0; i < radius; i++) {
+        auto const inset = radius - i;
+        ret += QRect(rect.left() + inset, rect.top() + i, rect.width() - 2 * inset, 1);
+        ret += QRect(rect.left() + inset, rect.bottom() - i, rect.width() - 2 * inset, 1);
+    }
+    return ret;
+}
+
+/**
+ * Frames of a desktop session with overlapping windows, a translucent panel and small damage like
+ * from text input and a blinking cursor spread over several windows.
+ */
+std::vector<std::vector<trace_window>> get_damage_trace(int frame_count)
+{
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> glyph_x(0, 1900);
+    std::uniform_int_distribution<int> glyph_y(0, 1060);
+
+    std::vector<std::vector<trace_window>> frames;
+
+    for (int frame = 0; frame < frame_count; frame++) {
+        std::vector<trace_window> windows;
+
+        // The desktop background.
+        windows.push_back({{}, QRegion(0, 0, 1920, 1080), false});
+
+        for (int i = 0; i < 10; i++) {
+            auto const geo = QRect(60 + i * 110, 40 + i * 70, 800, 600);
+
+            QRegion damage;
+            if ((frame + i) % 3 == 0) {
+                for (int glyph = 0; glyph < 6; glyph++) {
+                    damage += QRect(geo.left() + (glyph_x(gen) % 780),
+                                    geo.top() + (glyph_y(gen) % 580),
+                                    9,
+                                    18);
+                }
+            }
+
+            auto const translucent = i % 4 == 3;
+            windows.push_back(
+                {damage, translucent ? QRegion() : get_rounded_rect(geo, 8), translucent});
+        }
+
+        // The panel and a blinking cursor in it.
+        windows.push_back({QRegion(1800, 1050, 2, 18), QRegion(), true});
+        frames.push_back(std::move(windows));
+    }
+
+    return frames;
+}
+
+QRegion cull_with_qregion(std::vector<trace_window> const& windows, QRegion const& repaint)
+{
+    QRegion allclips;
+    QRegion upper_translucent_damage = repaint;
+    std::vector<QRegion> regions(windows.size());
+
+    for (int i = static_cast<int>(windows.size()) - 1; i >= 0; --i) {
+        auto const& win = windows.at(i);
+        regions[i] = win.damage | upper_translucent_damage;
+        regions[i] -= allclips;
+
+        if (!win.clip.isEmpty() && !win.translucent) {
+            allclips |= win.clip;
+            upper_translucent_damage |= regions[i] - win.clip;
+        } else {
+            upper_translucent_damage |= regions[i];
+        }
+    }
+
+    QRegion painted;
+    for (auto const& reg : regions) {
+        painted |= reg;
+    }
+    return painted;
+}
+
+QRegion cull_with_region(std::vector<trace_window> const& windows, QRegion const& repaint)
+{
+    render::region allclips;
+    render::region upper_translucent_damage(repaint);
+    render::region clip;
+    render::region remainder;
+    std::vector<render::region> regions(windows.size());
+
+    for (int i = static_cast<int>(windows.size()) - 1; i >= 0; --i) {
+        auto const& win = windows.at(i);
+        regions[i].assign(win.damage);
+        regions[i] |= upper_translucent_damage;
+        regions[i] -= allclips;
+
+        if (!win.clip.isEmpty() && !win.translucent) {
+            clip.assign(win.clip);
+            allclips |= clip;
+            render::region::subtract(regions[i], clip, remainder);
+            upper_translucent_damage |= remainder;
+        } else {
+            upper_translucent_damage |= regions[i];
+        }
+    }
+
+    render::region painted;
+    for (auto const& reg : regions) {
+        painted |= reg;
+    }
+    return painted.to_qregion();
+}
+
+}
+
+TEST_CASE("region", "[render],[unit]")
+{
+    SECTION("empty")
+    {
+        render::region reg;
+        REQUIRE(reg.is_empty());
+        REQUIRE(reg.bounding_rect().isNull());
+        REQUIRE(reg.to_qregion().isEmpty());
+
+        reg.assign(QRect(10, 10, 0, 5));
+        REQUIRE(reg.is_empty());
+    }
+
+    SECTION("canonical representation")
+    {
+        // Two rects forming a single one are merged.
+        render::region reg(QRect(0, 0, 10, 10));
+        reg |= render::region(QRect(10, 0, 10, 10));
+        REQUIRE(reg.rect_count() == 1);
+        REQUIRE(reg == render::region(QRect(0, 0, 20, 10)));
+
+        reg |= render::region(QRect(0, 10, 20, 5));
+        REQUIRE(reg.rect_count() == 1);
+        REQUIRE(reg.bounding_rect() == QRect(0, 0, 20, 15));
+
+        reg -= render::region(QRect(5, 5, 10, 5));
+        REQUIRE(reg.rect_count() == 4);
+        REQUIRE(same_pixels(reg, QRegion(0, 0, 20, 15) - QRegion(5, 5, 10, 5)));
+
+        reg |= render::region(QRect(5, 5, 10, 5));
+        REQUIRE(reg == render::region(QRect(0, 0, 20, 15)));
+    }
+
+    SECTION("conversion")
+    {
+        auto const qregion = QRegion(0, 0, 100, 100) - QRegion(20, 20, 10, 60);
+        render::region const reg(qregion);
+        REQUIRE(reg.rect_count() == 4);
+        REQUIRE(same_pixels(reg, qregion));
+    }
+
+    SECTION("heap buffer")
+    {
+        render::region reg;
+        QRegion qregion;
+        for (int i = 0; i < 40; i++) {
+            reg |= render::region(QRect(i * 10, i * 10, 5, 5));
+            qregion += QRect(i * 10, i * 10, 5, 5);
+        }
+        REQUIRE(reg.rect_count() == 40);
+        REQUIRE(same_pixels(reg, qregion));
+
+        auto copy = reg;
+        render::region small(QRect(0, 0, 1, 1));
+        copy.swap(small);
+        REQUIRE(copy == render::region(QRect(0, 0, 1, 1)));
+        REQUIRE(small == reg);
+
+        reg.clear();
+        REQUIRE(reg.is_empty());
+    }
+
+    SECTION("matches qregion")
+    {
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<int> count(0, 12);
+
+        for (int i = 0; i < 500; i++) {
+            auto const qa = get_random_region(gen, count(gen));
+            auto const qb = get_random_region(gen, count(gen));
+            render::region const a(qa);
+            render::region const b(qb);
+
+            REQUIRE(same_pixels(a, qa));
+            REQUIRE(same_pixels(a | b, qa | qb));
+            REQUIRE(same_pixels(a - b, qa - qb));
+            REQUIRE(same_pixels(a & b, qa & qb));
+            REQUIRE(a.bounding_rect() == qa.boundingRect());
+
+            render::region out;
+            render::region::subtract(a, b, out);
+            REQUIRE(out == a - b);
+        }
+    }
+
+    SECTION("occlusion culling trace")
+    {
+        auto const trace = get_damage_trace(60);
+        auto const repaint = QRegion(0, 0, 1920, 30);
+
+        for (auto const& frame : trace) {
+            auto const painted = cull_with_qregion(frame, repaint);
+            REQUIRE(cull_with_region(frame, repaint).xored(painted).isEmpty());
+        }
+    }
+}
+
+TEST_CASE("region benchmark", "[render],[unit],[.benchmark]")
+{
+    auto const trace = get_damage_trace(60);
+    auto const repaint = QRegion(0, 0, 1920, 30);
+
+    BENCHMARK("qregion")
+    {
+        int count{0};
+        for (auto const& frame : trace) {
+            count += cull_with_qregion(frame, repaint).rectCount();
+        }
+        return count;
+    };
+
+    BENCHMARK("region")
+    {
+        int count{0};
+        for (auto const& frame : trace) {
+            count += cull_with_region(frame, repaint).rectCount();
+        }
+        return count;
+    };
+}
+
+}
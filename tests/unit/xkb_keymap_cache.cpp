@@ -0,0 +1,200 @@
+/*
+SPDX-FileCopyrightText: 2026 Roman Gilg <subdiff@gmail.com>
+
+SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../integration/lib/catch_macros.h"
+
+#include "como/input/xkb/keymap_cache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xkbcommon/xkbcommon.h>
+
+namespace como::detail::test
+{
+
+TEST_CASE("xkb keymap cache", "[input],[unit]")
+{
+    auto context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+    REQUIRE(context);
+
+    QTemporaryDir cache_dir;
+    REQUIRE(cache_dir.isValid());
+
+    auto cache_files = [&] { return QDir(cache_dir.path()).entryList(QDir::Files); };
+
+    xkb_rule_names const names = {.rules = "evdev",
+                                  .model = "pc104",
+                                  .layout = "us,de",
+                                  .variant = ",nodeadkeys",
+                                  .options = "grp:alt_shift_toggle"};
+
+    auto compiled = [&] {
+        input::xkb::keymap_cache cache;
+        cache.set_directory(cache_dir.path());
+
+        auto keymap = cache.get(context, names);
+        REQUIRE(keymap);
+
+        // Keymaps are shared while they are in memory.
+        REQUIRE(cache.get(context, names) == keymap);
+        return std::string(keymap->cache);
+    }();
+
+    // Pending writes are finished when the cache is destroyed.
+    REQUIRE(cache_files().size() == 1);
+
+    SECTION("cached keymap")
+    {
+        {
+            input::xkb::keymap_cache cache;
+            cache.set_directory(cache_dir.path());
+
+            auto keymap = cache.get(context, names);
+            REQUIRE(keymap);
+            REQUIRE(std::string(keymap->cache) == compiled);
+            REQUIRE(xkb_keymap_num_layouts(keymap->raw) == 2);
+
+            // Other rule names are cached separately.
+            auto other_names = names;
+            other_names.layout = "us";
+            other_names.variant = "";
+            REQUIRE(cache.get(context, other_names));
+        }
+
+        REQUIRE(cache_files().size() == 2);
+    }
+
+    SECTION("invalid cache file")
+    {
+        for (auto const& name : cache_files()) {
+            QFile file(QDir(cache_dir.path()).filePath(name));
+            REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+            file.write("garbage");
+        }
+
+        {
+            input::xkb::keymap_cache cache;
+            cache.set_directory(cache_dir.path());
+
+            // The keymap is compiled again and the file replaced.
+            auto keymap = cache.get(context, names);
+            REQUIRE(keymap);
+            REQUIRE(std::string(keymap->cache) == compiled);
+        }
+
+        input::xkb::keymap_cache cache;
+        cache.set_directory(cache_dir.path());
+        REQUIRE(std::string(cache.get(context, names)->cache) == compiled);
+    }
+
+    SECTION("invalid rules")
+    {
+        input::xkb::keymap_cache cache;
+        cache.set_directory(cache_dir.path());
+
+        auto invalid_names = names;
+        invalid_names.rules = "no";
+        REQUIRE(!cache.get(context, invalid_names));
+    }
+
+    SECTION("stale files")
+    {
+        // Left behind by an earlier configuration or xkeyboard-config version.
+        QFile stale(QDir(cache_dir.path()).filePath(QStringLiteral("0123456789abcdef")));
+        REQUIRE(stale.open(QIODevice::WriteOnly));
+        stale.write("stale");
+        stale.close();
+        REQUIRE(cache_files().size() == 2);
+
+        {
+            input::xkb::keymap_cache cache;
+            cache.set_directory(cache_dir.path());
+
+            // Loading a cached keymap does not touch other files.
+            REQUIRE(cache.get(context, names));
+            REQUIRE(cache_files().size() == 2);
+
+            auto other_names = names;
+            other_names.layout = "us";
+            other_names.variant = "";
+            REQUIRE(cache.get(context, other_names));
+        }
+
+        // After compiling only files of keymaps in use are left.
+        REQUIRE(cache_files().size() == 2);
+        REQUIRE(!stale.exists());
+    }
+
+    SECTION("memory eviction")
+    {
+        input::xkb::keymap_cache cache;
+        cache.set_directory({});
+
+        auto const first = cache.get(context, names);
+        REQUIRE(first);
+
+        auto get_layout = [&](char const* layout) {
+            auto other_names = names;
+            other_names.layout = layout;
+            other_names.variant = "";
+            return cache.get(context, other_names);
+        };
+
+        // Fills the cache to its limit of eight keymaps.
+        std::vector<std::shared_ptr<input::xkb::keymap>> others;
+        for (auto layout : {"us", "fr", "gb", "it", "es", "se", "pl"}) {
+            others.push_back(get_layout(layout));
+            REQUIRE(others.back());
+        }
+
+        // The first keymap is used again, so the keymap for "us" is the oldest one now.
+        REQUIRE(cache.get(context, names) == first);
+
+        // Adding another keymap only evicts the oldest one.
+        REQUIRE(get_layout("fi"));
+        REQUIRE(cache.get(context, names) == first);
+        REQUIRE(get_layout("fr") == others.at(1));
+        REQUIRE(get_layout("us") != others.at(0));
+    }
+
+    xkb_context_unref(context);
+}
+
+TEST_CASE("xkb keymap cache benchmark", "[input],[unit],[.benchmark]")
+{
+    auto context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+    REQUIRE(context);
+
+    QTemporaryDir cache_dir;
+    REQUIRE(cache_dir.isValid());
+
+    xkb_rule_names const names = {.rules = "evdev",
+                                  .model = "pc104",
+                                  .layout = "us,de",
+                                  .variant = ",nodeadkeys",
+                                  .options = "grp:alt_shift_toggle"};
+
+    input::xkb::keymap_cache cache;
+
+    BENCHMARK("compile keymap")
+    {
+        cache.set_directory({});
+        cache.clear();
+        return cache.get(context, names);
+    };
+
+    BENCHMARK("load cached keymap")
+    {
+        cache.set_directory(cache_dir.path());
+        cache.clear();
+        return cache.get(context, names);
+    };
+
+    xkb_context_unref(context);
+}
+
+}